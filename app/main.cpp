@@ -1,10 +1,12 @@
 #include "mainwindow.h"
+#include "device_library.h"
 
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    DeviceLibrary::instance().load();   // raz, przed oknem (menu Wstaw > Katalog)
     MainWindow w;
     w.show();
     return a.exec();
@@ -2,6 +2,13 @@
 #include "wire_editor.h"
 #include "propagation.h"
 #include "contactor_LC1D09_LADC22.h"
+#include "device_library.h"
+#include "device_template.h"
+#include "project_file.h"
+#include "project_import.h"
+#include "netlist_export.h"
+#include "power_block.h"
+#include "motor_3phase_block.h"
 
 #include <QStatusBar>
 #include <QGridLayout>
@@ -9,6 +16,20 @@
 #include <QQueue>
 #include <QMenuBar>
 #include <QMenu>
+#include <QInputDialog>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QElapsedTimer>
+#include <QProgressBar>
+#include <QAction>
+#include <QActionGroup>
+#include <QStandardPaths>
+#include <QToolBar>
+#include <QSlider>
+#include <QLabel>
+#include <QDockWidget>
+#include <QListWidget>
+#include <algorithm>
 #include <utility>
 
 
@@ -16,20 +37,34 @@
 // ===================== Konstruktor =====================
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
+    , m_sim([this] { QMetaObject::invokeMethod(this, [this] { onSimResult(); }, Qt::QueuedConnection); })
+    , m_drc([this] { QMetaObject::invokeMethod(this, [this] { onDrcResult(); }, Qt::QueuedConnection); })
+    , m_autosave(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                 + QStringLiteral("/autosave"))
 {
     buildUi();
 
     // Edytor mostków
     auto* wireEdit = new WireEditor(m_view, this);
     connect(wireEdit, &WireEditor::wireCommitted, this,
-            [this](const QString& aPin, const QString& bPin, const QVector<QPointF>&){
-                addWire(aPin, bPin, []{ return true; });
+            [this](const QString& aPin, const QString& bPin, const QVector<QPointF>& pts){
+                UndoJournal::Delta d;
+                d.op = UndoJournal::Op::AddWire;
+                d.a = aPin; d.b = bPin; d.points = pts;
+                m_journal.record(std::move(d), tr("mostek %1–%2").arg(aPin, bPin));
+                updateUndoActions();
+                addWire(aPin, bPin);
                 recomputeSignals();
             });
 
     // Usuwanie mostków (PPM na ścieżce)
     connect(m_view, &ContactorView::bridgeDeleteRequested, this,
             [this](const QString& aNode, const QString& bNode, QGraphicsPathItem* item){
+                UndoJournal::Delta d;
+                d.op = UndoJournal::Op::RemoveWire;
+                d.a = aNode; d.b = bNode; d.points = m_view->bridgePoints(aNode, bNode);
+                m_journal.record(std::move(d), tr("usuń mostek %1–%2").arg(aNode, bNode));
+                updateUndoActions();
                 removeWire(aNode, bNode);
                 m_view->removeBridgeItem(item);
                 recomputeSignals();
@@ -37,29 +72,87 @@ MainWindow::MainWindow(QWidget* parent)
 
     // Źródła z PPM i z przycisków
     connect(m_view, &ContactorView::addPhaseSourceRequested, this, [this](const QString& pin){
+        recordSource(pin, false, true);
         setPhaseSource(pin, true);
     });
     connect(m_view, &ContactorView::addNeutralSourceRequested, this, [this](const QString& pin){
+        recordSource(pin, true, true);
         setNeutralSource(pin, true);
     });
     connect(m_view, &ContactorView::removePhaseSourceRequested, this, [this](const QString& pin){
+        recordSource(pin, false, false);
         setPhaseSource(pin, false);
     });
     connect(m_view, &ContactorView::removeNeutralSourceRequested, this, [this](const QString& pin){
+        recordSource(pin, true, false);
         setNeutralSource(pin, false);
     });
+    connect(m_view, &ContactorView::feedQueryRequested, this, &MainWindow::showFeeds);
+    connect(m_view, &ContactorView::netHighlightRequested, this, &MainWindow::highlightNet);
 
     // Wstawienie i usuwanie: styczniki
     connect(m_view, &ContactorView::contactorPlaced,           this, &MainWindow::onContactorPlaced);
+    connect(m_view, &ContactorView::contactorsPlaced,          this, &MainWindow::onContactorsPlaced);
     connect(m_view, &ContactorView::contactorDeleteRequested,  this, &MainWindow::onContactorDelete);
 
     // NOWE: Wstawienie i usuwanie: zasilanie 3F
     connect(m_view, &ContactorView::powerPlaced,               this, &MainWindow::onPowerPlaced);
+    connect(m_view, &ContactorView::powersPlaced,              this, &MainWindow::onPowersPlaced);
     connect(m_view, &ContactorView::powerDeleteRequested,      this, &MainWindow::onPowerDelete);
 
+    // Wstawienie i usuwanie: silniki 3F
+    connect(m_view, &ContactorView::motorPlaced,               this, &MainWindow::onMotorPlaced);
+    connect(m_view, &ContactorView::motorsPlaced,              this, &MainWindow::onMotorsPlaced);
+    connect(m_view, &ContactorView::motorDeleteRequested,      this, &MainWindow::onMotorDelete);
+    connect(m_view, &ContactorView::motorResetRequested,       this, &MainWindow::onMotorReset);
+    connect(m_view, &ContactorView::motorLoadRequested,        this, &MainWindow::onMotorLoad);
+
+    // Autotrasowanie — postęp na pasku stanu
+    connect(m_view, &ContactorView::bridgesRouted, this, [this](int count, int fallbacks){
+        statusBar()->showMessage(tr("Trasowanie: +%1 mostków (awaryjnych: %2), w kolejce: %3")
+                                     .arg(count).arg(fallbacks).arg(m_view->pendingRoutes()));
+    });
+    connect(m_view, &ContactorView::autoRouteFinished, this, [this]{
+        statusBar()->showMessage(tr("Trasowanie zakończone"));
+    });
+
+    // Wczytywanie projektu: porcje grafiki w pętli zdarzeń
+    m_importTimer.setInterval(0);
+    connect(&m_importTimer, &QTimer::timeout, this, &MainWindow::importStep);
+
+    // Autozapis: każdy nowy wpis historii trafia do dziennika
+    m_journal.setListener([this](const UndoJournal::Entry& e){ m_autosave.append(e); });
+    m_autosaveTimer.setInterval(AUTOSAVE_FLUSH_MS);
+    connect(&m_autosaveTimer, &QTimer::timeout, this, &MainWindow::autosaveTick);
+    m_autosaveTimer.start();
+
+    // Model cieplny silników (przekaźniki F)
+    m_thermalTimer.setInterval(THERMAL_TICK_MS);
+    connect(&m_thermalTimer, &QTimer::timeout, this, &MainWindow::thermalTick);
+    m_thermalTimer.start();
+
     // Start — pusto
     recomputeSignals();
-    statusBar()->showMessage(tr("Gotowy"));
+    const QStringList libErrors = DeviceLibrary::instance().errors();
+    if (libErrors.isEmpty()) statusBar()->showMessage(tr("Gotowy"));
+    else statusBar()->showMessage(tr("Katalog urządzeń: %1 błędnych opisów (%2)")
+                                      .arg(libErrors.size()).arg(libErrors.first()));
+
+    // Sesja przerwanego programu (nie innej działającej instancji) — propozycja odtworzenia, gdy okno już działa
+    if (!m_autosave.claimRecovery().isEmpty()) QTimer::singleShot(0, this, &MainWindow::offerRecovery);
+    else                                       autosaveCheckpoint();
+}
+
+MainWindow::~MainWindow() {
+    m_sim.stop();                    // przed zniszczeniem okna — worker woła onSimResult przez kolejkę
+    m_drc.stop();
+    m_autosaveTimer.stop();
+    m_thermalTimer.stop();
+    m_autosave.discard();            // czyste zamknięcie — nic do odtwarzania
+    cancelImport();
+    m_exploreLatest.store(++m_exploreGen, std::memory_order_relaxed);   // przerywa przeszukiwanie stanów
+    m_ioPool.clear();
+    m_ioPool.waitForDone();
 }
 
 // ===================== UI =====================
@@ -73,27 +166,89 @@ void MainWindow::buildUi() {
     // Menu
     auto* menuBar = new QMenuBar(this);
     auto* menuPlik = new QMenu(tr("Plik"), menuBar);
+    auto* menuEdycja = new QMenu(tr("Edycja"), menuBar);
     auto* menuWstaw = new QMenu(tr("Wstaw"), menuBar);
+    auto* menuSymulacja = new QMenu(tr("Symulacja"), menuBar);
 
     menuPlik->addAction(tr("Nowy schemat"), this, [this]{
-        if (m_view && m_view->scene()) {
-            m_view->scene()->clear();
-            m_auxNodes.clear();
-            m_nodeToView.clear();
-            m_phaseSources.clear();
-            m_neutralSources.clear();
-            m_phaseHot.clear();
-            m_neutralHot.clear();
-            m_edges.clear();
-            m_contactors.clear();
-            m_contEnergized.clear();
-            m_powers.clear();
+        if (m_view) {
+            resetSchematic();
+            m_projectPath.clear();
+            m_recovering = false;
+            autosaveCheckpoint();
             statusBar()->showMessage(tr("Nowy schemat"));
         }
     });
+    menuPlik->addAction(tr("Otwórz…"), this, &MainWindow::openProject, QKeySequence::Open);
+    menuPlik->addAction(tr("Zapisz"), this, [this]{
+        if (m_projectPath.isEmpty()) saveProjectAs();
+        else saveProject(m_projectPath);
+    }, QKeySequence::Save);
+    menuPlik->addAction(tr("Zapisz jako…"), this, &MainWindow::saveProjectAs, QKeySequence::SaveAs);
+    menuPlik->addAction(tr("Eksportuj netlistę…"), this, &MainWindow::exportNetlist);
     menuPlik->addSeparator();
     menuPlik->addAction(tr("Zamknij"), this, &QWidget::close);
 
+    // --- EDYCJA ---
+    m_undoAct = menuEdycja->addAction(tr("Cofnij"), this, &MainWindow::undo, QKeySequence::Undo);
+    m_redoAct = menuEdycja->addAction(tr("Ponów"), this, &MainWindow::redo, QKeySequence::Redo);
+    menuEdycja->addSeparator();
+    menuEdycja->addAction(tr("Głębokość historii…"), this, [this]{
+        bool ok = false;
+        const int depth = QInputDialog::getInt(this, tr("Historia zmian"), tr("Liczba kroków cofania:"),
+                                               m_journal.depth(), 1, 10000, 1, &ok);
+        if (!ok) return;
+        m_journal.setDepth(depth);
+        updateUndoActions();
+    });
+    updateUndoActions();
+
+    // --- SYMULACJA ---
+    auto* traceAct = menuSymulacja->addAction(tr("Rejestruj przebiegi"));
+    traceAct->setCheckable(true);
+    connect(traceAct, &QAction::toggled, this, &MainWindow::startTrace);
+    menuSymulacja->addAction(tr("Eksportuj przebiegi (VCD)…"), this, &MainWindow::exportTraceVcd);
+    menuSymulacja->addAction(tr("Przeglądaj zapis…"), this, &MainWindow::openReplay);
+    menuSymulacja->addSeparator();
+    auto* acAct = menuSymulacja->addAction(tr("Analiza AC (napięcia i prądy)"));
+    acAct->setCheckable(true);
+    connect(acAct, &QAction::toggled, this, [this](bool on){
+        m_acOn = on;
+        if (!m_acLabel) {
+            m_acLabel = new QLabel(this);
+            statusBar()->addPermanentWidget(m_acLabel);
+        }
+        m_acLabel->setVisible(on);
+        if (on) runAcAnalysis();
+    });
+    menuSymulacja->addAction(tr("Wyniki analizy AC…"), this, &MainWindow::showAcResults);
+    auto* menuTempo = menuSymulacja->addMenu(tr("Tempo modelu cieplnego"));
+    auto* tempoGroup = new QActionGroup(menuTempo);
+    for (int speed : { 1, 10, 100, 1000 }) {
+        auto* a = menuTempo->addAction(tr("×%1").arg(speed), this, [this, speed]{ m_simSpeed = speed; });
+        a->setCheckable(true);
+        a->setChecked(speed == m_simSpeed);
+        tempoGroup->addAction(a);
+    }
+
+    // --- KONTROLA PROJEKTU (DRC) ---
+    m_drcList = new QListWidget(this);
+    m_drcDock = new QDockWidget(tr("Kontrola projektu"), this);
+    m_drcDock->setObjectName(QStringLiteral("drcDock"));
+    m_drcDock->setWidget(m_drcList);
+    addDockWidget(Qt::RightDockWidgetArea, m_drcDock);
+    m_drcDock->hide();
+    connect(m_drcDock, &QDockWidget::visibilityChanged, this, [this](bool){ showDrcMarkers(); });
+    connect(m_drcList, &QListWidget::itemDoubleClicked, this, [this](QListWidgetItem* item){
+        const QStringList pins = item->data(Qt::UserRole).toStringList();
+        if (m_view && !pins.isEmpty()) m_view->centerOn(m_view->terminalPos(pins.first()));
+    });
+    QAction* drcAct = m_drcDock->toggleViewAction();
+    drcAct->setText(tr("Kontrola projektu (DRC)"));
+    menuSymulacja->addSeparator();
+    menuSymulacja->addAction(drcAct);
+    menuSymulacja->addAction(tr("Sprawdź blokady styczników…"), this, &MainWindow::checkInterlocks);
+
     // --- WSTAW ---
     menuWstaw->addAction(tr("Stycznik (Kx)"), this, [this]{
         if (m_view) m_view->beginPlaceContactor();
@@ -104,9 +259,34 @@ void MainWindow::buildUi() {
     menuWstaw->addAction(tr("Silnik 3F (Mx)"), this, [this]{        // NOWE
         if (m_view) m_view->beginPlaceMotor3();
     });
+    // Typy z katalogu (DeviceLibrary) — opis w danych, ten sam blok stycznika
+    const auto& catalog = DeviceLibrary::instance().types();
+    if (!catalog.isEmpty()) {
+        auto* menuKatalog = menuWstaw->addMenu(tr("Katalog"));
+        for (const DeviceType* t : catalog) {
+            const QString id = t->id;
+            menuKatalog->addAction(tr("%1 (%2x)").arg(t->title, t->prefix), this, [this, id]{
+                if (m_view) m_view->beginPlaceCatalog(id);
+            });
+        }
+    }
+    menuWstaw->addSeparator();
+    menuWstaw->addAction(tr("Tablica styczników…"), this, [this]{
+        beginPlaceArray(ContactorView::DeviceKind::Contactor);
+    });
+    menuWstaw->addAction(tr("Tablica zasilań 3F…"), this, [this]{
+        beginPlaceArray(ContactorView::DeviceKind::Power3);
+    });
+    menuWstaw->addAction(tr("Tablica silników 3F…"), this, [this]{
+        beginPlaceArray(ContactorView::DeviceKind::Motor3);
+    });
+    menuWstaw->addSeparator();
+    menuWstaw->addAction(tr("Trasuj brakujące mostki"), this, &MainWindow::routeMissingBridges);
 
     menuBar->addMenu(menuPlik);
+    menuBar->addMenu(menuEdycja);
     menuBar->addMenu(menuWstaw);
+    menuBar->addMenu(menuSymulacja);
     setMenuBar(menuBar);
 
     setCentralWidget(central);
@@ -114,12 +294,368 @@ void MainWindow::buildUi() {
     resize(1200, 800);
 }
 
+void MainWindow::beginPlaceArray(ContactorView::DeviceKind kind) {
+    if (!m_view) return;
+    bool ok = false;
+    const int rows = QInputDialog::getInt(this, tr("Tablica urządzeń"), tr("Wiersze:"), 2, 1, 64, 1, &ok);
+    if (!ok) return;
+    const int cols = QInputDialog::getInt(this, tr("Tablica urządzeń"), tr("Kolumny:"), 4, 1, 64, 1, &ok);
+    if (!ok) return;
+    m_view->beginPlaceArray(kind, rows, cols);
+}
+
+void MainWindow::routeMissingBridges() {
+    if (!m_view) return;
+    // Mostki to krawędzie bez właściciela; każda jest zapisana w obie strony
+    QVector<QPair<QString, QString>> pairs;
+    for (const Edge& e : m_edges.edges()) {
+        if (!e.owner.isEmpty() || !(e.a < e.b)) continue;
+        if (!m_view->hasBridge(e.a, e.b)) pairs.push_back(qMakePair(e.a, e.b));
+    }
+    if (pairs.isEmpty()) {
+        statusBar()->showMessage(tr("Wszystkie połączenia mają mostki"));
+        return;
+    }
+    statusBar()->showMessage(tr("Trasowanie %1 połączeń…").arg(pairs.size()));
+    m_view->autoRoute(pairs);
+}
+
+// ===================== PROJEKT =====================
+void MainWindow::resetSchematic() {
+    cancelImport();
+    if (m_timeline) closeReplay();
+    if (m_view) m_view->clearSchematic();
+    m_auxNodes.clear();
+    m_nodeToView.clear();
+    m_phaseSources.clear();
+    m_neutralSources.clear();
+    m_phaseHot.clear();
+    m_neutralHot.clear();
+    m_traceResync = true;           // lista zmian workera odnosi się do stanu sprzed wyczyszczenia
+    m_interPhase.clear();
+    m_phaseMask.clear();
+    m_sources.clear();
+    m_edges.clear();
+    m_nets.clear();
+    m_netPin.clear();
+    m_devicePins.clear();
+    m_contactors.clear();
+    m_templates.clear();
+    m_unknownDevices.clear();
+    m_powers.clear();
+    m_motors.clear();
+    SimWorker::Op clear;
+    clear.kind = SimWorker::Op::Kind::Clear;
+    m_sim.post(std::move(clear));
+    DrcWorker::Op drcClear;
+    drcClear.kind = DrcWorker::Op::Kind::Clear;
+    m_drc.post(std::move(drcClear));
+    m_drcPins.clear();
+    m_simValidFrom = m_sim.generation() + 1;
+    m_thermalWait = 0;
+    m_thermalLag = 0.0;
+    m_journal.clear();
+    updateUndoActions();
+}
+
+void MainWindow::openProject() {
+    const QString path = QFileDialog::getOpenFileName(this, tr("Otwórz projekt"), QString(),
+                                                      tr("Projekt ControlNet (*.cnp)"));
+    if (!path.isEmpty()) loadProject(path);
+}
+
+void MainWindow::saveProjectAs() {
+    QString path = QFileDialog::getSaveFileName(this, tr("Zapisz projekt"), m_projectPath,
+                                                tr("Projekt ControlNet (*.cnp)"));
+    if (path.isEmpty()) return;
+    if (!path.endsWith(QLatin1String(".cnp"), Qt::CaseInsensitive)) path += QLatin1String(".cnp");
+    saveProject(path);
+}
+
+static ProjectFile::DeviceKind toFileKind(ContactorView::DeviceKind k) {
+    switch (k) {
+    case ContactorView::DeviceKind::Contactor: return ProjectFile::DeviceKind::Contactor;
+    case ContactorView::DeviceKind::Power3:    return ProjectFile::DeviceKind::Power3;
+    case ContactorView::DeviceKind::Motor3:    return ProjectFile::DeviceKind::Motor3;
+    case ContactorView::DeviceKind::Catalog:   return ProjectFile::DeviceKind::Catalog;
+    }
+    return ProjectFile::DeviceKind::Contactor;
+}
+
+static ContactorView::DeviceKind fromFileKind(ProjectFile::DeviceKind k) {
+    switch (k) {
+    case ProjectFile::DeviceKind::Contactor: return ContactorView::DeviceKind::Contactor;
+    case ProjectFile::DeviceKind::Power3:    return ContactorView::DeviceKind::Power3;
+    case ProjectFile::DeviceKind::Motor3:    return ContactorView::DeviceKind::Motor3;
+    case ProjectFile::DeviceKind::Catalog:   return ContactorView::DeviceKind::Catalog;
+    }
+    return ContactorView::DeviceKind::Contactor;
+}
+
+ProjectFile::Data MainWindow::projectData() const {
+    ProjectFile::Data data;
+    if (!m_view) return data;
+
+    const auto placed = m_view->placedDevices();
+    data.devices.reserve(placed.size());
+    for (const auto& d : placed)
+        data.devices.push_back({ toFileKind(d.kind), d.index, d.topLeft, d.type });
+    data.devices += m_unknownDevices;       // bez szablonu nie ma ich na scenie, ale z pliku nie znikają
+
+    // Mostki = krawędzie bez właściciela (zapisane w obie strony — bierzemy a < b)
+    for (const Edge& e : m_edges.edges()) {
+        if (!e.owner.isEmpty() || !(e.a < e.b)) continue;
+        data.wires.push_back({ e.a, e.b, m_view->bridgePoints(e.a, e.b) });
+    }
+    for (const QString& p : std::as_const(m_phaseSources))   data.sources.push_back({ p, false });
+    for (const QString& p : std::as_const(m_neutralSources)) data.sources.push_back({ p, true });
+    data.view = { m_view->zoom(), m_view->viewCenter() };
+    return data;
+}
+
+bool MainWindow::saveProject(const QString& path) {
+    if (!m_view) return false;
+
+    // Wczytywanie w toku — scena musi być kompletna, zanim zostanie zapisana
+    while (m_import) importStep();
+
+    const ProjectFile::Data data = projectData();
+    QString error;
+    if (!ProjectFile::save(path, data, &error)) {
+        QMessageBox::warning(this, tr("Zapis projektu"), tr("Nie udało się zapisać %1:\n%2").arg(path, error));
+        return false;
+    }
+    m_projectPath = path;
+    statusBar()->showMessage(tr("Zapisano %1 (%2 urządzeń, %3 połączeń)")
+                                 .arg(path).arg(data.devices.size()).arg(data.wires.size()));
+    return true;
+}
+
+// Netlista z grafu logicznego — niezależna od tego, ile grafiki już powstało
+void MainWindow::exportNetlist() {
+    QString filter;
+    const QString path = QFileDialog::getSaveFileName(this, tr("Eksportuj netlistę"), QString(),
+                                                      tr("Netlista SPICE (*.cir);;CSV (*.csv)"), &filter);
+    if (path.isEmpty()) return;
+
+    QElapsedTimer timer;
+    timer.start();
+    const NetlistExport::Input in{ m_edges, m_devicePins, m_phaseSources, m_neutralSources, m_templates };
+    NetlistExport::Stats stats;
+    QString error;
+    if (!NetlistExport::write(path, NetlistExport::formatFor(path), in, &stats, &error)) {
+        QMessageBox::warning(this, tr("Eksport netlisty"), tr("Nie udało się zapisać %1:\n%2").arg(path, error));
+        return;
+    }
+    statusBar()->showMessage(tr("Netlista %1: %2 netów, %3 pinów, %4 styków w %5 ms")
+                                 .arg(path).arg(stats.nets).arg(stats.pins).arg(stats.contacts)
+                                 .arg(timer.elapsed()));
+}
+
+// Wczytywanie w trzech etapach, bez blokowania okna:
+//  1) wątek roboczy: mapowanie pliku, dekodowanie rekordów, graf logiczny,
+//  2) wątek GUI, jednorazowo: przejęcie grafu i przeliczenie — symulacja działa od razu,
+//  3) wątek GUI, porcjami po IMPORT_SLICE_MS: urządzenia i mostki na scenie.
+bool MainWindow::loadProject(const QString& path) {
+    if (!m_view) return false;
+
+    resetSchematic();
+    m_recovering = false;
+    m_pendingReplay.clear();
+    m_importClock.start();
+    const quint64 gen = ++m_importGen;
+
+    // Szablony budowane leniwie — muszą powstać w wątku GUI, zanim sięgnie po nie wątek roboczy
+    Contactor_LC1D09_LADC22::deviceTemplate();
+    PowerBlock::deviceTemplate();
+    Motor3PhaseBlock::deviceTemplate();
+
+    if (!m_importProgress) {
+        m_importProgress = new QProgressBar(this);
+        m_importProgress->setMaximumWidth(200);
+        m_importProgress->setTextVisible(false);
+        statusBar()->addPermanentWidget(m_importProgress);
+    }
+    m_importProgress->setRange(0, 0);              // parsowanie: postęp nieokreślony
+    m_importProgress->show();
+    statusBar()->showMessage(tr("Wczytywanie %1…").arg(path));
+
+    const ContactCondFactory  cond     = [this](int id, bool isNO) { return contactCond(id, isNO); };
+    const OverloadCondFactory overload = [this](int id) { return overloadCond(id); };
+    m_ioPool.start([this, gen, path, cond, overload] {
+        auto project = std::make_shared<ImportedProject>(importProject(path, cond, overload));
+        QMetaObject::invokeMethod(this, [this, gen, path, project] {
+            onProjectParsed(gen, path, project);
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
+
+void MainWindow::onProjectParsed(quint64 generation, const QString& path, std::shared_ptr<ImportedProject> project) {
+    if (generation != m_importGen || !m_view) return;   // anulowane albo nowsze wczytanie
+
+    if (!project->error.isEmpty()) {
+        if (m_importProgress) m_importProgress->hide();
+        QMessageBox::warning(this, tr("Otwieranie projektu"),
+                             tr("Nie udało się otworzyć %1:\n%2").arg(path, project->error));
+        statusBar()->showMessage(tr("Gotowy"));
+        m_recovering = false;
+        autosaveCheckpoint();      // scena wyczyszczona przez loadProject
+        return;
+    }
+
+    // Scena mogła zostać zmieniona w trakcie parsowania — projekt zastępuje wszystko
+    resetSchematic();
+    ImportedProject& imp = *project;
+
+    // Punkt kontrolny autozapisu wprost z rekordów pliku (dane współdzielone, bez kopii);
+    // przy odzyskiwaniu stary dziennik zostaje nietknięty aż do końca odtwarzania
+    if (!m_recovering) {
+        m_autosave.checkpoint({ imp.devices, imp.wires, imp.sources, imp.view });
+        m_sinceCheckpoint.restart();
+    }
+
+    // 2) Graf logiczny gotowy: przejęcie bez kopiowania
+    m_edges      = std::move(imp.edges);
+    m_nets       = std::move(imp.nets);
+    m_devicePins = std::move(imp.devicePins);
+    m_contactors = std::move(imp.contactors);
+    m_powers     = std::move(imp.powers);
+    m_motors     = std::move(imp.motors);
+    m_templates  = std::move(imp.templates);
+    m_unknownDevices = std::move(imp.unknownDevices);
+    m_auxNodes   = std::move(imp.nodes);
+    m_nodeToView.reserve(m_auxNodes.size());
+    for (const QString& n : std::as_const(m_auxNodes)) m_nodeToView.insert(n, n);
+
+    // Ten sam model dla wątku symulacji: urządzenia, mostki (a < b), źródła
+    for (int id = 0; id < m_contactors.size(); ++id)
+        if (!m_contactors.prefix(id).isEmpty()) m_sim.post(deviceOp(m_contactors.prefix(id)));
+    for (int id = 0; id < m_motors.size(); ++id)
+        if (m_motors.isValid(id)) m_sim.post(deviceOp(m_motors.prefix(id)));
+    for (auto it = m_devicePins.constBegin(); it != m_devicePins.constEnd(); ++it)
+        m_drc.post(drcDeviceOp(it.key()));
+    for (const Edge& e : m_edges.edges()) {
+        if (!e.owner.isEmpty() || !(e.a < e.b)) continue;
+        SimWorker::Op op;
+        op.kind = SimWorker::Op::Kind::AddWire;
+        op.a = e.a; op.b = e.b;
+        m_sim.post(std::move(op));
+        DrcWorker::Op drc;
+        drc.kind = DrcWorker::Op::Kind::AddWire;
+        drc.a = e.a; drc.b = e.b;
+        m_drc.post(std::move(drc));
+    }
+    for (const ProjectFile::Source& src : std::as_const(imp.sources)) {
+        if (src.neutral) m_neutralSources.insert(src.pin);
+        else             m_phaseSources.insert(src.pin);
+        postSource(src.pin, src.neutral, true);
+    }
+    recomputeSignals();
+
+    // Numery urządzeń zajęte od razu — nowe urządzenia użytkownika ich nie dublują
+    for (const ProjectFile::Device& d : std::as_const(imp.devices))
+        m_view->reserveDeviceIndex(fromFileKind(d.kind), d.index, d.type);
+    m_view->setViewState(imp.view.scale, imp.view.center);
+    m_projectPath = path;
+
+    // 3) Grafika porcjami (ostrzeżenie niżej otwiera pętlę zdarzeń — imp może już nie żyć)
+    const QStringList unknownTypes = imp.unknownTypes;
+    m_import = std::move(project);
+    m_importDevice = 0;
+    m_importWire = 0;
+    m_importUnrouted.clear();
+    if (m_importProgress) {
+        m_importProgress->setRange(0, imp.devices.size() + imp.wires.size());
+        m_importProgress->show();
+    }
+    m_importTimer.start();
+
+    if (!unknownTypes.isEmpty())
+        QMessageBox::warning(this, tr("Otwieranie projektu"),
+                             tr("Typy urządzeń spoza katalogu — urządzenia nie są wyświetlane, "
+                                "ale zapis projektu zachowa je bez zmian:\n%1")
+                                 .arg(unknownTypes.join(QStringLiteral(", "))));
+}
+
+void MainWindow::importStep() {
+    if (!m_import || !m_view) { m_importTimer.stop(); return; }
+    const ImportedProject& imp = *m_import;
+
+    QElapsedTimer slice;
+    slice.start();
+
+    QStringList newPins;
+    QStringList newMotors;
+
+    // Jedna transakcja widoku na porcję; rejestracja w logice już była
+    // (contactorsPlaced/powersPlaced trafią na istniejące wpisy i nic nie przeliczą)
+    m_view->beginBulk();
+    while (m_importDevice < imp.devices.size() && slice.elapsed() < IMPORT_SLICE_MS) {
+        const ProjectFile::Device& d = imp.devices[m_importDevice++];
+        const QString prefix = m_view->placeDeviceAt(fromFileKind(d.kind), d.index, d.topLeft, d.type);
+        if (prefix.isEmpty()) continue;
+        if (d.kind == ProjectFile::DeviceKind::Motor3) newMotors << prefix;
+        else                                           newPins += m_devicePins.value(prefix);
+    }
+    while (m_importDevice == imp.devices.size() && m_importWire < imp.wires.size()
+           && slice.elapsed() < IMPORT_SLICE_MS) {
+        const ProjectFile::Wire& w = imp.wires[m_importWire++];
+        if (w.points.size() < 2) { m_importUnrouted.push_back(qMakePair(w.a, w.b)); continue; }
+        if (auto* item = m_view->addBridgePolyline(w.points)) m_view->registerBridge(item, w.a, w.b);
+    }
+    m_view->endBulk();
+
+    // Nowe zaciski dostają stan z przeliczenia wykonanego na całym grafie
+    paintPins(newPins);
+    for (const QString& M : std::as_const(newMotors)) pushMotorMasks(M);
+
+    if (m_importProgress) m_importProgress->setValue(m_importDevice + m_importWire);
+    if (m_importDevice == imp.devices.size() && m_importWire == imp.wires.size())
+        finishImport();
+}
+
+void MainWindow::finishImport() {
+    m_importTimer.stop();
+    if (m_importProgress) m_importProgress->hide();
+    if (!m_import || !m_view) { m_import.reset(); return; }
+
+    const int devices = m_import->devices.size();
+    const int wires = m_import->wires.size();
+    m_import.reset();
+
+    m_view->syncSourceButtons(m_phaseSources, m_neutralSources);
+    showDrcMarkers();                      // piny z błędami mają już grafikę
+    if (!m_importUnrouted.isEmpty()) m_view->autoRoute(std::exchange(m_importUnrouted, {}));
+
+    if (m_recovering) {
+        // Odzyskiwanie: dziennik na punkt kontrolny, potem nowa sesja autozapisu
+        const QVector<UndoJournal::Entry> entries = std::exchange(m_pendingReplay, {});
+        applyEntries(entries, true);
+        m_recovering = false;
+        m_projectPath.clear();
+        autosaveCheckpoint();
+        statusBar()->showMessage(tr("Odtworzono schemat z autozapisu: %1 urządzeń, %2 połączeń, %3 operacji w %4 ms")
+                                     .arg(devices).arg(wires).arg(entries.size()).arg(m_importClock.elapsed()));
+        return;
+    }
+
+    statusBar()->showMessage(tr("Wczytano %1: %2 urządzeń, %3 połączeń w %4 ms")
+                                 .arg(m_projectPath).arg(devices).arg(wires).arg(m_importClock.elapsed()));
+}
+
+// Wyniki zadań w tle z poprzednich generacji są odrzucane w onProjectParsed
+void MainWindow::cancelImport() {
+    ++m_importGen;
+    m_importTimer.stop();
+    m_import.reset();
+    m_importUnrouted.clear();
+    if (m_importProgress) m_importProgress->hide();
+}
+
 // ===================== Sloty (placeholdery – brak paneli) =====================
 void MainWindow::setLampState(class QLabel*, bool, const QString&, const QString&) {}
 void MainWindow::updateCoilLamp(bool) {}
-void MainWindow::updateMainContacts(ContactorModel::ContactState) {}
-void MainWindow::updateAuxNO(ContactorModel::ContactState) {}
-void MainWindow::updateAuxNC(ContactorModel::ContactState) {}
 void MainWindow::refreshUpperFeed() {}
 void MainWindow::addLink(const QString&, const QString&, std::function<bool()>) {}
 void MainWindow::applyLinks() {}
@@ -129,111 +665,269 @@ std::function<void(bool)> MainWindow::resolveCoilSetter(const QString&) { return
 
 // ===================== LOGIKA: stycznik i krawędzie kontaktów =====================
 void MainWindow::onContactorPlaced(const QString& K) {
+    if (!registerContactor(K)) return;
+    recordPlaced({ K });
+    recomputeSignals();
+}
+
+void MainWindow::onContactorsPlaced(const QStringList& Ks) {
+    QStringList added;
+    for (const QString& K : Ks)
+        if (registerContactor(K)) added << K;
+    if (added.isEmpty()) return;
+    recordPlaced(added);
+    recomputeSignals();
+}
+
+bool MainWindow::registerContactor(const QString& K) {
     if (!m_view)
-        return;
+        return false;
     if (m_contactors.contains(K))
-        return;
+        return false;
 
     auto* block = m_view->contactorBlock(K);
     if (!block)
-        return;
+        return false;
 
-    m_contactors.insert(K);
-    m_contEnergized.insert(K, false);
+    // Cewka i rodzaje styków z szablonu typu (wbudowanego albo z katalogu)
+    const DeviceTemplate& tpl = block->typeTemplate();
+    m_templates.insert(K, &tpl);
+    const int id = tpl.coilA >= 0
+                 ? m_contactors.add(K, K + tpl.pins[tpl.coilA].suffix, K + tpl.pins[tpl.coilB].suffix)
+                 : m_contactors.add(K);
 
     for (const auto& edge : block->contactEdges()) {
         const bool isNO = (edge.kind == Contactor_LC1D09_LADC22::ContactKind::NormallyOpen);
-        addContactEdgeDyn(K, edge.pinA, edge.pinB, isNO);
+        addContactEdgeDyn(K, id, edge.pinA, edge.pinB, isNO);
     }
+    m_sim.post(deviceOp(K));
 
+    QStringList& owned = m_devicePins[K];
     for (const QString& pin : block->pins()) {
+        owned << pin;
         m_auxNodes.insert(pin);
         m_nodeToView.insert(pin, pin);
     }
-
-    recomputeSignals();
+    m_drc.post(drcDeviceOp(K));
+    return true;
 }
 
-void MainWindow::addContactEdgeDyn(const QString& K, const QString& a, const QString& b, bool isNO) {
-    auto cond = [this, K, isNO]() -> bool {
-        const bool en = m_contEnergized.value(K, false);
+// Numer w banku jest stały do usunięcia stycznika, a krawędzie znikają razem z nim
+std::function<bool()> MainWindow::contactCond(int id, bool isNO) const {
+    return [this, id, isNO]() -> bool {
+        const bool en = m_contactors.isEnergized(id);
         return isNO ? en : !en;
     };
-    addWire(a, b, cond);
+}
+
+void MainWindow::addContactEdgeDyn(const QString& K, int id, const QString& a, const QString& b, bool isNO) {
+    m_edges.addPair(a, b, contactCond(id, isNO), K);
+    m_auxNodes.insert(a); m_auxNodes.insert(b);
+    m_nodeToView.insert(a, a);
+    m_nodeToView.insert(b, b);
 }
 
 // NOWE: zasilanie 3F — rejestracja pinów
 void MainWindow::onPowerPlaced(const QString& P) {
-    if (m_powers.contains(P)) return;
+    if (!registerPower(P)) return;
+    recordPlaced({ P });
+    recomputeSignals();
+}
+
+void MainWindow::onPowersPlaced(const QStringList& Ps) {
+    QStringList added;
+    for (const QString& P : Ps)
+        if (registerPower(P)) added << P;
+    if (added.isEmpty()) return;
+    recordPlaced(added);
+    recomputeSignals();
+}
+
+bool MainWindow::registerPower(const QString& P) {
+    if (m_powers.contains(P)) return false;
     m_powers.insert(P);
 
+    QStringList& owned = m_devicePins[P];
     for (const char* p : {"L1","L2","L3"}) {
         const QString node = P + p;
+        owned << node;
         m_auxNodes.insert(node);
         m_nodeToView.insert(node, node);
     }
-    recomputeSignals();
+    m_drc.post(drcDeviceOp(P));
+    return true;
 }
 
-// NOWE: kasowanie zasilania 3F
-void MainWindow::onPowerDelete(const QString& P) {
-    if (!m_powers.contains(P)) return;
+// Silniki 3F — piny w rejestrze własności (mostki, maski faz)
+void MainWindow::onMotorPlaced(const QString& M) {
+    if (!registerMotor(M)) return;
+    recordPlaced({ M });
+    pushMotorMasks(M);
+}
+
+void MainWindow::onMotorsPlaced(const QStringList& Ms) {
+    QStringList added;
+    for (const QString& M : Ms)
+        if (registerMotor(M)) added << M;
+    if (added.isEmpty()) return;
+    recordPlaced(added);
+    for (const QString& M : std::as_const(added)) pushMotorMasks(M);
+}
 
-    // 1) Usuń krawędzie związane z tym prefiksem (jeśli jakieś mostki logiczne by istniały)
-    for (int i = m_edges.size() - 1; i >= 0; --i) {
-        const Edge& e = m_edges[i];
-        if (e.a.startsWith(P) || e.b.startsWith(P))
-            m_edges.remove(i);
+bool MainWindow::registerMotor(const QString& M) {
+    if (!m_view || m_motors.contains(M)) return false;
+    auto* block = m_view->motorBlock(M);
+    if (!block) return false;
+    const int id = m_motors.add(M);
+
+    QStringList& owned = m_devicePins[M];
+    for (const auto& term : block->terminals()) {
+        owned << term.name;
+        m_auxNodes.insert(term.name);
+        m_nodeToView.insert(term.name, term.name);
     }
 
-    // 2) Usuń źródła FAZA/ZERO tego P
-    auto filterOutWithPrefix = [&](QSet<QString>& set){
-        for (auto it = set.begin(); it != set.end(); ) {
-            if (it->startsWith(P)) it = set.erase(it);
-            else ++it;
-        }
-    };
-    filterOutWithPrefix(m_phaseSources);
-    filterOutWithPrefix(m_neutralSources);
-    filterOutWithPrefix(m_phaseHot);
-    filterOutWithPrefix(m_neutralHot);
+    // Styk NC 95-96 przekaźnika F — otwiera się po wyzwoleniu termicznym
+    const DeviceTemplate& tpl = Motor3PhaseBlock::deviceTemplate();
+    m_templates.insert(M, &tpl);
+    for (const DeviceTemplate::Contact& c : tpl.contacts)
+        m_edges.addPair(M + tpl.pins[c.pinA].suffix, M + tpl.pins[c.pinB].suffix, overloadCond(id), M);
+    m_sim.post(deviceOp(M));
+    m_drc.post(drcDeviceOp(M));
+    return true;
+}
 
-    // 3) Usuń pomocnicze węzły i mapowania widoku
-    for (auto it = m_auxNodes.begin(); it != m_auxNodes.end(); ) {
-        if (it->startsWith(P)) it = m_auxNodes.erase(it);
-        else ++it;
+// Styki z szablonu typu — te same, z których powstają krawędzie grafu w wątku GUI
+SimWorker::Op MainWindow::deviceOp(const QString& prefix) const {
+    SimWorker::Op op;
+    op.prefix = prefix;
+    if (m_motors.contains(prefix)) {
+        op.kind = SimWorker::Op::Kind::AddMotor;
+    } else {
+        const int id = m_contactors.id(prefix);
+        op.kind = SimWorker::Op::Kind::AddContactor;
+        op.a = m_contactors.coilPinA(id);
+        op.b = m_contactors.coilPinB(id);
     }
-    for (auto it = m_nodeToView.begin(); it != m_nodeToView.end(); ) {
-        if (it.key().startsWith(P)) it = m_nodeToView.erase(it);
-        else ++it;
+    if (const DeviceTemplate* tpl = m_templates.value(prefix)) {
+        for (const DeviceTemplate::Contact& c : tpl->contacts)
+            op.contacts.push_back({ prefix + tpl->pins[c.pinA].suffix, prefix + tpl->pins[c.pinB].suffix,
+                                    c.normallyOpen });
     }
+    return op;
+}
+
+// Piny z rejestru własności; cewka i styki — jak dla wątku symulacji
+DrcWorker::Op MainWindow::drcDeviceOp(const QString& prefix) const {
+    DrcWorker::Op op;
+    op.kind = DrcWorker::Op::Kind::AddDevice;
+    op.prefix = prefix;
+    DrcModel::Device& d = op.device;
+    d.pins = m_devicePins.value(prefix);
+    if (m_powers.contains(prefix)) {
+        d.kind = DrcModel::Kind::Power;
+        return op;
+    }
+    const SimWorker::Op sim = deviceOp(prefix);
+    d.kind = m_motors.contains(prefix) ? DrcModel::Kind::Motor : DrcModel::Kind::Contactor;
+    d.coilA1 = sim.a;
+    d.coilA2 = sim.b;
+    for (const SimWorker::Contact& c : sim.contacts) d.contacts.push_back({ c.a, c.b, c.isNO });
+    return op;
+}
+
+void MainWindow::onMotorDelete(const QString& M) {
+    if (!m_motors.contains(M)) return;
+    recordRemoval(M);
+    removeDevice(M);
+    recomputeSignals();
+    if (auto* sb = statusBar()) sb->showMessage(tr("Usunięto %1").arg(M.left(M.size()-1)));
+}
 
-    // 4) Usuń z rejestru
-    m_powers.remove(P);
+// NOWE: kasowanie zasilania 3F
+void MainWindow::onPowerDelete(const QString& P) {
+    if (!m_powers.contains(P)) return;
 
-    // 5) Usuń grafikę
-    if (m_view) m_view->removePowerBlock(P);
+    // 1) Do historii: urządzenie, jego mostki i źródła
+    recordRemoval(P);
 
-    // 6) Przelicz
+    // 2) Krawędzie, źródła, węzły, rejestr i grafika
+    removeDevice(P);
+
+    // 3) Przelicz
     recomputeSignals();
 
     if (auto* sb = statusBar()) sb->showMessage(tr("Usunięto %1").arg(P.left(P.size()-1)));
 }
 
 // ===================== GRAF POŁĄCZEŃ =====================
-void MainWindow::addWire(const QString& a, const QString& b, std::function<bool()> cond) {
-    if (!cond) cond = []{ return true; };
-    m_edges.push_back(Edge{a, b, cond});
-    m_edges.push_back(Edge{b, a, cond});
+void MainWindow::addWire(const QString& a, const QString& b) {
+    m_edges.addPair(a, b, {});
+    m_nets.addWire(a, b);
+    netChanged();
     m_auxNodes.insert(a); m_auxNodes.insert(b);
     m_nodeToView.insert(a, a);
     m_nodeToView.insert(b, b);
+    SimWorker::Op op;
+    op.kind = SimWorker::Op::Kind::AddWire;
+    op.a = a; op.b = b;
+    m_sim.post(std::move(op));
+    DrcWorker::Op drc;
+    drc.kind = DrcWorker::Op::Kind::AddWire;
+    drc.a = a; drc.b = b;
+    m_drc.post(std::move(drc));
 }
 void MainWindow::removeWire(const QString& a, const QString& b) {
-    for (int i = m_edges.size()-1; i >= 0; --i) {
-        const Edge& e = m_edges[i];
-        if ((e.a == a && e.b == b) || (e.a == b && e.b == a))
-            m_edges.remove(i);
+    m_edges.removeBetween(a, b);
+    m_nets.removeWire(a, b);
+    netChanged();
+    SimWorker::Op op;
+    op.kind = SimWorker::Op::Kind::RemoveWire;
+    op.a = a; op.b = b;
+    m_sim.post(std::move(op));
+    DrcWorker::Op drc;
+    drc.kind = DrcWorker::Op::Kind::RemoveWire;
+    drc.a = a; drc.b = b;
+    m_drc.post(std::move(drc));
+}
+
+// Koszt proporcjonalny do pinów urządzenia i ich krawędzi — bez skanowania całości
+void MainWindow::forgetDevice(const QString& prefix) {
+    m_edges.removeOwner(prefix);
+    const QStringList pins = m_devicePins.take(prefix);
+    for (const QString& pin : pins) {
+        m_edges.removePin(pin);            // mostki dochodzące do pinu
+        m_nets.removePin(pin);
+        m_phaseSources.remove(pin);
+        m_neutralSources.remove(pin);
+        m_phaseHot.remove(pin);
+        m_neutralHot.remove(pin);
+        m_auxNodes.remove(pin);
+        m_nodeToView.remove(pin);
+    }
+    netChanged();
+    SimWorker::Op op;
+    op.kind = SimWorker::Op::Kind::RemoveDevice;
+    op.prefix = prefix;
+    op.pins = pins;
+    m_sim.post(std::move(op));
+    DrcWorker::Op drc;
+    drc.kind = DrcWorker::Op::Kind::RemoveDevice;
+    drc.prefix = prefix;
+    m_drc.post(std::move(drc));
+}
+
+// Krawędzie, źródła i węzły pinów, rejestr urządzenia oraz jego grafika (z mostkami)
+void MainWindow::removeDevice(const QString& prefix) {
+    forgetDevice(prefix);
+    if (m_contactors.remove(prefix)) {
+        m_templates.remove(prefix);
+        if (m_view) m_view->removeContactor(prefix);
+    } else if (m_powers.remove(prefix)) {
+        if (m_view) m_view->removePowerBlock(prefix);
+    } else if (m_motors.remove(prefix)) {
+        m_templates.remove(prefix);
+        if (m_view) m_view->removeMotor(prefix);
     }
 }
 
@@ -243,6 +937,7 @@ void MainWindow::setPhaseSource(const QString& node, bool on) {
     else    m_phaseSources.remove(node);
     m_auxNodes.insert(node);
     m_nodeToView.insert(node, node);
+    postSource(node, false, on);
     recomputeSignals();
 }
 void MainWindow::setNeutralSource(const QString& node, bool on) {
@@ -250,14 +945,38 @@ void MainWindow::setNeutralSource(const QString& node, bool on) {
     else    m_neutralSources.remove(node);
     m_auxNodes.insert(node);
     m_nodeToView.insert(node, node);
+    postSource(node, true, on);
     recomputeSignals();
 }
+void MainWindow::postSource(const QString& node, bool neutral, bool on) {
+    SimWorker::Op op;
+    op.kind = SimWorker::Op::Kind::SetSource;
+    op.a = node; op.neutral = neutral; op.on = on;
+    m_sim.post(std::move(op));
+    DrcWorker::Op drc;
+    drc.kind = DrcWorker::Op::Kind::SetSource;
+    drc.a = node; drc.on = on;
+    m_drc.post(std::move(drc));
+}
 bool MainWindow::isNodePhaseHot(const QString& node) const { return m_phaseHot.contains(node); }
 bool MainWindow::isNodeNeutralHot(const QString& node) const { return m_neutralHot.contains(node); }
 
 
-// ===================== PROPAGACJA z iteracją =====================
+// ===================== PROPAGACJA (wątek symulacji) =====================
+// Samo żądanie: edycje są już w kolejce workera, wynik przyjdzie przez onSimResult
 void MainWindow::recomputeSignals() {
+    if (m_recomputeHold > 0) { m_recomputePending = true; return; }
+    m_recomputePending = false;
+    m_sim.requestRecompute();
+}
+
+// Najnowszy pełny wynik z potrójnego bufora; pośrednie, których nie zdążyliśmy odebrać, przepadają
+void MainWindow::onSimResult() {
+    if (!m_sim.fetch()) return;
+    SimWorker::Result& r = m_sim.result();
+    if (r.generation < m_simValidFrom) return;     // stan sprzed wyczyszczenia schematu
+    m_simShown = r.generation;
+
     auto paintClear = [&](){
         if (!m_view) return;
         for (const QString& nView : std::as_const(m_auxNodes)) {
@@ -267,28 +986,34 @@ void MainWindow::recomputeSignals() {
         }
     };
 
-    // --- iteracja: hot-sets → energizacja styczników → aż do stabilizacji
-    const int MAX_IT = 12;
-    for (int it = 0; it < MAX_IT; ++it) {
-        const HotResult hot = computeHot(m_edges, m_phaseSources, m_neutralSources);
-        m_phaseHot   = hot.phaseHot;
-        m_neutralHot = hot.neutralHot;
-
-        bool changed = false;
-        for (const QString& K : std::as_const(m_contactors)) {
-            const bool en = m_phaseHot.contains(K + "A1") && m_neutralHot.contains(K + "A2");
-            if (m_contEnergized.value(K, false) != en) {
-                m_contEnergized[K] = en;
-                changed = true;
-            }
-        }
-        if (!changed) break;
-        if (it == MAX_IT - 1) break; // bezpiecznik
+    // Ślad: stan poprzedniego wyniku (kopie współdzielone — bez kopiowania danych)
+    const bool tracing = m_trace.isRecording();
+    const quint64 traceT = tracing ? m_trace.now() : 0;
+    const QSet<QString> prevPhase   = m_phaseHot;
+    const QSet<QString> prevNeutral = m_neutralHot;
+
+    // Wynik przejmowany bez kopii (slot i tak zostanie nadpisany przez worker)
+    m_phaseHot   = std::move(r.phaseHot);
+    m_neutralHot = std::move(r.neutralHot);
+    m_interPhase = std::move(r.interPhase);
+    m_phaseMask  = std::move(r.phaseMask);
+    m_sources    = std::move(r.sources);
+
+    // Energizacja w banku GUI (warunki styków grafu GUI: analiza AC, ślad) — zmiany przez evaluate()
+    for (int id = 0; id < m_contactors.size(); ++id) m_contactors.setCoil(id, false, false);
+    for (const QString& K : std::as_const(r.energized)) {
+        const int id = m_contactors.id(K);
+        if (id != ContactorBank::NONE) m_contactors.setCoil(id, true, true);
     }
+    if (m_contactors.evaluate() > 0 && tracing)
+        for (int id : m_contactors.changed())
+            m_trace.record(traceT, m_trace.pinId(m_contactors.prefix(id)),
+                           TraceRecorder::Signal::Energized, m_contactors.isEnergized(id));
 
-    // --- malowanie + zwarcia L/N
-    paintClear();
-    if (m_view) {
+    // --- malowanie + zwarcia L/N (nie podczas przeglądania zapisu)
+    const bool live = !m_timeline;
+    if (live) paintClear();
+    if (m_view && live) {
         QStringList faultPins;
         for (auto it = m_nodeToView.constBegin(); it != m_nodeToView.constEnd(); ++it) {
             const QString& node = it.key();
@@ -307,82 +1032,725 @@ void MainWindow::recomputeSignals() {
         }
     }
 
-    // --- zwarcie międzyfazowe (aktywny tor) — analiza bitmask
-    const QSet<QString> interPhase = computeInterPhaseFault(m_edges, m_phaseSources);
-    if (!interPhase.isEmpty()) {
+    // --- zwarcie międzyfazowe (aktywny tor)
+    if (!m_interPhase.isEmpty()) {
         QStringList list;
-        for (const QString& pinNode : interPhase) {
+        for (const QString& pinNode : std::as_const(m_interPhase)) {
             const QString pinView = m_nodeToView.value(pinNode, pinNode);
-            if (m_view) m_view->setTerminalFault(pinView, true);
+            if (m_view && live) m_view->setTerminalFault(pinView, true);
             list << pinNode;
         }
         if (auto* sb = statusBar())
             sb->showMessage(tr("Zwarcie międzyfazowe (aktywny tor) na: %1").arg(list.join(", ")));
     }
 
-    // --- NOWE: maski faz na węzłach + podanie do silników w KAŻDEJ rundzie
-    const QHash<QString,int> phaseMask = computePhaseMask(m_edges, m_phaseSources);
+    if (tracing) traceChanges(traceT, prevPhase, prevNeutral, m_traceResync ? nullptr : &r.changed);
+    m_traceResync = false;
+
+    // --- maski faz do silników w KAŻDEJ rundzie
+    for (int id = 0; id < m_motors.size(); ++id)
+        if (m_motors.isValid(id)) pushMotorMasks(m_motors.prefix(id));
 
-    // helper do pobrania maski faz na konkretnym pinie (domyślnie 0 = brak fazy)
-    auto mOf = [&](const QString& node) -> int {
-        return phaseMask.value(node, 0);
+    if (m_acOn && live) runAcAnalysis();
+}
+
+// Zmiany FAZA/ZERO/zwarcie względem poprzedniego przeliczenia. Zwykle tylko węzły z listy
+// zmian workera (koszt ~ liczba zmian); bez listy (start, po wyczyszczeniu) — pełne porównanie.
+void MainWindow::traceChanges(quint64 t, const QSet<QString>& prevPhase, const QSet<QString>& prevNeutral,
+                              const QSet<QString>* changed) {
+    using Signal = TraceRecorder::Signal;
+    if (changed) {
+        for (const QString& n : *changed) {
+            const bool p = m_phaseHot.contains(n), ne = m_neutralHot.contains(n);
+            if (p != prevPhase.contains(n))   m_trace.record(t, m_trace.pinId(n), Signal::Phase, p);
+            if (ne != prevNeutral.contains(n)) m_trace.record(t, m_trace.pinId(n), Signal::Neutral, ne);
+            const bool fault = (p && ne) || m_interPhase.contains(n);
+            if (fault == m_traceFault.contains(n)) continue;
+            m_trace.record(t, m_trace.pinId(n), Signal::Fault, fault);
+            if (fault) m_traceFault.insert(n);
+            else       m_traceFault.remove(n);
+        }
+        return;
+    }
+
+    auto diff = [&](const QSet<QString>& before, const QSet<QString>& after, Signal s) {
+        for (const QString& n : after)  if (!before.contains(n)) m_trace.record(t, m_trace.pinId(n), s, true);
+        for (const QString& n : before) if (!after.contains(n))  m_trace.record(t, m_trace.pinId(n), s, false);
     };
+    diff(prevPhase,   m_phaseHot,   Signal::Phase);
+    diff(prevNeutral, m_neutralHot, Signal::Neutral);
 
-    // WYPISZ MASKI DO SILNIKÓW:
-    // Jeśli masz rejestr silników, iteruj po nim. Poniżej przykład dla jednego „M1_”.
-    auto pushMotor = [&](const QString& pref){
-        // dopasuj nazwy pinów do Twojego Motor3PhaseBlock (U/V/W lub T1/T2/T3)
-        const int mU = mOf(pref + "U");
-        const int mV = mOf(pref + "V");
-        const int mW = mOf(pref + "W");
-        if (m_view) {
-            // metoda w ContactorView, która przekaże dalej do Motor3PhaseBlock::setPhaseMasks(...)
-            m_view->setMotorPhaseMasks(pref, mU, mV, mW);
+    QSet<QString> fault = m_interPhase;
+    const bool phaseSmaller = m_phaseHot.size() < m_neutralHot.size();
+    const QSet<QString>& small = phaseSmaller ? m_phaseHot : m_neutralHot;
+    const QSet<QString>& large = phaseSmaller ? m_neutralHot : m_phaseHot;
+    for (const QString& n : small) if (large.contains(n)) fault.insert(n);
+    diff(m_traceFault, fault, Signal::Fault);
+    m_traceFault = std::move(fault);
+}
+
+void MainWindow::startTrace(bool on) {
+    if (on) {
+        m_trace.start();
+        m_traceFault.clear();
+        // Stan początkowy jako zdarzenia w chwili 0 — przebieg od razu kompletny
+        const quint64 t = m_trace.now();
+        traceChanges(t, {}, {}, nullptr);
+        for (int id = 0; id < m_contactors.size(); ++id)
+            if (m_contactors.isEnergized(id))
+                m_trace.record(t, m_trace.pinId(m_contactors.prefix(id)), TraceRecorder::Signal::Energized, true);
+        statusBar()->showMessage(tr("Rejestracja przebiegów włączona"));
+    } else {
+        m_trace.stop();
+        statusBar()->showMessage(tr("Rejestracja zatrzymana: %1 zdarzeń (nadpisanych: %2)")
+                                     .arg(m_trace.total()).arg(m_trace.dropped()));
+    }
+}
+
+// Migawka bufora w wątku GUI (kopia pamięci), zapis pliku w tle
+void MainWindow::exportTraceVcd() {
+    const QString path = QFileDialog::getSaveFileName(this, tr("Eksportuj przebiegi"), QString(),
+                                                      tr("Value Change Dump (*.vcd)"));
+    if (path.isEmpty()) return;
+
+    const QVector<TraceRecorder::Event> events = m_trace.snapshot();
+    const QStringList names = m_trace.names();
+    const bool truncated = m_trace.dropped() > 0;
+    statusBar()->showMessage(tr("Eksport %1 zdarzeń…").arg(events.size()));
+    m_ioPool.start([this, path, events, names, truncated] {
+        QString error;
+        const bool ok = TraceRecorder::writeVcd(path, events, names, truncated, &error);
+        QMetaObject::invokeMethod(this, [this, path, ok, error, n = events.size()] {
+            if (ok) statusBar()->showMessage(tr("Zapisano %1 (%2 zdarzeń)").arg(path).arg(n));
+            else    QMessageBox::warning(this, tr("Eksport przebiegów"), tr("Nie udało się zapisać %1:\n%2").arg(path, error));
+        }, Qt::QueuedConnection);
+    });
+}
+
+// Oś czasu z migawki bufora: klatki kluczowe liczone raz, przewijanie = klatka + różnice
+void MainWindow::openReplay() {
+    const QVector<TraceRecorder::Event> events = m_trace.snapshot();
+    if (events.isEmpty()) {
+        statusBar()->showMessage(tr("Brak zapisanych przebiegów — włącz Symulacja > Rejestruj przebiegi"));
+        return;
+    }
+    m_timeline = std::make_unique<TraceTimeline>(events, m_trace.names());
+
+    if (!m_replayBar) {
+        m_replayBar = new QToolBar(tr("Zapis przebiegów"), this);
+        m_replayBar->setMovable(false);
+        m_replaySlider = new QSlider(Qt::Horizontal, m_replayBar);
+        m_replaySlider->setRange(0, REPLAY_SLIDER_STEPS);
+        m_replayLabel = new QLabel(m_replayBar);
+        m_replayLabel->setMinimumWidth(320);
+        m_replayBar->addWidget(m_replaySlider);
+        m_replayBar->addWidget(m_replayLabel);
+        m_replayBar->addAction(tr("Stan bieżący"), this, &MainWindow::closeReplay);
+        addToolBar(Qt::BottomToolBarArea, m_replayBar);
+        connect(m_replaySlider, &QSlider::valueChanged, this, &MainWindow::showReplayAt);
+    }
+    m_replayShown.fill(0xFF, m_timeline->idCount());   // pierwsze malowanie — wszystkie piny
+    m_replayBar->show();
+    {
+        const QSignalBlocker block(m_replaySlider);
+        m_replaySlider->setValue(REPLAY_SLIDER_STEPS);
+    }
+    showReplayAt(REPLAY_SLIDER_STEPS);
+}
+
+void MainWindow::showReplayAt(int sliderPos) {
+    if (!m_timeline || !m_view) return;
+    const quint64 t0 = m_timeline->startTime();
+    const quint64 span = m_timeline->endTime() - t0;
+    const quint64 t = t0 + quint64(double(span) * sliderPos / REPLAY_SLIDER_STEPS);
+
+    m_timeline->stateAt(t, m_replayState);
+    using Signal = TraceRecorder::Signal;
+    int energized = 0;
+    for (int id = 0; id < m_replayState.size(); ++id) {
+        const quint8 s = m_replayState[id];
+        if (s & TraceTimeline::bit(Signal::Energized)) ++energized;
+        if (s == m_replayShown[id]) continue;
+        const QString& pin = m_timeline->name(id);
+        if (pin.endsWith(QLatin1Char('_'))) continue;    // stycznik (cewka), nie zacisk
+        m_view->setTerminalPhase(pin,   s & TraceTimeline::bit(Signal::Phase));
+        m_view->setTerminalNeutral(pin, s & TraceTimeline::bit(Signal::Neutral));
+        m_view->setTerminalFault(pin,   s & TraceTimeline::bit(Signal::Fault));
+    }
+    std::swap(m_replayShown, m_replayState);
+
+    m_replayLabel->setText(tr("t = %1 s · zdarzenia %2/%3 · cewki załączone: %4")
+                               .arg(double(t) / 1e9, 0, 'f', 3)
+                               .arg(m_timeline->eventsUpTo(t)).arg(m_timeline->eventCount())
+                               .arg(energized));
+}
+
+void MainWindow::closeReplay() {
+    m_timeline.reset();
+    m_replayState.clear();
+    m_replayShown.clear();
+    if (m_replayBar) m_replayBar->hide();
+    recomputeSignals();          // z powrotem stan bieżący
+}
+
+// Stan z ostatniego przeliczenia na wskazanych zaciskach — bez liczenia grafu od nowa
+void MainWindow::paintPins(const QStringList& pins) {
+    if (!m_view || m_timeline) return;
+    for (const QString& node : pins) {
+        const QString pin = m_nodeToView.value(node, node);
+        const bool nHot = m_neutralHot.contains(node);
+        const bool pHot = m_phaseHot.contains(node);
+        m_view->setTerminalNeutral(pin, nHot);
+        m_view->setTerminalPhase(pin,  pHot);
+        m_view->setTerminalFault(pin, (nHot && pHot) || m_interPhase.contains(node));
+    }
+}
+
+// Maski faz na zaciskach silnika -> Motor3PhaseBlock::setPhaseMasks(...)
+void MainWindow::pushMotorMasks(const QString& pref) {
+    // dopasuj nazwy pinów do Twojego Motor3PhaseBlock (U/V/W lub T1/T2/T3)
+    const int mU = m_phaseMask.value(pref + "U", 0);
+    const int mV = m_phaseMask.value(pref + "V", 0);
+    const int mW = m_phaseMask.value(pref + "W", 0);
+    if (m_view) m_view->setMotorPhaseMasks(pref, mU, mV, mW);
+
+    // Zasilanie dla modelu cieplnego: liczba różnych faz (zacisk z kilkoma fazami = zwarcie, nie liczy się)
+    const int id = m_motors.id(pref);
+    if (id == MotorThermalBank::NONE) return;
+    int phases = 0;
+    for (int m : { mU, mV, mW })
+        if (m && !(m & (m - 1))) phases |= m;
+    m_motors.setSupply(id, (phases & 1) + ((phases >> 1) & 1) + ((phases >> 2) & 1));
+}
+
+// Numer w banku silników jest stały do usunięcia silnika, a krawędź 95-96 znika razem z nim
+std::function<bool()> MainWindow::overloadCond(int motorId) const {
+    return [this, motorId]() -> bool { return !m_motors.isTripped(motorId); };
+}
+
+// Całkowanie do końca interwału; wyzwolenie przerywa krok, bo otwarty styk 95-96
+// zmienia obwód sterowania (a więc zasilanie silników) — reszta czasu czeka,
+// aż wynik z otwartym stykiem wróci z wątku symulacji
+void MainWindow::thermalTick() {
+    if (m_motors.count() == 0 || m_timeline || m_recomputeHold > 0) return;
+
+    const double dt = THERMAL_TICK_MS / 1000.0 * m_simSpeed;
+    if (m_simShown < m_thermalWait) { m_thermalLag += dt; return; }
+
+    const double total = dt + std::exchange(m_thermalLag, 0.0);
+    const double done = m_motors.advance(total);
+    if (!m_motors.tripped().isEmpty()) {
+        QStringList names;
+        for (int id : m_motors.tripped()) {
+            names << m_motors.prefix(id).chopped(1);
+            SimWorker::Op op;
+            op.kind = SimWorker::Op::Kind::SetTripped;
+            op.prefix = m_motors.prefix(id);
+            op.on = true;
+            m_sim.post(std::move(op));
         }
+        recomputeSignals();
+        m_thermalWait = m_sim.generation();
+        m_thermalLag = total - done;
+        statusBar()->showMessage(tr("Zadziałał przekaźnik przeciążeniowy F: %1").arg(names.join(", ")));
+    }
+
+    if (!m_view) return;
+    for (int id = 0; id < m_motors.size(); ++id)
+        if (m_motors.isValid(id))
+            m_view->setMotorOverload(m_motors.prefix(id), m_motors.heat(id), m_motors.isTripped(id));
+}
+
+// ===================== ANALIZA AC =====================
+// Struktura (węzły, wzorzec, porządek, faktoryzacja symboliczna) tylko po zmianie
+// grafu lub zestawu urządzeń; zmiana stanu styczników i źródeł to sama faktoryzacja numeryczna
+void MainWindow::runAcAnalysis() {
+    const int devices = m_contactors.count() + m_motors.count();
+    if (!m_ac.hasTopology() || m_acEdgeRevision != m_edges.revision()
+        || m_acNodeCount != m_auxNodes.size() || m_acDeviceCount != devices) {
+        QVector<AcSolver::Coil> coils;
+        for (int id = 0; id < m_contactors.size(); ++id)
+            if (!m_contactors.coilPinA(id).isEmpty())
+                coils.push_back({ m_contactors.prefix(id), m_contactors.coilPinA(id), m_contactors.coilPinB(id) });
+        QVector<AcSolver::Motor> motors;
+        for (int id = 0; id < m_motors.size(); ++id) {
+            if (!m_motors.isValid(id)) continue;
+            const QString& M = m_motors.prefix(id);
+            motors.push_back({ M, M + "U", M + "V", M + "W", [this, id]{ return double(m_motors.load(id)); } });
+        }
+        m_ac.setTopology(m_edges.edges(), m_auxNodes, coils, motors);
+        m_acEdgeRevision = m_edges.revision();
+        m_acNodeCount    = m_auxNodes.size();
+        m_acDeviceCount  = devices;
+    }
+
+    QString error;
+    if (!m_ac.solve(m_phaseSources, m_neutralSources, &error)) {
+        if (m_acLabel) m_acLabel->setText(tr("AC: %1").arg(error));
+        return;
+    }
+
+    // Skrót: największy prąd źródła i najniższe napięcie na zasilonej cewce
+    const AcSolver::Result& r = m_ac.result();
+    const AcSolver::Reading* src = nullptr;
+    for (const auto& s : r.sources)
+        if (!src || s.value > src->value) src = &s;
+    const AcSolver::Reading* coil = nullptr;
+    for (const auto& c : r.coils)
+        if (c.value > 1.0 && (!coil || c.value < coil->value)) coil = &c;
+
+    QStringList parts;
+    parts << tr("AC: %1 węzłów").arg(r.nodes);
+    if (src)  parts << tr("źródło max %1 A (%2)").arg(src->value, 0, 'f', 1).arg(src->name);
+    if (coil) parts << tr("cewka min %1 V (%2)").arg(coil->value, 0, 'f', 0).arg(coil->name.chopped(1));
+    parts << tr("%1 ms").arg(r.numericMs, 0, 'f', 2);
+    if (m_acLabel) m_acLabel->setText(parts.join(QStringLiteral(", ")));
+}
+
+void MainWindow::showAcResults() {
+    if (!m_acOn) {
+        QMessageBox::information(this, tr("Analiza AC"), tr("Włącz najpierw Symulacja > Analiza AC."));
+        return;
+    }
+    const AcSolver::Result& r = m_ac.result();
+    auto top = [](QVector<AcSolver::Reading> list, bool descending, const char* unit) {
+        std::sort(list.begin(), list.end(), [descending](const auto& a, const auto& b) {
+            return descending ? a.value > b.value : a.value < b.value;
+        });
+        QStringList lines;
+        for (int i = 0; i < list.size() && i < 10; ++i)
+            lines << QStringLiteral("  %1: %2 %3").arg(list[i].name).arg(list[i].value, 0, 'f', 1).arg(QLatin1String(unit));
+        return lines.isEmpty() ? QStringLiteral("  —") : lines.join(QLatin1Char('\n'));
     };
+    QVector<AcSolver::Reading> fedCoils;
+    for (const auto& c : r.coils)
+        if (c.value > 1.0) fedCoils << c;
+
+    QMessageBox::information(this, tr("Analiza AC"),
+        tr("Węzłów: %1, niezerowych L: %2\nFaktoryzacja symboliczna: %3 ms, stan: %4 ms\n\n"
+           "Prądy źródeł:\n%5\n\nSilniki (największy prąd fazowy):\n%6\n\n"
+           "Najniższe napięcia zasilonych cewek:\n%7\n\nNajwiększe prądy styków:\n%8")
+            .arg(r.nodes).arg(r.nnzL)
+            .arg(r.symbolicMs, 0, 'f', 1).arg(r.numericMs, 0, 'f', 2)
+            .arg(top(r.sources, true, "A"), top(r.motors, true, "A"),
+                 top(fedCoils, false, "V"), top(r.contacts, true, "A")));
+}
 
-    // TODO: zamień na pętlę po wszystkich silnikach, jeśli je rejestrujesz
-    pushMotor("M1_");
-    // np. dla drugiego: pushMotor("M2_");
+// ===================== KONTROLA PROJEKTU =====================
+void MainWindow::onDrcResult() {
+    if (!m_drc.fetch() || !m_drcList) return;
+    const DrcWorker::Result& r = m_drc.result();
+    m_drcList->setUpdatesEnabled(false);
+    m_drcList->clear();
+    m_drcPins.clear();
+    for (const DrcIssue& issue : r.issues) {
+        auto* item = new QListWidgetItem(issue.message, m_drcList);
+        item->setData(Qt::UserRole, issue.pins);
+        m_drcPins += issue.pins;
+    }
+    m_drcList->setUpdatesEnabled(true);
+    m_drcDock->setWindowTitle(r.issues.isEmpty() ? tr("Kontrola projektu: bez błędów")
+                                                 : tr("Kontrola projektu: błędów %1").arg(r.issues.size()));
+    showDrcMarkers();
 }
 
+void MainWindow::showDrcMarkers() {
+    if (m_view) m_view->setDrcMarkers(m_drcDock && m_drcDock->isVisible() ? m_drcPins : QStringList());
+}
 
-// ===================== Kasowanie stycznika (istniejące) =====================
-void MainWindow::onContactorDelete(const QString& K) {
-    if (!m_contactors.contains(K)) return;
+// ===================== BLOKADY: przeszukiwanie stanów =====================
+// Przyciski to źródła FAZA/ZERO postawione przez użytkownika; zasilania 3F są stałe.
+// Model to migawka z wątku GUI — przeszukiwanie nie czyta niczego z okna.
+void MainWindow::checkInterlocks() {
+    bool ok = false;
+    const QString text = QInputDialog::getMultiLineText(this, tr("Blokady styczników"),
+        tr("Niezmienniki, jeden w wierszu (styczniki K1, piny przycisków; not/and/or, nawiasy):"),
+        m_invariants, &ok);
+    if (!ok) return;
+    m_invariants = text;
+
+    StateExplorer::Model model;
+    for (int id = 0; id < m_contactors.size(); ++id)
+        if (!m_contactors.prefix(id).isEmpty()) model.devices << deviceOp(m_contactors.prefix(id));
+    for (int id = 0; id < m_motors.size(); ++id)
+        if (m_motors.isValid(id)) model.devices << deviceOp(m_motors.prefix(id));
+    for (const Edge& e : m_edges.edges())
+        if (e.owner.isEmpty()) model.wires.push_back({ e.a, e.b, {}, {} });
 
-    for (int i = m_edges.size() - 1; i >= 0; --i) {
-        const Edge& e = m_edges[i];
-        if (e.a.startsWith(K) || e.b.startsWith(K)) {
-            m_edges.remove(i);
+    // Szyny bloków zasilania są zawsze pod napięciem (POWER jak załączony) — to jedyne
+    // źródła stałe. Przyciskami są wszystkie przyciski urządzeń (START/RET i z katalogu)
+    // oraz źródła postawione przez użytkownika, niezależnie od tego, czy teraz są wciśnięte:
+    // w spoczynku przycisk nie jest źródłem, a przeszukiwanie musi go móc nacisnąć.
+    for (const QString& P : std::as_const(m_powers))
+        for (const QString& pin : m_devicePins.value(P)) model.phase.insert(pin);
+    QSet<QPair<QString, bool>> seen;
+    auto addInput = [&](const QString& pin, bool neutral) {
+        if (!neutral && model.phase.contains(pin)) return;
+        if (seen.contains(qMakePair(pin, neutral))) return;
+        seen.insert(qMakePair(pin, neutral));
+        model.inputs.push_back({ pin, neutral });
+    };
+    for (int id = 0; id < m_contactors.size(); ++id) {
+        const QString K = m_contactors.prefix(id);
+        const DeviceTemplate* tpl = K.isEmpty() ? nullptr : m_templates.value(K, nullptr);
+        if (!tpl) continue;
+        for (const DeviceTemplate::Button& b : tpl->buttons)
+            addInput(K + tpl->pins[b.pin].suffix, b.neutral);
+    }
+    for (const QSet<QString>* set : { &m_phaseSources, &m_neutralSources }) {
+        QStringList pins(set->cbegin(), set->cend());
+        pins.sort();                                    // stała kolejność bitów stanu
+        for (const QString& pin : std::as_const(pins)) addInput(pin, set == &m_neutralSources);
+    }
+
+    const quint64 gen = ++m_exploreGen;
+    m_exploreLatest.store(gen, std::memory_order_relaxed);     // poprzednie przeszukiwanie traci sens
+    const quint64 revision = m_edges.revision();
+    const QStringList invariants = text.split(QLatin1Char('\n'));
+    statusBar()->showMessage(tr("Przeszukiwanie stanów: przycisków %1, styczników %2…")
+                                 .arg(model.inputs.size()).arg(m_contactors.size()));
+    m_ioPool.start([this, gen, revision, model = std::move(model), invariants] {
+        auto result = std::make_shared<StateExplorer::Result>(
+            StateExplorer::explore(model, invariants, CancelToken{ &m_exploreLatest, gen }));
+        QMetaObject::invokeMethod(this, [this, gen, revision, result] {
+            onInterlocksChecked(gen, revision, *result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::onInterlocksChecked(quint64 generation, quint64 revision, const StateExplorer::Result& r) {
+    if (generation != m_exploreGen) return;             // przerwane albo nowsze przeszukiwanie
+    const QString title = tr("Blokady styczników");
+    statusBar()->showMessage(tr("Przeszukiwanie stanów: %1 stanów w %2 ms").arg(r.states).arg(r.ms, 0, 'f', 0));
+    if (!r.error.isEmpty()) {
+        QMessageBox::warning(this, title, r.error);
+        return;
+    }
+
+    QString text;
+    if (!r.violated.isEmpty()) {
+        text = tr("Naruszony niezmiennik: %1\n\n").arg(r.violated);
+        if (r.trace.isEmpty()) {
+            text += tr("Już w stanie spoczynku, bez żadnego przycisku.");
+        } else {
+            QStringList steps;
+            for (const StateExplorer::Step& s : r.trace)
+                steps << tr("%1. %2 %3 (%4) → %5")
+                             .arg(steps.size() + 1)
+                             .arg(s.on ? tr("załącz") : tr("wyłącz"), s.pin,
+                                  s.neutral ? tr("ZERO") : tr("FAZA"),
+                                  s.energized.isEmpty() ? tr("wszystkie wyłączone") : s.energized.join(", "));
+            text += tr("Sekwencja od spoczynku:\n%1").arg(steps.join(QLatin1Char('\n')));
         }
+        if (r.iteration > 0)
+            text += tr("\n\n(po %1. iteracji styczników od ostatniego przełączenia)").arg(r.iteration);
+    } else if (r.complete) {
+        text = tr("Niezmienniki spełnione we wszystkich osiągalnych stanach.");
+    } else {
+        text = tr("Nie znaleziono naruszenia, ale przestrzeń stanów nie została zbadana w całości "
+                  "(limit %1 stanów).").arg(StateExplorer::MAX_STATES);
     }
-    auto filterOutWithPrefix = [&](QSet<QString>& set){
-        for (auto it = set.begin(); it != set.end(); ) {
-            if (it->startsWith(K)) it = set.erase(it);
-            else ++it;
+    text += tr("\n\nStanów: %1, głębokość: %2, stożków wpływu: %3 (największy: przycisków %4, styczników %5), "
+               "grup zamiennych przycisków: %6.")
+                .arg(r.states).arg(r.depth).arg(r.cones).arg(r.inputs).arg(r.contactors).arg(r.symmetricGroups);
+    if (revision != m_edges.revision())
+        text += tr("\n\nSchemat zmienił się w trakcie — wynik dotyczy stanu z chwili uruchomienia.");
+
+    if (r.violated.isEmpty()) QMessageBox::information(this, title, text);
+    else                      QMessageBox::warning(this, title, text);
+}
+
+// ===================== SIECI I ZASILANIE PINU =====================
+void MainWindow::highlightNet(const QString& pin) {
+    m_netPin = pin;
+    if (!m_view) return;
+    if (pin.isEmpty()) {
+        m_view->clearNetHighlight();
+        return;
+    }
+    const QStringList pins = m_nets.pins(pin);
+    m_view->highlightNet(pins);
+    statusBar()->showMessage(tr("Sieć %1: pinów %2").arg(pin).arg(pins.size()));
+}
+
+// Po powrocie do pętli zdarzeń — grafika mostków jest już zaktualizowana (także hurtowo)
+void MainWindow::netChanged() {
+    if (m_netPin.isEmpty() || m_netRefreshQueued) return;
+    m_netRefreshQueued = true;
+    QTimer::singleShot(0, this, [this]{
+        m_netRefreshQueued = false;
+        if (!m_netPin.isEmpty() && m_view) m_view->highlightNet(m_nets.pins(m_netPin));
+    });
+}
+
+// Ze zbioru źródeł ostatniego wyniku; styki — wzdłuż jednej z przewodzących ścieżek
+void MainWindow::showFeeds(const QString& pin) {
+    auto lines = [&](const QStringList& sources) {
+        QStringList out;
+        for (const QString& s : sources) {
+            QStringList contacts;
+            for (const SourceIndex::Step& st : m_sources.contactsOnPath(pin, s))
+                contacts << QStringLiteral("%1–%2").arg(st.a, st.b);
+            out << (contacts.isEmpty() ? tr("  %1 (bez styków)").arg(s)
+                                       : tr("  %1 przez %2").arg(s, contacts.join(", ")));
         }
+        return out.isEmpty() ? QStringLiteral("  —") : out.join(QLatin1Char('\n'));
     };
-    filterOutWithPrefix(m_phaseSources);
-    filterOutWithPrefix(m_neutralSources);
-    filterOutWithPrefix(m_phaseHot);
-    filterOutWithPrefix(m_neutralHot);
+    QString text = tr("Faza:\n%1\n\nZero:\n%2")
+                       .arg(lines(m_sources.phaseSources(pin)), lines(m_sources.neutralSources(pin)));
+    if (m_simShown < m_sim.generation())
+        text += tr("\n\n(stan sprzed ostatniej zmiany — trwa przeliczanie)");
+    QMessageBox::information(this, tr("Zasilanie %1").arg(pin), text);
+}
 
-    for (auto it = m_auxNodes.begin(); it != m_auxNodes.end(); ) {
-        if (it->startsWith(K)) it = m_auxNodes.erase(it);
-        else ++it;
+// ===================== SILNIKI: przekaźnik F =====================
+void MainWindow::onMotorReset(const QString& M) {
+    const int id = m_motors.id(M);
+    if (id == MotorThermalBank::NONE) return;
+    const QString name = M.chopped(1);
+    if (!m_motors.isTripped(id)) {
+        statusBar()->showMessage(tr("Przekaźnik F silnika %1 nie jest wyzwolony").arg(name));
+        return;
     }
-    for (auto it = m_nodeToView.begin(); it != m_nodeToView.end(); ) {
-        if (it.key().startsWith(K)) it = m_nodeToView.erase(it);
-        else ++it;
+    if (!m_motors.reset(id)) {
+        statusBar()->showMessage(tr("Przekaźnik F silnika %1 jeszcze za gorący (%2% progu, kasowanie poniżej %3%)")
+                                     .arg(name).arg(qRound(m_motors.heat(id) * 100.0f))
+                                     .arg(qRound(MotorThermalBank::RESET_LEVEL * 100.0f)));
+        return;
     }
+    SimWorker::Op op;
+    op.kind = SimWorker::Op::Kind::SetTripped;
+    op.prefix = M;
+    op.on = false;
+    m_sim.post(std::move(op));
+    recomputeSignals();
+    if (m_view) m_view->setMotorOverload(M, m_motors.heat(id), false);
+    statusBar()->showMessage(tr("Skasowano przekaźnik F silnika %1").arg(name));
+}
 
-    m_contactors.remove(K);
-    m_contEnergized.remove(K);
+void MainWindow::onMotorLoad(const QString& M) {
+    const int id = m_motors.id(M);
+    if (id == MotorThermalBank::NONE) return;
+    bool ok = false;
+    const double load = QInputDialog::getDouble(this, tr("Silnik %1").arg(M.chopped(1)),
+                                                tr("Prąd obciążenia (× nastawa Ir):"),
+                                                m_motors.load(id), 0.0, 10.0, 2, &ok);
+    if (!ok) return;
+    const QStringList classes = { QStringLiteral("5"), QStringLiteral("10"), QStringLiteral("20"), QStringLiteral("30") };
+    const QString cls = QInputDialog::getItem(this, tr("Silnik %1").arg(M.chopped(1)), tr("Klasa wyzwalania F:"),
+                                              classes, qMax(0, classes.indexOf(QString::number(m_motors.tripClass(id)))),
+                                              false, &ok);
+    if (!ok) return;
+    m_motors.setLoad(id, float(load));
+    m_motors.setTripClass(id, cls.toInt());
+    if (m_acOn) runAcAnalysis();
+}
 
-    if (m_view) m_view->removeContactor(K);
 
+// ===================== Kasowanie stycznika (istniejące) =====================
+void MainWindow::onContactorDelete(const QString& K) {
+    if (!m_contactors.contains(K)) return;
+
+    recordRemoval(K);
+    removeDevice(K);
     recomputeSignals();
 
     if (auto* sb = statusBar()) sb->showMessage(tr("Usunięto %1").arg(K.left(K.size()-1)));
 }
+
+
+// ===================== HISTORIA (cofnij/ponów) =====================
+void MainWindow::recordPlaced(const QStringList& prefixes) {
+    if (!m_view || !m_journal.isRecording()) return;
+    m_journal.begin(prefixes.size() == 1 ? tr("wstaw %1").arg(prefixes.first().chopped(1))
+                                         : tr("wstaw %1 urządzeń").arg(prefixes.size()));
+    for (const QString& prefix : prefixes) {
+        const ContactorView::PlacedDevice placed = m_view->placedDevice(prefix);
+        if (placed.index <= 0) continue;
+        UndoJournal::Delta d;
+        d.op = UndoJournal::Op::PlaceDevice;
+        d.device = { toFileKind(placed.kind), placed.index, placed.topLeft, placed.type };
+        m_journal.record(std::move(d));
+    }
+    m_journal.commit();
+    updateUndoActions();
+}
+
+// Kolejność delt = kolejność ponawiania: mostki, źródła, na końcu samo urządzenie
+void MainWindow::recordRemoval(const QString& prefix) {
+    if (!m_view || !m_journal.isRecording()) return;
+    const ContactorView::PlacedDevice placed = m_view->placedDevice(prefix);
+    if (placed.index <= 0) return;
+
+    m_journal.begin(tr("usuń %1").arg(prefix.chopped(1)));
+    QSet<QString> seen;                              // para a|b — mostek raz, nie dwa
+    for (const QString& pin : m_devicePins.value(prefix)) {
+        for (int i : m_edges.edgesAt(pin)) {
+            const Edge& e = m_edges.edges()[i];
+            if (!e.owner.isEmpty()) continue;
+            const QString key = (e.a < e.b) ? e.a + QLatin1Char('|') + e.b : e.b + QLatin1Char('|') + e.a;
+            if (seen.contains(key)) continue;
+            seen.insert(key);
+            UndoJournal::Delta d;
+            d.op = UndoJournal::Op::RemoveWire;
+            d.a = e.a; d.b = e.b;
+            d.points = m_view->bridgePoints(e.a, e.b);
+            m_journal.record(std::move(d));
+        }
+        for (const bool neutral : { false, true }) {
+            if (!(neutral ? m_neutralSources : m_phaseSources).contains(pin)) continue;
+            UndoJournal::Delta d;
+            d.op = UndoJournal::Op::SetSource;
+            d.a = pin; d.neutral = neutral; d.on = false;
+            m_journal.record(std::move(d));
+        }
+    }
+    UndoJournal::Delta d;
+    d.op = UndoJournal::Op::RemoveDevice;
+    d.device = { toFileKind(placed.kind), placed.index, placed.topLeft, placed.type };
+    m_journal.record(std::move(d));
+    m_journal.commit();
+    updateUndoActions();
+}
+
+void MainWindow::recordSource(const QString& pin, bool neutral, bool on) {
+    if ((neutral ? m_neutralSources : m_phaseSources).contains(pin) == on) return;   // bez zmiany
+    UndoJournal::Delta d;
+    d.op = UndoJournal::Op::SetSource;
+    d.a = pin; d.neutral = neutral; d.on = on;
+    m_journal.record(std::move(d), tr("%1 %2 na %3").arg(on ? tr("źródło") : tr("usuń źródło"),
+                                                         neutral ? tr("ZERO") : tr("FAZA"), pin));
+    updateUndoActions();
+}
+
+// forward = ponów (delta tak, jak zapisana), inaczej jej odwrotność
+void MainWindow::applyDelta(const UndoJournal::Delta& d, bool forward) {
+    using Op = UndoJournal::Op;
+    switch (d.op) {
+    case Op::PlaceDevice:
+    case Op::RemoveDevice:
+        if ((d.op == Op::PlaceDevice) == forward)
+            m_view->placeDeviceAt(fromFileKind(d.device.kind), d.device.index, d.device.topLeft, d.device.type);
+        else
+            removeDevice(devicePrefix(d.device));
+        break;
+    case Op::AddWire:
+    case Op::RemoveWire:
+        if ((d.op == Op::AddWire) == forward) {
+            addWire(d.a, d.b);
+            if (d.points.size() >= 2 && !m_view->hasBridge(d.a, d.b))
+                if (auto* item = m_view->addBridgePolyline(d.points)) m_view->registerBridge(item, d.a, d.b);
+        } else {
+            removeWire(d.a, d.b);
+            m_view->removeBridge(d.a, d.b);
+        }
+        break;
+    case Op::SetSource: {
+        const bool on = forward ? d.on : !d.on;
+        if (d.neutral) setNeutralSource(d.a, on);
+        else           setPhaseSource(d.a, on);
+        break;
+    }
+    }
+}
+
+// Wpisy w jednej transakcji widoku i z jednym przeliczeniem na końcu
+void MainWindow::applyEntries(const QVector<UndoJournal::Entry>& entries, bool forward) {
+    if (!m_view) return;
+    m_journal.suspend();
+    ++m_recomputeHold;
+    m_view->beginBulk();
+    for (const UndoJournal::Entry& e : entries) {
+        if (forward) {
+            for (const UndoJournal::Delta& d : e.deltas) applyDelta(d, true);
+        } else {
+            for (int i = e.deltas.size() - 1; i >= 0; --i) applyDelta(e.deltas[i], false);
+        }
+    }
+    m_view->endBulk();             // rejestracja wstawionych urządzeń (przeliczenie wstrzymane)
+    m_journal.resume();
+    --m_recomputeHold;
+
+    m_view->syncSourceButtons(m_phaseSources, m_neutralSources);
+    recomputeSignals();
+    updateUndoActions();
+}
+
+void MainWindow::undo() {
+    if (!m_journal.canUndo()) return;
+    const QString label = m_journal.undoLabel();
+    const UndoJournal::Entry e = m_journal.takeUndo();
+    m_autosave.append(UndoJournal::inverted(e));
+    applyEntries({ e }, false);
+    statusBar()->showMessage(tr("Cofnięto: %1").arg(label));
+}
+
+void MainWindow::redo() {
+    if (!m_journal.canRedo()) return;
+    const QString label = m_journal.redoLabel();
+    const UndoJournal::Entry e = m_journal.takeRedo();
+    m_autosave.append(e);
+    applyEntries({ e }, true);
+    statusBar()->showMessage(tr("Ponowiono: %1").arg(label));
+}
+
+void MainWindow::updateUndoActions() {
+    if (m_undoAct) {
+        m_undoAct->setEnabled(m_journal.canUndo());
+        m_undoAct->setText(m_journal.canUndo() ? tr("Cofnij: %1").arg(m_journal.undoLabel()) : tr("Cofnij"));
+    }
+    if (m_redoAct) {
+        m_redoAct->setEnabled(m_journal.canRedo());
+        m_redoAct->setText(m_journal.canRedo() ? tr("Ponów: %1").arg(m_journal.redoLabel()) : tr("Ponów"));
+    }
+}
+
+
+// ===================== AUTOZAPIS =====================
+// Co sekundę: dopisanie bufora dziennika w tle; co COMPACT_OPS wpisów albo co kilka
+// minut (jeśli były zmiany) — punkt kontrolny. W wątku GUI tylko zebranie stanu.
+void MainWindow::autosaveTick() {
+    if (!m_autosave.isActive()) return;
+    m_autosave.flush();
+    if (m_import) return;                          // scena jeszcze niekompletna
+    const int ops = m_autosave.opsSinceCheckpoint();
+    if (ops >= Autosave::COMPACT_OPS || (ops > 0 && m_sinceCheckpoint.elapsed() >= AUTOSAVE_CHECKPOINT_MS))
+        autosaveCheckpoint();
+}
+
+void MainWindow::autosaveCheckpoint() {
+    m_autosave.checkpoint(projectData());
+    m_sinceCheckpoint.start();
+}
+
+void MainWindow::offerRecovery() {
+    const auto answer = QMessageBox::question(this, tr("Autozapis"),
+        tr("Poprzednia sesja nie została zamknięta poprawnie.\nOdtworzyć schemat z autozapisu?"));
+    if (answer != QMessageBox::Yes) {
+        autosaveCheckpoint();                      // nowa sesja, stary dziennik usuwany
+        return;
+    }
+
+    // Odczyt dziennika w tle, potem zwykłe wczytanie punktu kontrolnego i odtworzenie wpisów
+    statusBar()->showMessage(tr("Odtwarzanie autozapisu…"));
+    const quint64 gen = m_importGen;
+    const QString dir = m_autosave.recoveryDir();
+    m_ioPool.start([this, gen, dir] {
+        auto recovery = std::make_shared<Autosave::Recovery>(Autosave::readRecovery(dir));
+        QMetaObject::invokeMethod(this, [this, gen, recovery] {
+            onRecoveryRead(gen, recovery);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::onRecoveryRead(quint64 generation, std::shared_ptr<Autosave::Recovery> recovery) {
+    if (generation != m_importGen) return;         // w międzyczasie otwarto inny projekt
+    if (!recovery->error.isEmpty()) {
+        QMessageBox::warning(this, tr("Autozapis"), tr("Nie udało się odtworzyć autozapisu:\n%1").arg(recovery->error));
+        autosaveCheckpoint();
+        return;
+    }
+    loadProject(recovery->checkpoint);
+    m_recovering = true;
+    m_pendingReplay = std::move(recovery->entries);
+}
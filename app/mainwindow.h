@@ -2,21 +2,48 @@
 #include <QMainWindow>
 #include <QPointer>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 #include <QSet>
 #include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <atomic>
 #include <functional>
+#include <memory>
 
 #include "propagation.h"
-#include "contactor_model.h"
+#include "edge_store.h"
+#include "net_index.h"
+#include "contactor_bank.h"
+#include "thermal_bank.h"
+#include "ac_solver.h"
+#include "sim_worker.h"
+#include "drc_worker.h"
+#include "state_explorer.h"
 #include "contactor_view.h"
+#include "undo_journal.h"
+#include "autosave.h"
+#include "trace_recorder.h"
+#include "trace_timeline.h"
 
 class QGraphicsPathItem;
+class QAction;
+class QLabel;
+class QSlider;
+class QToolBar;
+class QProgressBar;
+class QDockWidget;
+class QListWidget;
+struct ImportedProject;
+struct DeviceTemplate;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
 public:
     explicit MainWindow(QWidget* parent = nullptr);
+    ~MainWindow() override;
 
     // LOGIKA SYGNAŁU
     void setPhaseSource(const QString& node, bool on);
@@ -26,18 +53,24 @@ public:
 
 private slots:
     void updateCoilLamp(bool on);
-    void updateMainContacts(ContactorModel::ContactState st);
-    void updateAuxNO(ContactorModel::ContactState st);
-    void updateAuxNC(ContactorModel::ContactState st);
 
     // Styczniki
     void onContactorPlaced(const QString& K);      // "K1_"
+    void onContactorsPlaced(const QStringList& Ks);  // hurtowo — jedno przeliczenie
     void onContactorDelete(const QString& K);      // "K1_"
 
     // NOWE: Zasilanie 3F
     void onPowerPlaced(const QString& P);          // "P1_"
+    void onPowersPlaced(const QStringList& Ps);    // hurtowo — jedno przeliczenie
     void onPowerDelete(const QString& P);          // "P1_"
 
+    // Silniki 3F
+    void onMotorPlaced(const QString& M);          // "M1_"
+    void onMotorsPlaced(const QStringList& Ms);
+    void onMotorDelete(const QString& M);
+    void onMotorReset(const QString& M);           // kasowanie przekaźnika F
+    void onMotorLoad(const QString& M);            // obciążenie i klasa wyzwalania
+
 private:
     void buildUi();
     static void setLampState(class QLabel* lamp, bool on,
@@ -57,30 +90,182 @@ private:
     std::function<bool()>     resolveContact(const QString& name) const;
     std::function<void(bool)> resolveCoilSetter(const QString& name);
 
-    void addContactEdgeDyn(const QString& K, const QString& a, const QString& b, bool isNO);
-    void addWire(const QString& a, const QString& b, std::function<bool()> cond = {});
+    bool registerContactor(const QString& K);      // bez przeliczania
+    bool registerPower(const QString& P);
+    bool registerMotor(const QString& M);
+    void removeDevice(const QString& prefix);      // logika + grafika, bez przeliczania
+    void beginPlaceArray(ContactorView::DeviceKind kind);
+    void routeMissingBridges();                    // połączenia logiczne bez geometrii
+
+    // Projekt (plik .cnp)
+    void resetSchematic();
+    bool saveProject(const QString& path);
+    bool loadProject(const QString& path);     // asynchronicznie: parsowanie w tle, scena porcjami
+    void saveProjectAs();
+    void openProject();
+    void onProjectParsed(quint64 generation, const QString& path, std::shared_ptr<ImportedProject> project);
+    void importStep();                         // jedna porcja grafiki (budżet czasu)
+    void finishImport();
+    void cancelImport();
+    void exportNetlist();
+
+    // Cofnij/ponów (dziennik delt)
+    void recordPlaced(const QStringList& prefixes);
+    void recordRemoval(const QString& prefix);     // urządzenie + jego mostki i źródła
+    void recordSource(const QString& pin, bool neutral, bool on);
+    void applyDelta(const UndoJournal::Delta& d, bool forward);
+    void applyEntries(const QVector<UndoJournal::Entry>& entries, bool forward);
+    void undo();
+    void redo();
+    void updateUndoActions();
+
+    // Autozapis (dziennik w tle) i odzyskiwanie po awarii
+    ProjectFile::Data projectData() const;     // pełny stan sceny (scena kompletna)
+    void autosaveTick();
+    void autosaveCheckpoint();
+    void offerRecovery();
+    void onRecoveryRead(quint64 generation, std::shared_ptr<Autosave::Recovery> recovery);
+
+    void addContactEdgeDyn(const QString& K, int id, const QString& a, const QString& b, bool isNO);
+    std::function<bool()> contactCond(int id, bool isNO) const;
+    std::function<bool()> overloadCond(int motorId) const;     // styk NC 95-96
+    void addWire(const QString& a, const QString& b);          // mostek przewodzi zawsze
     void removeWire(const QString& a, const QString& b);
-    void recomputeSignals(); // z iteracją do zbieżności
+    void postSource(const QString& node, bool neutral, bool on);   // źródło do wątku symulacji
+    void forgetDevice(const QString& prefix);   // krawędzie/źródła/węzły pinów urządzenia
+    void recomputeSignals(); // żądanie przeliczenia w wątku symulacji
+    void onSimResult();      // odbiór najnowszego wyniku: malowanie, ślad, silniki, AC
+    void showFeeds(const QString& pin);        // źródła docierające do pinu i styki po drodze
+    void highlightNet(const QString& pin);     // pusty = wyłączenie
+    void netChanged();                         // podświetlona sieć do odświeżenia (po zmianie mostków)
+    SimWorker::Op deviceOp(const QString& prefix) const;      // stycznik/silnik jako operacja
+    DrcWorker::Op drcDeviceOp(const QString& prefix) const;   // urządzenie dla DRC (także zasilanie)
+    void onDrcResult();      // lista błędów DRC i znaczniki
+    void showDrcMarkers();   // znaczniki tylko przy widocznej liście
+    void checkInterlocks();  // niezmienniki od użytkownika → przeszukiwanie stanów w tle
+    void onInterlocksChecked(quint64 generation, quint64 revision, const StateExplorer::Result& r);
+    void paintPins(const QStringList& pins);   // bieżący stan na (nowych) zaciskach
+    void traceChanges(quint64 t, const QSet<QString>& prevPhase, const QSet<QString>& prevNeutral,
+                      const QSet<QString>* changed);   // nullptr = pełne porównanie
+    void startTrace(bool on);
+    void exportTraceVcd();
+    void openReplay();                         // przeglądanie zapisu na schemacie
+    void showReplayAt(int sliderPos);
+    void closeReplay();
+    void pushMotorMasks(const QString& motorPrefix);
+    void thermalTick();                        // model cieplny silników + wyzwolenia F
+    void runAcAnalysis();                      // napięcia i prądy dla bieżącego stanu
+    void showAcResults();
+
+    // Wstrzymanie przeliczeń na czas operacji hurtowych (wczytywanie projektu)
+    int  m_recomputeHold = 0;
+    bool m_recomputePending = false;
     static QString toViewPin(const QString& nodeLogic) { return nodeLogic; }
 
     // Stan
     ContactorView* m_view = nullptr;
 
     QVector<NamedLink> m_namedLinks;
-    QVector<Edge>      m_edges;          // <-- używa Edge z logic/propagation.h
+    EdgeStore          m_edges;          // krawędzie + indeksy per pin/właściciel (netlista, AC, historia;
+                                         // przeliczenie ma własną kopię modelu w SimWorker)
+    NetIndex           m_nets;           // sieci mostków (pin -> sieć)
+    QString            m_netPin;         // pin podświetlonej sieci (pusty = brak)
+    bool               m_netRefreshQueued = false;
 
     QSet<QString>  m_phaseSources;
     QSet<QString>  m_neutralSources;
     QSet<QString>  m_phaseHot;
     QSet<QString>  m_neutralHot;
+    QSet<QString>  m_interPhase;            // wynik ostatniego przeliczenia
+    QHash<QString, int> m_phaseMask;
+    SourceIndex    m_sources;               // skąd zasilanie — z tego samego wyniku
 
     QSet<QString>  m_auxNodes;
     QHash<QString, QString> m_nodeToView;
 
-    // Zbiór styczników i ich stan energizacji
-    QSet<QString>  m_contactors;            // "K1_", "K2_", ...
-    QHash<QString, bool> m_contEnergized;   // prefix -> energized
+    // Styczniki ("K1_", "KA2_", ...): cewki i energizacja w tablicach banku
+    ContactorBank  m_contactors;
+    QHash<QString, const DeviceTemplate*>   m_templates;    // prefix -> szablon typu (NO/NC styków)
+    QVector<ProjectFile::Device>            m_unknownDevices; // typy spoza katalogu: tylko przenoszone do zapisu
 
     // NOWE: zasilanie 3F
     QSet<QString>  m_powers;                // "P1_", "P2_", ...
+    MotorThermalBank m_motors;              // "M1_", "M2_", ... + stan cieplny przekaźników F
+
+    // Własność pinów: prefiks urządzenia -> jego piny (usuwanie bez skanowania)
+    QHash<QString, QStringList> m_devicePins;
+
+    QString m_projectPath;
+
+    // Historia zmian
+    UndoJournal m_journal;
+    QAction*    m_undoAct = nullptr;
+    QAction*    m_redoAct = nullptr;
+
+    // Rejestracja przebiegów
+    TraceRecorder  m_trace;
+    QSet<QString>  m_traceFault;                  // zwarcia z ostatniego przeliczenia
+    bool           m_traceResync = false;         // następny wynik: pełne porównanie zamiast listy zmian
+
+    // Przeglądanie zapisu (oś czasu) — scena pokazuje przeszłość, żywe malowanie wstrzymane
+    static constexpr int REPLAY_SLIDER_STEPS = 10000;
+    std::unique_ptr<TraceTimeline> m_timeline;
+    QVector<quint8> m_replayState;
+    QVector<quint8> m_replayShown;                // stan aktualnie namalowany (malowanie różnic)
+    QToolBar*      m_replayBar = nullptr;
+    QSlider*       m_replaySlider = nullptr;
+    QLabel*        m_replayLabel = nullptr;
+
+    // Model cieplny: co THERMAL_TICK_MS czasu rzeczywistego m_simSpeed razy więcej czasu symulacji
+    static constexpr int THERMAL_TICK_MS = 100;
+    QTimer         m_thermalTimer;
+    int            m_simSpeed = 1;
+
+    // Analiza AC (opcjonalna): struktura przebudowywana tylko po edycji schematu
+    AcSolver       m_ac;
+    bool           m_acOn = false;
+    QLabel*        m_acLabel = nullptr;
+    quint64        m_acEdgeRevision = 0;
+    int            m_acNodeCount = -1;
+    int            m_acDeviceCount = -1;
+
+    // Rdzeń symulacji w wątku roboczym: edycje jako operacje, wyniki przez potrójny bufor
+    SimWorker      m_sim;
+    quint64        m_simValidFrom = 0;           // wyniki żądań sprzed wyczyszczenia schematu są pomijane
+    quint64        m_simShown = 0;               // żądanie, którego wynik jest na scenie
+    quint64        m_thermalWait = 0;            // po wyzwoleniu F: model cieplny czeka na ten wynik
+    double         m_thermalLag = 0.0;           // s symulacji odłożone na czas czekania
+
+    // Kontrola projektu (DRC) w osobnym wątku: te same edycje, przegląd tylko dotkniętych miejsc
+    DrcWorker      m_drc;
+    QDockWidget*   m_drcDock = nullptr;
+    QListWidget*   m_drcList = nullptr;
+    QStringList    m_drcPins;                    // piny z błędami (znaczniki)
+
+    // Blokady styczników: przeszukiwanie stanów osiągalnych w puli m_ioPool
+    QString        m_invariants = QStringLiteral("not (K1 and K2)");
+    quint64        m_exploreGen = 0;
+    std::atomic<quint64> m_exploreLatest{0};     // CancelToken: nowsze przeszukiwanie / zamknięcie okna
+
+    // Autozapis
+    static constexpr int AUTOSAVE_FLUSH_MS = 1000;               // dopisywanie dziennika
+    static constexpr int AUTOSAVE_CHECKPOINT_MS = 5 * 60 * 1000; // punkt kontrolny, jeśli były zmiany
+    Autosave       m_autosave;
+    QTimer         m_autosaveTimer;
+    QElapsedTimer  m_sinceCheckpoint;
+    bool           m_recovering = false;          // wczytywany punkt kontrolny z autozapisu
+    QVector<UndoJournal::Entry> m_pendingReplay;  // dziennik do odtworzenia po wczytaniu
+
+    // Wczytywanie projektu w tle
+    static constexpr int IMPORT_SLICE_MS = 12;     // budżet jednej porcji w wątku GUI
+    std::shared_ptr<ImportedProject> m_import;    // != nullptr = trwa dokładanie grafiki
+    int            m_importDevice = 0;
+    int            m_importWire = 0;
+    QVector<QPair<QString, QString>> m_importUnrouted;
+    quint64        m_importGen = 0;               // unieważnia wyniki anulowanych wczytań
+    QTimer         m_importTimer;
+    QElapsedTimer  m_importClock;                 // całkowity czas wczytywania
+    QProgressBar*  m_importProgress = nullptr;
+
+    QThreadPool    m_ioPool;                      // ostatni — niszczony pierwszy (czeka na zadania)
 };
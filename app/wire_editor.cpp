@@ -1,17 +1,32 @@
 #include "wire_editor.h"
 #include "contactor_view.h"
 
-#include <QGraphicsPathItem>
+#include <QGraphicsLineItem>
+#include <QGraphicsScene>
 #include <QMouseEvent>
-#include <QPainterPath>
 #include <QPen>
 #include <QtMath>
+#include <utility>
 
 WireEditor::WireEditor(ContactorView* view, QObject* parent)
     : QObject(parent), m_view(view)
 {
     if (m_view && m_view->viewport())
         m_view->viewport()->installEventFilter(this);
+
+    // Ruchy myszy z jednej iteracji pętli zdarzeń → jedna aktualizacja węża
+    m_moveTimer.setSingleShot(true);
+    m_moveTimer.setInterval(0);
+    connect(&m_moveTimer, &QTimer::timeout, this, &WireEditor::flushMove);
+
+    // Wyczyszczenie sceny kasuje też „węża” — zapomnij wskaźnik
+    if (m_view) {
+        connect(m_view, &ContactorView::schematicCleared, this, [this]{
+            m_segments.clear();
+            m_live = nullptr;
+            cancel();
+        });
+    }
 }
 
 bool WireEditor::eventFilter(QObject* obj, QEvent* ev) {
@@ -62,13 +77,28 @@ void WireEditor::startAt(const QString& pin, const QPointF& pos) {
     m_pts.push_back(pos);
     m_dir = Dir::None;
 
-    if (!m_rubber) {
-        m_rubber = new QGraphicsPathItem();
-        m_rubber->setZValue(1.5);
-        m_view->scene()->addItem(m_rubber);
+    dropSegments();
+    if (!m_live) {
+        m_live = newSegment();
+        m_view->scene()->addItem(m_live);
+    }
+    m_live->setLine(QLineF(pos, pos));
+    m_live->setVisible(true);
+}
+
+QGraphicsLineItem* WireEditor::newSegment() const {
+    auto* seg = new QGraphicsLineItem();
+    seg->setPen(ContactorView::penWire(2.0));
+    seg->setZValue(1.5);
+    return seg;
+}
+
+void WireEditor::dropSegments() {
+    for (QGraphicsLineItem* seg : std::as_const(m_segments)) {
+        if (seg->scene()) seg->scene()->removeItem(seg);
+        delete seg;
     }
-    m_rubber->setPen(ContactorView::penWire(2.0));
-    m_rubber->setVisible(true);
+    m_segments.clear();
 }
 
 void WireEditor::cancel() {
@@ -76,7 +106,9 @@ void WireEditor::cancel() {
     m_startPin.clear();
     m_pts.clear();
     m_dir = Dir::None;
-    if (m_rubber) m_rubber->setVisible(false);
+    m_moveTimer.stop();
+    dropSegments();
+    if (m_live) m_live->setVisible(false);
 }
 
 void WireEditor::finishAt(const QString& pin, const QPointF& pos) {
@@ -94,21 +126,30 @@ void WireEditor::finishAt(const QString& pin, const QPointF& pos) {
 }
 
 void WireEditor::onMouseMove(const QPointF& scenePos) {
-    if (!m_rubber || m_pts.isEmpty()) return;
-
-    const QPointF aligned = orthoTo(scenePos);
-
-    QPainterPath ph(m_pts.front());
-    for (int i = 1; i < m_pts.size(); ++i) ph.lineTo(m_pts[i]);
-    ph.lineTo(aligned);
+    m_pendingPos = scenePos;
+    if (!m_moveTimer.isActive()) m_moveTimer.start();
+}
 
-    m_rubber->setPath(ph);
+// Przesuwa tylko ostatni odcinek — przerysowany jest jego mały prostokąt,
+// a nie cały (być może długi) wielobok
+void WireEditor::flushMove() {
+    if (!m_active || !m_live || m_pts.isEmpty()) return;
+    m_live->setLine(QLineF(m_pts.back(), orthoTo(m_pendingPos)));
 }
 
 void WireEditor::onClick(const QPointF& scenePos) {
     const QPointF aligned = orthoTo(scenePos);
-    if (m_pts.isEmpty() || m_pts.back() != aligned)
+    if (m_pts.isEmpty() || m_pts.back() != aligned) {
+        // zakotwiczony odcinek rysujemy raz i więcej go nie ruszamy
+        if (!m_pts.isEmpty() && m_view && m_view->scene()) {
+            auto* seg = newSegment();
+            seg->setLine(QLineF(m_pts.back(), aligned));
+            m_view->scene()->addItem(seg);
+            m_segments.push_back(seg);
+        }
         m_pts.push_back(aligned);
+    }
+    if (m_live) m_live->setLine(QLineF(aligned, aligned));
 
     // Ustal kierunek następnego odcinka jako PROSTOPADŁY do ostatniego
     if (m_pts.size() >= 2) {
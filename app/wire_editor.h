@@ -1,10 +1,11 @@
 #pragma once
 #include <QObject>
 #include <QPointF>
+#include <QTimer>
 #include <QVector>
 
 class ContactorView;
-class QGraphicsPathItem;
+class QGraphicsLineItem;
 class QEvent;
 class QMouseEvent;
 
@@ -28,9 +29,12 @@ private:
     void cancel();
     void finishAt(const QString& pin, const QPointF& pos);
     void onMouseMove(const QPointF& scenePos);
+    void flushMove();                         // zbiorcza obsługa ruchów myszy
     void onClick(const QPointF& scenePos);    // pojedynczy klik: załamka + obrót osi
 
     QPointF orthoTo(const QPointF& scenePos) const; // wyrównanie do H/V względem ostatniego punktu
+    QGraphicsLineItem* newSegment() const;
+    void dropSegments();
 
     // NOWE: każdy pin rozpoznany przez ContactorView jest dozwolony
     bool isAuxPin(const QString& pin) const { return !pin.isEmpty(); }
@@ -41,5 +45,10 @@ private:
     bool                m_active = false;
     Dir                 m_dir = Dir::None;
     QVector<QPointF>    m_pts;        // zakotwiczone punkty (załamki)
-    QGraphicsPathItem*  m_rubber = nullptr; // podążający „wąż”
+
+    // „Wąż”: zakotwiczone odcinki rysowane raz, na żywo zmienia się tylko ostatni
+    QVector<QGraphicsLineItem*> m_segments;
+    QGraphicsLineItem*  m_live = nullptr;
+    QPointF             m_pendingPos;         // ostatnia pozycja myszy do obsłużenia
+    QTimer              m_moveTimer;          // łączy serię ruchów w jedną aktualizację
 };
@@ -0,0 +1,21 @@
+#include "bridge_item.h"
+
+BridgeItem::BridgeItem(const QPainterPath& path, QGraphicsItem* parent)
+    : QGraphicsPathItem(path, parent)
+{
+}
+
+void BridgeItem::setTiled(bool tiled)
+{
+    if (m_tiled == tiled)
+        return;
+    m_tiled = tiled;
+    update();
+}
+
+void BridgeItem::paint(QPainter* p, const QStyleOptionGraphicsItem* opt, QWidget* w)
+{
+    if (m_tiled)
+        return;
+    QGraphicsPathItem::paint(p, opt, w);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QGraphicsPathItem>
+
+// Mostek (przewód) na schemacie.
+// Typ pozostaje QGraphicsPathItem::Type, więc qgraphicsitem_cast<QGraphicsPathItem*>
+// działa jak dotąd. W trybie kafli mostek rysuje TileCache, a sam element
+// tylko przyjmuje kliknięcia.
+class BridgeItem : public QGraphicsPathItem {
+public:
+    explicit BridgeItem(const QPainterPath& path, QGraphicsItem* parent = nullptr);
+
+    void paint(QPainter* p, const QStyleOptionGraphicsItem* opt, QWidget* w) override;
+
+    void setTiled(bool tiled);
+    bool isTiled() const { return m_tiled; }
+
+private:
+    bool m_tiled = false;
+};
@@ -1,16 +1,15 @@
 #include "contactor_LC1D09_LADC22.h"
+#include "device_body_item.h"
+#include "device_template.h"
 
 #include <QBrush>
 #include <QCursor>
 #include <QGraphicsEllipseItem>
-#include <QGraphicsLineItem>
-#include <QGraphicsRectItem>
 #include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
-#include <QGraphicsSimpleTextItem>
 #include <QPainter>
 #include <QPen>
-#include <QLineF>
+#include <QStyleOptionGraphicsItem>
 
 #include <cmath>
 
@@ -41,19 +40,6 @@ QPen penBlock(qreal width = 1.6)
     return pen;
 }
 
-QGraphicsSimpleTextItem* addText(QGraphicsScene* scene,
-                                 const QString&    text,
-                                 const QPointF&    pos,
-                                 qreal             scale = 1.0)
-{
-    auto* item = scene->addSimpleText(text);
-    item->setBrush(colText());
-    item->setScale(scale * SCALE_FACTOR);
-    item->setPos(pos);
-    item->setZValue(2.0);
-    return item;
-}
-
 } // namespace
 
 // ======== SchematicButton ====================================================
@@ -79,13 +65,16 @@ void SchematicButton::setOn(bool on)
     update();
 }
 
-void SchematicButton::paint(QPainter* p, const QStyleOptionGraphicsItem*, QWidget*)
+void SchematicButton::paint(QPainter* p, const QStyleOptionGraphicsItem* opt, QWidget*)
 {
-    p->setRenderHint(QPainter::Antialiasing, true);
+    // Antialiasing zostawiamy widokowi — w trakcie przesuwania/zoomu jest wyłączany
     p->setPen(penWire(1.6));
     p->setBrush(m_on ? QBrush(m_onColor) : QBrush(Qt::NoBrush));
     p->drawRoundedRect(m_rect, PX(5), PX(5));
 
+    // Przy małym powiększeniu napis i tak byłby nieczytelny
+    if (!DeviceBodyItem::isDetailed(opt->levelOfDetailFromTransform(p->worldTransform())))
+        return;
     p->setPen(penWire());
     p->drawText(m_rect, Qt::AlignCenter, m_text);
 }
@@ -106,152 +95,204 @@ Contactor_LC1D09_LADC22::Contactor_LC1D09_LADC22(QGraphicsScene* scene,
                                                  const QString&  prefix,
                                                  const QPointF&  topLeft,
                                                  QObject*        parent)
+    : Contactor_LC1D09_LADC22(scene, prefix, topLeft, deviceTemplate(), parent)
+{
+}
+
+Contactor_LC1D09_LADC22::Contactor_LC1D09_LADC22(QGraphicsScene*       scene,
+                                                 const QString&        prefix,
+                                                 const QPointF&        topLeft,
+                                                 const DeviceTemplate& tpl,
+                                                 QObject*              parent)
     : QObject(parent)
     , m_scene(scene)
     , m_prefix(prefix)
+    , m_tpl(&tpl)
 {
     if (!m_scene)
         return;
     build(topLeft);
 }
 
-void Contactor_LC1D09_LADC22::build(const QPointF& off)
+const DeviceTemplate& Contactor_LC1D09_LADC22::deviceTemplate()
+{
+    static const DeviceTemplate tpl = buildTemplate();
+    return tpl;
+}
+
+DeviceTemplate Contactor_LC1D09_LADC22::buildTemplate()
 {
+    using Layer = DeviceTemplate::Layer;
+
     const int BODY_W       = PX(420);
     const int BODY_H       = PX(320);
     const int MARGIN_TOP_L = PX(60);
     const int MARGIN_BOT_T = PX(60);
 
-    const int BODY_X = int(off.x());
-    const int BODY_Y = int(off.y());
+    // Współrzędne lokalne: (0,0) = róg korpusu
+    const int BODY_X = 0;
+    const int BODY_Y = 0;
 
     const int col1X = BODY_X + PX(110);
     const int col2X = BODY_X + BODY_W / 2;
     const int col3X = BODY_X + BODY_W - PX(110);
 
-    // Korpus + tytuł
-    auto* body = m_scene->addRect(BODY_X, BODY_Y, BODY_W, BODY_H, penWire(1.8), QBrush(Qt::NoBrush));
-    m_items.push_back(body);
-
-    auto* title = addText(m_scene, m_prefix.left(m_prefix.size() - 1), QPointF(BODY_X + PX(6), BODY_Y - PX(22)), 1.0);
-    m_items.push_back(title);
-
-    const int midY = BODY_Y + BODY_H / 2;
-    m_items.push_back(createLine(QPointF(BODY_X, midY), QPointF(BODY_X + BODY_W, midY), Qt::DashLine));
-
     const int topY = BODY_Y - MARGIN_TOP_L;
     const int botY = BODY_Y + BODY_H + MARGIN_BOT_T;
 
-    // piony L i T
-    m_items.push_back(createLine(QPointF(col1X, topY), QPointF(col1X, BODY_Y)));
-    m_items.push_back(createLine(QPointF(col2X, topY), QPointF(col2X, BODY_Y)));
-    m_items.push_back(createLine(QPointF(col3X, topY), QPointF(col3X, BODY_Y)));
-    m_items.push_back(createLine(QPointF(col1X, BODY_Y + BODY_H), QPointF(col1X, botY)));
-    m_items.push_back(createLine(QPointF(col2X, BODY_Y + BODY_H), QPointF(col2X, botY)));
-    m_items.push_back(createLine(QPointF(col3X, BODY_Y + BODY_H), QPointF(col3X, botY)));
-
-    auto addContactEdge = [this](const QString& a, const QString& b, ContactKind kind) {
-        m_contactEdges.push_back({a, b, kind});
-    };
-
-    // Piny L1/L2/L3 u góry
-    const QString pL1 = m_prefix + "L1";
-    const QString pL2 = m_prefix + "L2";
-    const QString pL3 = m_prefix + "L3";
-    createTerminal(pL1, QPointF(col1X, topY));
-    createTerminal(pL2, QPointF(col2X, topY));
-    createTerminal(pL3, QPointF(col3X, topY));
-    m_items.push_back(addText(m_scene, "L1", QPointF(col1X - PX(8), topY - PX(26)), 1.0));
-    m_items.push_back(addText(m_scene, "L2", QPointF(col2X - PX(8), topY - PX(26)), 1.0));
-    m_items.push_back(addText(m_scene, "L3", QPointF(col3X - PX(8), topY - PX(26)), 1.0));
-
-    // Piny T1/T2/T3 na dole
-    const QString pT1 = m_prefix + "T1";
-    const QString pT2 = m_prefix + "T2";
-    const QString pT3 = m_prefix + "T3";
-    createTerminal(pT1, QPointF(col1X, botY));
-    createTerminal(pT2, QPointF(col2X, botY));
-    createTerminal(pT3, QPointF(col3X, botY));
-    m_items.push_back(addText(m_scene, "T1", QPointF(col1X - PX(10), botY + PX(10)), 1.0));
-    m_items.push_back(addText(m_scene, "T2", QPointF(col2X - PX(10), botY + PX(10)), 1.0));
-    m_items.push_back(addText(m_scene, "T3", QPointF(col3X - PX(10), botY + PX(10)), 1.0));
-
-    addContactEdge(pL1, pT1, ContactKind::NormallyOpen);
-    addContactEdge(pL2, pT2, ContactKind::NormallyOpen);
-    addContactEdge(pL3, pT3, ContactKind::NormallyOpen);
-
-    // Wejścia cewki A1/A2 z lewej + przyciski START/RET
     const int a1y    = BODY_Y + BODY_H / 2 - PX(60);
     const int a2y    = BODY_Y + BODY_H / 2 + PX(60);
     const int aLeftX = BODY_X - PX(90);
-    m_items.push_back(createLine(QPointF(aLeftX, a1y), QPointF(BODY_X, a1y)));
-    m_items.push_back(createLine(QPointF(aLeftX, a2y), QPointF(BODY_X, a2y)));
-
-    const QString pA1 = m_prefix + "A1";
-    const QString pA2 = m_prefix + "A2";
-    createTerminal(pA1, QPointF(aLeftX, a1y));
-    createTerminal(pA2, QPointF(aLeftX, a2y));
-    m_items.push_back(addText(m_scene, "A1", QPointF(aLeftX - PX(20), a1y - PX(26)), 1.0));
-    m_items.push_back(addText(m_scene, "A2", QPointF(aLeftX - PX(20), a2y - PX(26)), 1.0));
-
-    const QRectF rBtn1(aLeftX - PX(70), a1y - PX(12), PX(50), PX(24));
-    const QRectF rBtn2(aLeftX - PX(70), a2y - PX(12), PX(50), PX(24));
-    m_btnA1 = new SchematicButton(rBtn1, QStringLiteral("START"), nullptr, colPhase());
-    m_btnA2 = new SchematicButton(rBtn2, QStringLiteral("RET"),   nullptr, colNeutral());
-    m_scene->addItem(m_btnA1);
-    m_scene->addItem(m_btnA2);
-    m_items.push_back(m_btnA1);
-    m_items.push_back(m_btnA2);
-
-    connect(m_btnA1, &SchematicButton::toggled, this, [this, pA1](bool on) {
-        if (on)
-            emit requestAddPhase(pA1);
-        else
-            emit requestRemovePhase(pA1);
-    });
-    connect(m_btnA2, &SchematicButton::toggled, this, [this, pA2](bool on) {
-        if (on)
-            emit requestAddNeutral(pA2);
-        else
-            emit requestRemoveNeutral(pA2);
-    });
-
-    // Bloki opisowe i styki pomocnicze (LADC22)
-    const QRectF rLC(BODY_X + PX(20),           BODY_Y + PX(35), BODY_W / 2 - PX(85), BODY_H - PX(70));
+
+    const QRectF rLC(BODY_X + PX(20),             BODY_Y + PX(35), BODY_W / 2 - PX(85), BODY_H - PX(70));
     const QRectF rLA(BODY_X + BODY_W / 2 + PX(5), BODY_Y + PX(35), BODY_W / 2 - PX(20), BODY_H - PX(70));
-    m_items.push_back(m_scene->addRect(rLC, penBlock(1.6)));
-    m_items.push_back(m_scene->addRect(rLA, penBlock(1.6)));
-    m_items.push_back(addText(m_scene, "LC1D09", rLC.bottomLeft() + QPointF(PX(6), -PX(16)), 1.0));
-    m_items.push_back(addText(m_scene, "LADC22", rLA.bottomLeft() + QPointF(PX(6), -PX(16)), 1.0));
 
     const int auxGapV = PX(60);
     const int auxTopY = BODY_Y + PX(70);
 
-    auto addAux = [&](const QString& upper, const QString& lower, const QString& label, int pinOffset, int textOffset) {
-        createTerminal(upper, QPointF(int(rLA.left()) + PX(pinOffset), auxTopY));
-        createTerminal(lower, QPointF(int(rLA.left()) + PX(pinOffset), auxTopY + auxGapV));
-        m_items.push_back(addText(m_scene, label, QPointF(int(rLA.left()) + PX(textOffset), auxTopY - PX(24)), 0.9));
-    };
+    DeviceTemplate t;
 
-    auto addAuxEdge = [&](const QString& upper, const QString& lower, ContactKind kind) {
-        addContactEdge(upper, lower, kind);
+    // ---- Obrys: korpus, piony L/T, doprowadzenia cewki
+    t.addRect(QRectF(BODY_X, BODY_Y, BODY_W, BODY_H), penWire(1.8));
+    t.addLine(QPointF(col1X, topY), QPointF(col1X, BODY_Y), penWire(1.6));
+    t.addLine(QPointF(col2X, topY), QPointF(col2X, BODY_Y), penWire(1.6));
+    t.addLine(QPointF(col3X, topY), QPointF(col3X, BODY_Y), penWire(1.6));
+    t.addLine(QPointF(col1X, BODY_Y + BODY_H), QPointF(col1X, botY), penWire(1.6));
+    t.addLine(QPointF(col2X, BODY_Y + BODY_H), QPointF(col2X, botY), penWire(1.6));
+    t.addLine(QPointF(col3X, BODY_Y + BODY_H), QPointF(col3X, botY), penWire(1.6));
+    t.addLine(QPointF(aLeftX, a1y), QPointF(BODY_X, a1y), penWire(1.6));
+    t.addLine(QPointF(aLeftX, a2y), QPointF(BODY_X, a2y), penWire(1.6));
+
+    // ---- Detal: podział, bloki opisowe, etykiety
+    const int midY = BODY_Y + BODY_H / 2;
+    t.addLine(QPointF(BODY_X, midY), QPointF(BODY_X + BODY_W, midY), penWire(1.2, Qt::DashLine), Layer::Detail);
+    t.addRect(rLC, penBlock(1.6), Qt::NoBrush, Layer::Detail);
+    t.addRect(rLA, penBlock(1.6), Qt::NoBrush, Layer::Detail);
+
+    auto label = [&](const QString& text, const QPointF& pos, qreal scale) {
+        t.addLabel(text, pos, scale * SCALE_FACTOR, colText());
     };
+    label(QStringLiteral("L1"), QPointF(col1X - PX(8), topY - PX(26)), 1.0);
+    label(QStringLiteral("L2"), QPointF(col2X - PX(8), topY - PX(26)), 1.0);
+    label(QStringLiteral("L3"), QPointF(col3X - PX(8), topY - PX(26)), 1.0);
+    label(QStringLiteral("T1"), QPointF(col1X - PX(10), botY + PX(10)), 1.0);
+    label(QStringLiteral("T2"), QPointF(col2X - PX(10), botY + PX(10)), 1.0);
+    label(QStringLiteral("T3"), QPointF(col3X - PX(10), botY + PX(10)), 1.0);
+    label(QStringLiteral("A1"), QPointF(aLeftX - PX(20), a1y - PX(26)), 1.0);
+    label(QStringLiteral("A2"), QPointF(aLeftX - PX(20), a2y - PX(26)), 1.0);
+    label(QStringLiteral("LC1D09"), rLC.bottomLeft() + QPointF(PX(6), -PX(16)), 1.0);
+    label(QStringLiteral("LADC22"), rLA.bottomLeft() + QPointF(PX(6), -PX(16)), 1.0);
+
+    // Nazwa instancji („K1”) nad korpusem
+    t.titlePos   = QPointF(BODY_X + PX(6), BODY_Y - PX(22));
+    t.titleScale = SCALE_FACTOR;
+    t.titleColor = colText();
+
+    // ---- Piny i styki główne
+    const int pL1 = t.addPin(QStringLiteral("L1"), QPointF(col1X, topY));
+    const int pL2 = t.addPin(QStringLiteral("L2"), QPointF(col2X, topY));
+    const int pL3 = t.addPin(QStringLiteral("L3"), QPointF(col3X, topY));
+    const int pT1 = t.addPin(QStringLiteral("T1"), QPointF(col1X, botY));
+    const int pT2 = t.addPin(QStringLiteral("T2"), QPointF(col2X, botY));
+    const int pT3 = t.addPin(QStringLiteral("T3"), QPointF(col3X, botY));
+    t.contacts.push_back({pL1, pT1, true});
+    t.contacts.push_back({pL2, pT2, true});
+    t.contacts.push_back({pL3, pT3, true});
+
+    // ---- Cewka A1/A2 + przyciski START/RET
+    const int pA1 = t.addPin(QStringLiteral("A1"), QPointF(aLeftX, a1y));
+    const int pA2 = t.addPin(QStringLiteral("A2"), QPointF(aLeftX, a2y));
+    t.coilA = pA1;
+    t.coilB = pA2;
+    t.buttons.push_back({QRectF(aLeftX - PX(70), a1y - PX(12), PX(50), PX(24)), QStringLiteral("START"), colPhase(),   pA1, false});
+    t.buttons.push_back({QRectF(aLeftX - PX(70), a2y - PX(12), PX(50), PX(24)), QStringLiteral("RET"),   colNeutral(), pA2, true});
+
+    // ---- Styki pomocnicze (LADC22) — piny ukrywane przy małym powiększeniu
+    auto addAux = [&](const QString& upper, const QString& lower, const QString& text,
+                      int pinOffset, int textOffset, bool isNO) {
+        const int a = t.addPin(upper, QPointF(int(rLA.left()) + PX(pinOffset), auxTopY), true);
+        const int b = t.addPin(lower, QPointF(int(rLA.left()) + PX(pinOffset), auxTopY + auxGapV), true);
+        t.contacts.push_back({a, b, isNO});
+        t.addLabel(text, QPointF(int(rLA.left()) + PX(textOffset), auxTopY - PX(24)), 0.9 * SCALE_FACTOR, colText());
+    };
+    addAux(QStringLiteral("53"), QStringLiteral("54"), QStringLiteral("53 NO"), 20,  0,   true);
+    addAux(QStringLiteral("61"), QStringLiteral("62"), QStringLiteral("61 NC"), 70,  50,  false);
+    addAux(QStringLiteral("75"), QStringLiteral("76"), QStringLiteral("75 NC"), 120, 100, false);
+    addAux(QStringLiteral("87"), QStringLiteral("88"), QStringLiteral("87 NO"), 170, 150, true);
 
-    addAux(m_prefix + "53", m_prefix + "54", QStringLiteral("53 NO"), 20, 0);
-    addAuxEdge(m_prefix + "53", m_prefix + "54", ContactKind::NormallyOpen);
-    addAux(m_prefix + "61", m_prefix + "62", QStringLiteral("61 NC"), 70, 50);
-    addAuxEdge(m_prefix + "61", m_prefix + "62", ContactKind::NormallyClosed);
-    addAux(m_prefix + "75", m_prefix + "76", QStringLiteral("75 NC"), 120, 100);
-    addAuxEdge(m_prefix + "75", m_prefix + "76", ContactKind::NormallyClosed);
-    addAux(m_prefix + "87", m_prefix + "88", QStringLiteral("87 NO"), 170, 150);
-    addAuxEdge(m_prefix + "87", m_prefix + "88", ContactKind::NormallyOpen);
+    t.finish();
+    return t;
+}
+
+void Contactor_LC1D09_LADC22::build(const QPointF& off)
+{
+    const DeviceTemplate& tpl = *m_tpl;
+
+    m_items.reserve(1 + tpl.pins.size() + tpl.buttons.size());
+    m_pins.reserve(tpl.pins.size());
+    m_terminals.reserve(tpl.pins.size());
+
+    // Korpus: wskaźnik na wspólny szablon + nazwa instancji
+    m_body = new DeviceBodyItem(&tpl, m_prefix.left(m_prefix.size() - 1));
+    m_body->setPos(off);
+    m_body->setZValue(0.5);
+    m_scene->addItem(m_body);
+    m_items.push_back(m_body);
+
+    // Piny — stan instancji; nazwa pełna składana raz na pin
+    QVector<QString> names;
+    names.reserve(tpl.pins.size());
+    for (const DeviceTemplate::Pin& pin : tpl.pins) {
+        const QString name = m_prefix + pin.suffix;
+        auto* term = createTerminal(name, off + pin.pos);
+        if (pin.detail)
+            m_detailItems.push_back(term);
+        names.push_back(name);
+    }
+
+    m_contactEdges.reserve(tpl.contacts.size());
+    for (const DeviceTemplate::Contact& c : tpl.contacts) {
+        m_contactEdges.push_back({names[c.pinA], names[c.pinB],
+                                  c.normallyOpen ? ContactKind::NormallyOpen : ContactKind::NormallyClosed});
+    }
+
+    // Przyciski (START/RET) — drugi (i ostatni) stan instancji
+    for (const DeviceTemplate::Button& b : tpl.buttons) {
+        auto* btn = new SchematicButton(b.rect.translated(off), b.text, nullptr, b.onColor);
+        m_scene->addItem(btn);
+        m_items.push_back(btn);
+        m_buttons.push_back(btn);
+
+        const QString pin     = names[b.pin];
+        const bool    neutral = b.neutral;
+        m_buttonPins.push_back(qMakePair(pin, neutral));
+        connect(btn, &SchematicButton::toggled, this, [this, pin, neutral](bool on) {
+            if (neutral) {
+                if (on) emit requestAddNeutral(pin);
+                else    emit requestRemoveNeutral(pin);
+            } else {
+                if (on) emit requestAddPhase(pin);
+                else    emit requestRemovePhase(pin);
+            }
+        });
+    }
+}
+
+void Contactor_LC1D09_LADC22::syncButtons(const QSet<QString>& phase, const QSet<QString>& neutral)
+{
+    for (int i = 0; i < m_buttons.size(); ++i) {
+        const auto& bp = m_buttonPins[i];
+        m_buttons[i]->setOn(bp.second ? neutral.contains(bp.first) : phase.contains(bp.first));
+    }
 }
 
 QGraphicsEllipseItem* Contactor_LC1D09_LADC22::createTerminal(const QString& name, const QPointF& center)
 {
+    // pióro i pędzel współdzielone przez wszystkie zaciski (QPen/QBrush są współdzielone niejawnie)
+    static const QPen   pen = penWire(1.6);
+    static const QBrush brush(Qt::NoBrush);
     const int r = PX(10);
-    auto* ellipse = m_scene->addEllipse(center.x() - r, center.y() - r, 2 * r, 2 * r,
-                                        penWire(1.6), QBrush(Qt::NoBrush));
+    auto* ellipse = m_scene->addEllipse(center.x() - r, center.y() - r, 2 * r, 2 * r, pen, brush);
     ellipse->setToolTip(name);
     ellipse->setZValue(1.1);
 
@@ -260,12 +301,3 @@ QGraphicsEllipseItem* Contactor_LC1D09_LADC22::createTerminal(const QString& nam
     m_terminals.insert(name, ellipse);
     return ellipse;
 }
-
-QGraphicsLineItem* Contactor_LC1D09_LADC22::createLine(const QPointF& a, const QPointF& b, Qt::PenStyle style)
-{
-    QPen pen = (style == Qt::DashLine) ? penWire(1.2, Qt::DashLine) : penWire(1.6, style);
-    auto* line = m_scene->addLine(QLineF(a, b), pen);
-    line->setZValue(0.5);
-    return line;
-}
-
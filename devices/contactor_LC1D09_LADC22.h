@@ -14,11 +14,12 @@
 class QGraphicsScene;
 class QGraphicsItem;
 class QGraphicsEllipseItem;
-class QGraphicsLineItem;
 class QGraphicsSceneMouseEvent;
 class QPainter;
 class QStyleOptionGraphicsItem;
 class QWidget;
+class DeviceBodyItem;
+struct DeviceTemplate;
 
 // Prosty prostokątny przycisk sceniczny wykorzystywany przez bloki urządzeń.
 class SchematicButton : public QGraphicsObject {
@@ -37,7 +38,7 @@ signals:
     void toggled(bool on);
 
 protected:
-    void paint(QPainter* p, const QStyleOptionGraphicsItem*, QWidget*) override;
+    void paint(QPainter* p, const QStyleOptionGraphicsItem* opt, QWidget*) override;
     void mousePressEvent(QGraphicsSceneMouseEvent* e) override;
 
 private:
@@ -50,6 +51,10 @@ private:
 // Blok „Stycznik LC1D09 + przystawka LADC22”.
 // Rysuje korpus, piny L/T, A1/A2, styki pomocnicze oraz przyciski START/RET.
 // W pełni samodzielny — sam dodaje elementy graficzne do sceny.
+// Statyczna grafika (korpus, opisy) to jeden DeviceBodyItem wskazujący na
+// współdzielony szablon typu; instancja ma na własność tylko piny i przyciski.
+// Z szablonem typu z katalogu (DeviceLibrary) ten sam blok buduje dowolny
+// stycznik lub przekaźnik — całość opisu urządzenia siedzi w szablonie.
 class Contactor_LC1D09_LADC22 : public QObject {
     Q_OBJECT
 public:
@@ -68,12 +73,27 @@ public:
                             const QString& prefix,   // np. "K1_"
                             const QPointF& topLeft,
                             QObject* parent = nullptr);
+    Contactor_LC1D09_LADC22(QGraphicsScene* scene,
+                            const QString& prefix,
+                            const QPointF& topLeft,
+                            const DeviceTemplate& tpl,   // żyje do końca programu
+                            QObject* parent = nullptr);
 
     const QString& prefix() const { return m_prefix; }
     const QSet<QString>& pins() const { return m_pins; }
     const QVector<QGraphicsItem*>& items() const { return m_items; }
     const QHash<QString, QGraphicsEllipseItem*>& terminalItems() const { return m_terminals; }
     const QVector<ContactEdge>& contactEdges() const { return m_contactEdges; }
+    // Detale ukrywane przy małym powiększeniu (piny styków pomocniczych)
+    const QVector<QGraphicsItem*>& detailItems() const { return m_detailItems; }
+
+    // Stan przycisków START/RET według bieżących źródeł (bez emitowania sygnałów)
+    void syncButtons(const QSet<QString>& phase, const QSet<QString>& neutral);
+
+    // Wspólny (niezmienny) szablon LC1D09+LADC22 — budowany przy pierwszym użyciu
+    static const DeviceTemplate& deviceTemplate();
+    // Szablon, z którego zbudowano tę instancję
+    const DeviceTemplate& typeTemplate() const { return *m_tpl; }
 
 signals:
     // Forwardowane przez ContactorView do logiki okna
@@ -84,19 +104,22 @@ signals:
 
 private:
     void build(const QPointF& topLeft);
+    static DeviceTemplate buildTemplate();
     QGraphicsEllipseItem* createTerminal(const QString& name, const QPointF& center);
-    QGraphicsLineItem*    createLine(const QPointF& a, const QPointF& b, Qt::PenStyle style = Qt::SolidLine);
 
 private:
     QGraphicsScene* m_scene = nullptr;
     QString m_prefix; // "K1_"
+    const DeviceTemplate* m_tpl = nullptr;
 
     QVector<QGraphicsItem*> m_items; // wszystkie itemy graficzne (w tym elipsy pinów)
     QSet<QString>           m_pins;  // pełne nazwy pinów
     QHash<QString, QGraphicsEllipseItem*> m_terminals; // pin -> elipsa
     QVector<ContactEdge>    m_contactEdges; // połączenia styków
+    QVector<QGraphicsItem*> m_detailItems;  // piny LADC22 (LOD)
+    DeviceBodyItem*         m_body = nullptr;
 
-    // lokalne kontrolki
-    SchematicButton* m_btnA1 = nullptr;
-    SchematicButton* m_btnA2 = nullptr;
+    // lokalne kontrolki (START/RET)
+    QVector<SchematicButton*> m_buttons;
+    QVector<QPair<QString, bool>> m_buttonPins;   // pin sterowany przyciskiem, true = ZERO
 };
@@ -2,6 +2,12 @@
 #include "power_block.h"
 #include "contactor_LC1D09_LADC22.h"
 #include "motor_3phase_block.h"    // **NOWE**
+#include "device_body_item.h"
+#include "device_library.h"
+#include "device_template.h"
+#include "bridge_item.h"
+#include "tile_cache.h"
+#include "wire_router.h"
 
 #include <QGraphicsScene>
 #include <QGraphicsRectItem>
@@ -10,6 +16,8 @@
 #include <QGraphicsPathItem>
 #include <QGraphicsSimpleTextItem>
 #include <QPen>
+#include <QPainterPath>
+#include <QPolygonF>
 #include <QBrush>
 #include <QPainter>
 #include <QGraphicsSceneMouseEvent>
@@ -17,8 +25,13 @@
 #include <QContextMenuEvent>
 #include <QAction>
 #include <QMouseEvent>
+#include <QWheelEvent>
+#include <QScrollBar>
+#include <QTimer>
 #include <QCursor>
+#include <algorithm>
 #include <cmath>
+#include <utility>
 
 constexpr qreal S = 0.7;
 static inline int   PX(qreal v) { return int(std::lround(v * S)); }
@@ -35,6 +48,7 @@ QColor ContactorView::colOn()       { return QColor(53, 199, 89); }
 QColor ContactorView::colPhase()    { return QColor(220, 60, 60); }
 QColor ContactorView::colNeutral()  { return QColor(66, 133, 244); }
 QColor ContactorView::colFault()    { return QColor(255, 190, 0); }
+QColor ContactorView::colNet()      { return QColor(0, 220, 220); }
 
 QPen ContactorView::penWire(qreal w)  { QPen p(colWire());  p.setWidthF(w); return p; }
 QPen ContactorView::penBlock(qreal w) { QPen p(colBlock()); p.setWidthF(w); return p; }
@@ -48,10 +62,95 @@ ContactorView::ContactorView(QWidget* parent, bool buildDefault)
     setBackgroundBrush(colBg());
     setMouseTracking(true);
     if (viewport()) viewport()->setMouseTracking(true);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+
+    // Płótno startowe; rośnie razem z zawartością (growCanvas)
     m_scene->setSceneRect(0, 0, 5000, 3000);
+
+    // Statyczna grafika (korpusy, mostki) idzie do kafli renderowanych w tle
+    m_tiles = new TileCache([this](const QRectF& r){ return tileSnapshot(r); }, this);
+    connect(m_tiles, &TileCache::tileReady, this, [this](const QRectF& r){
+        if (viewport()) viewport()->update(mapFromScene(r).boundingRect().adjusted(-1, -1, 1, 1));
+    });
+
+    // Autotrasowanie mostków w tle
+    m_router = new WireRouter(this);
+    connect(m_router, &WireRouter::routed,   this, &ContactorView::onRouted);
+    connect(m_router, &WireRouter::finished, this, &ContactorView::autoRouteFinished);
+
+    // Po ostatnim ruchu kółkiem/przesunięciu wraca antialiasing
+    m_interactionTimer = new QTimer(this);
+    m_interactionTimer->setSingleShot(true);
+    m_interactionTimer->setInterval(INTERACTION_SETTLE_MS);
+    connect(m_interactionTimer, &QTimer::timeout, this, &ContactorView::endInteraction);
+
     if (buildDefault) buildScene();
 }
 
+// ---------- Zoom / przesuwanie / poziom detali ----------
+void ContactorView::beginInteraction() {
+    if (!m_interacting) {
+        m_interacting = true;
+        setRenderHint(QPainter::Antialiasing, false);
+    }
+    m_interactionTimer->start();
+}
+
+void ContactorView::endInteraction() {
+    if (m_panning) { m_interactionTimer->start(); return; }
+    m_interacting = false;
+    setRenderHint(QPainter::Antialiasing, true);
+
+    // Bufory korpusów w widocznym obszarze były rysowane bez AA — odśwież tylko je
+    const QRectF visible = mapToScene(viewport()->rect()).boundingRect();
+    for (QGraphicsItem* it : m_scene->items(visible)) {
+        if (it->cacheMode() != QGraphicsItem::NoCache) it->update();
+    }
+    viewport()->update();
+}
+
+qreal ContactorView::zoom() const {
+    return transform().m11();
+}
+
+QPointF ContactorView::viewCenter() const {
+    return mapToScene(viewport()->rect().center());
+}
+
+void ContactorView::setViewState(qreal zoom, const QPointF& center) {
+    const qreal z = qBound(ZOOM_MIN, zoom > 0.0 ? zoom : 1.0, ZOOM_MAX);
+    setTransform(QTransform::fromScale(z, z));
+    centerOn(center);
+    applyLod();
+}
+
+void ContactorView::applyLod() {
+    const bool detail = DeviceBodyItem::isDetailed(transform().m11());
+    if (detail == m_lodDetail) return;
+    m_lodDetail = detail;
+
+    // Etykiety i obrys rysuje sam DeviceBodyItem; tu tylko piny styków pomocniczych
+    for (auto* kb : std::as_const(m_contBlocks)) {
+        if (!kb) continue;
+        for (QGraphicsItem* it : kb->detailItems()) it->setVisible(detail);
+    }
+}
+
+void ContactorView::wheelEvent(QWheelEvent* e) {
+    const int delta = e->angleDelta().y();
+    if (delta == 0) { QGraphicsView::wheelEvent(e); return; }
+
+    const qreal current = transform().m11();
+    qreal factor = std::pow(ZOOM_STEP, delta / 120.0);
+    if (current * factor < ZOOM_MIN) factor = ZOOM_MIN / current;
+    if (current * factor > ZOOM_MAX) factor = ZOOM_MAX / current;
+
+    beginInteraction();
+    scale(factor, factor);
+    applyLod();
+    e->accept();
+}
+
 static QGraphicsSimpleTextItem* addText(QGraphicsScene* sc, const QString& t, const QPointF& pos, qreal scale = 1.0) {
     auto* it = sc->addSimpleText(t);
     it->setBrush(ContactorView::colText());
@@ -106,14 +205,31 @@ void ContactorView::registerAuxPair(const QString& id, const QString& upper, con
 }
 
 // ---------- RYSOWANIE: stycznik (Contactor_LC1D09_LADC22) ----------
-void ContactorView::drawSingleContactorAt(const QPointF& off, uint8_t idx) {
+void ContactorView::drawSingleContactorAt(const QPointF& off, int idx) {
     const QString K = QStringLiteral("K%1_").arg(idx);
+    m_placed.insert(K, PlacedDevice{ DeviceKind::Contactor, idx, off, {} });
+    drawContactorBlock(K, Contactor_LC1D09_LADC22::deviceTemplate(), off);
+}
+
+// ---------- RYSOWANIE: urządzenie z katalogu (ten sam blok, szablon z DeviceLibrary) ----------
+static QString catalogPrefix(const DeviceType& type, int idx) {
+    return type.prefix + QString::number(idx) + QLatin1Char('_');
+}
+
+void ContactorView::drawCatalogAt(const QPointF& off, const DeviceType& type, int idx) {
+    const QString K = catalogPrefix(type, idx);
+    m_placed.insert(K, PlacedDevice{ DeviceKind::Catalog, idx, off, type.id });
+    drawContactorBlock(K, type.tpl, off);
+}
 
-    auto* kb = new Contactor_LC1D09_LADC22(m_scene, K, off, this);
+void ContactorView::drawContactorBlock(const QString& K, const DeviceTemplate& tpl, const QPointF& off) {
+    auto* kb = new Contactor_LC1D09_LADC22(m_scene, K, off, tpl, this);
     if (!kb)
         return;
 
     m_contBlocks.insert(K, kb);
+    if (!m_lodDetail)
+        for (QGraphicsItem* it : kb->detailItems()) it->setVisible(false);
 
     auto& group = m_contactors[K];
     for (QGraphicsItem* it : kb->items()) {
@@ -131,6 +247,7 @@ void ContactorView::drawSingleContactorAt(const QPointF& off, uint8_t idx) {
     for (const QString& pin : kb->pins()) {
         group.pins.insert(pin);
     }
+    adoptStatic(group.items);
 
     // Forward sygnałów START/RET
     connect(kb, &Contactor_LC1D09_LADC22::requestAddPhase,      this, &ContactorView::addPhaseSourceRequested);
@@ -138,7 +255,16 @@ void ContactorView::drawSingleContactorAt(const QPointF& off, uint8_t idx) {
     connect(kb, &Contactor_LC1D09_LADC22::requestAddNeutral,    this, &ContactorView::addNeutralSourceRequested);
     connect(kb, &Contactor_LC1D09_LADC22::requestRemoveNeutral, this, &ContactorView::removeNeutralSourceRequested);
 
-    emit contactorPlaced(K);
+    if (m_bulkDepth > 0) m_bulkK << K;
+    else                 emit contactorPlaced(K);
+}
+
+// Przyciski START/RET/POWER pokazują stan źródeł (np. po wczytaniu projektu)
+void ContactorView::syncSourceButtons(const QSet<QString>& phase, const QSet<QString>& neutral) {
+    for (auto* kb : std::as_const(m_contBlocks))
+        if (kb) kb->syncButtons(phase, neutral);
+    for (auto* pb : std::as_const(m_powerBlocks))
+        if (pb) pb->syncButton(phase);
 }
 
 Contactor_LC1D09_LADC22* ContactorView::contactorBlock(const QString& prefix) const
@@ -146,33 +272,41 @@ Contactor_LC1D09_LADC22* ContactorView::contactorBlock(const QString& prefix) co
     return m_contBlocks.value(prefix, nullptr);
 }
 
+Motor3PhaseBlock* ContactorView::motorBlock(const QString& prefix) const
+{
+    return m_motorBlocks.value(prefix, nullptr);
+}
+
 // ---------- RYSOWANIE: blok zasilania 3F (PowerBlock) ----------
-void ContactorView::drawPower3At(const QPointF& off, uint8_t idx) {
+void ContactorView::drawPower3At(const QPointF& off, int idx) {
     const QString P = QStringLiteral("P%1_").arg(idx);
+    m_placed.insert(P, PlacedDevice{ DeviceKind::Power3, idx, off });
 
     // Na czas budowy — pozwól addTerminal/trackItem wpisać piny/itemy do grupy P
     m_buildingP = P; m_powers[P];
 
     auto addTerm = [this](const QString& n, const QPointF& c){ return this->addTerminal(n, c); };
-    auto addLine = [this](const QPointF& a, const QPointF& b){ return this->addLine("", a, b, Qt::SolidLine); };
     auto track   = [this](QGraphicsItem* it){ this->trackItem(it); };
 
-    auto* pb = new PowerBlock(m_scene, P, off, addTerm, addLine, track, this);
+    auto* pb = new PowerBlock(m_scene, P, off, addTerm, track, this);
 
     // Po zbudowaniu — koniec trybu
     m_buildingP.clear();
+    adoptStatic(m_powers[P].items);
 
     // Forward przycisku POWER
     m_powerBlocks.insert(P, pb);
     connect(pb, &PowerBlock::requestAddPhase,    this, &ContactorView::addPhaseSourceRequested);
     connect(pb, &PowerBlock::requestRemovePhase, this, &ContactorView::removePhaseSourceRequested);
 
-    emit powerPlaced(P);
+    if (m_bulkDepth > 0) m_bulkP << P;
+    else                 emit powerPlaced(P);
 }
 
 // ---------- RYSOWANIE: silnik 3F (Motor3PhaseBlock) ----------
-void ContactorView::drawMotorAt(const QPointF& off, uint8_t idx) {
+void ContactorView::drawMotorAt(const QPointF& off, int idx) {
     const QString M = QStringLiteral("M%1_").arg(idx);
+    m_placed.insert(M, PlacedDevice{ DeviceKind::Motor3, idx, off });
 
     // Dedykowane trackowanie do map „M”
     m_motors[M];
@@ -203,6 +337,10 @@ void ContactorView::drawMotorAt(const QPointF& off, uint8_t idx) {
     }
 
     m_motorBlocks.insert(M, mb);
+    adoptStatic(group.items);
+
+    if (m_bulkDepth > 0) m_bulkM << M;
+    else                 emit motorPlaced(M);
 }
 
 void ContactorView::buildScene() {}
@@ -260,126 +398,404 @@ QPointF ContactorView::terminalPos(const QString& name) const {
 QGraphicsPathItem* ContactorView::addBridgePolyline(const QVector<QPointF>& pts) {
     if (pts.size() < 2 || !m_scene) return nullptr;
     QPainterPath ph(pts.front()); for (int i = 1; i < pts.size(); ++i) ph.lineTo(pts[i]);
-    auto* item = m_scene->addPath(ph, penWire(2.2));
+    auto* item = new BridgeItem(ph);
+    item->setPen(penWire(2.2));
     item->setZValue(1.2);
     item->setAcceptedMouseButtons(Qt::RightButton);
-    m_bridges.push_back(item);
+    m_scene->addItem(item);
+    item->setTiled(true);
+    m_bridges.insert(item);
+    staticChanged(item->sceneBoundingRect());
     return item;
 }
 void ContactorView::registerBridge(QGraphicsPathItem* item, const QString& aPin, const QString& bPin) {
     if (!item) return; m_bridgeToPins.insert(item, qMakePair(aPin, bPin));
+    m_bridgesByPin[aPin].push_back(item);
+    if (bPin != aPin) m_bridgesByPin[bPin].push_back(item);
 }
 void ContactorView::removeBridgeItem(QGraphicsPathItem* item) {
-    if (!item) return; m_bridgeToPins.remove(item); m_bridges.removeOne(item);
+    if (!item) return;
+    auto unlink = [&](const QString& pin){
+        auto it = m_bridgesByPin.find(pin);
+        if (it == m_bridgesByPin.end()) return;
+        it->removeOne(item);
+        if (it->isEmpty()) m_bridgesByPin.erase(it);
+    };
+    const auto pr = m_bridgeToPins.take(item);
+    unlink(pr.first); unlink(pr.second);
+    m_bridges.remove(item);
+    staticChanged(item->sceneBoundingRect());
     if (m_scene) m_scene->removeItem(item); delete item;
 }
 
-// Tryby wstawiania
-void ContactorView::beginPlaceContactor() {
+void ContactorView::removeBridge(const QString& aPin, const QString& bPin) {
+    for (QGraphicsPathItem* item : m_bridgesByPin.value(aPin)) {
+        const auto pr = m_bridgeToPins.value(item);
+        if ((pr.first == aPin && pr.second == bPin) || (pr.first == bPin && pr.second == aPin)) {
+            removeBridgeItem(item);
+            return;
+        }
+    }
+}
+
+bool ContactorView::hasBridge(const QString& aPin, const QString& bPin) const {
+    for (QGraphicsPathItem* item : m_bridgesByPin.value(aPin)) {
+        const auto pr = m_bridgeToPins.value(item);
+        if ((pr.first == aPin && pr.second == bPin) || (pr.first == bPin && pr.second == aPin))
+            return true;
+    }
+    return false;
+}
+
+QVector<QPointF> ContactorView::bridgePoints(const QString& aPin, const QString& bPin) const {
+    for (QGraphicsPathItem* item : m_bridgesByPin.value(aPin)) {
+        const auto pr = m_bridgeToPins.value(item);
+        if (!((pr.first == aPin && pr.second == bPin) || (pr.first == bPin && pr.second == aPin)))
+            continue;
+        const QList<QPolygonF> polys = item->path().toSubpathPolygons();
+        if (polys.isEmpty()) return {};
+        const QPolygonF  poly = item->mapToScene(polys.front());
+        QVector<QPointF> pts(poly.cbegin(), poly.cend());
+        if (pr.first != aPin) std::reverse(pts.begin(), pts.end());   // od aPin do bPin
+        return pts;
+    }
+    return {};
+}
+
+// Kółka pinów i mostki sieci w jednej ścieżce; mostek dodawany od swojego pierwszego pinu
+void ContactorView::highlightNet(const QStringList& pins) {
     if (!m_scene) return;
-    m_placeContactor = true; m_placePower3 = false; m_placeMotor3 = false;
+    QPainterPath path;
+    const QSet<QString> net(pins.cbegin(), pins.cend());
+    for (const QString& pin : pins) {
+        if (auto* e = m_terms.value(pin, nullptr))
+            path.addEllipse(e->sceneBoundingRect());
+        for (QGraphicsPathItem* item : m_bridgesByPin.value(pin)) {
+            const auto pr = m_bridgeToPins.value(item);
+            if (pr.first == pin && net.contains(pr.second))
+                path.addPath(item->mapToScene(item->path()));
+        }
+    }
+    if (!m_netMark) {
+        QPen pen(colNet(), 4.0);
+        pen.setCosmetic(true);
+        m_netMark = m_scene->addPath(QPainterPath(), pen);
+        m_netMark->setZValue(2.5);
+        m_netMark->setOpacity(0.8);
+        m_netMark->setAcceptedMouseButtons(Qt::NoButton);
+    }
+    m_netMark->setPath(path);
+}
 
-    const int BODY_W        = PX(420);
-    const int BODY_H        = PX(320);
-    const int MARGIN_TOP_L  = PX(60);
-    const int MARGIN_BOT_T  = PX(60);
-    const int W = BODY_W + PX(140);
-    const int H = BODY_H + MARGIN_TOP_L + MARGIN_BOT_T + PX(40);
+void ContactorView::clearNetHighlight() {
+    if (!m_netMark) return;
+    if (m_scene) m_scene->removeItem(m_netMark);
+    delete m_netMark;
+    m_netMark = nullptr;
+}
+
+void ContactorView::setDrcMarkers(const QStringList& pins) {
+    if (!m_scene) return;
+    QPainterPath path;
+    for (const QString& pin : pins)
+        if (auto* e = m_terms.value(pin, nullptr)) {
+            const QRectF r = e->sceneBoundingRect();
+            path.addRect(r.adjusted(-r.width() * 0.4, -r.height() * 0.4, r.width() * 0.4, r.height() * 0.4));
+        }
+    if (path.isEmpty()) {
+        if (m_drcMark) m_scene->removeItem(m_drcMark);
+        delete m_drcMark;
+        m_drcMark = nullptr;
+        return;
+    }
+    if (!m_drcMark) {
+        QPen pen(colFault(), 2.0, Qt::DashLine);
+        pen.setCosmetic(true);
+        m_drcMark = m_scene->addPath(QPainterPath(), pen);
+        m_drcMark->setZValue(2.6);
+        m_drcMark->setAcceptedMouseButtons(Qt::NoButton);
+    }
+    m_drcMark->setPath(path);
+}
+
+// Mostki zaczepione do pinów urządzenia — z indeksu pinów, bez skanowania wszystkich
+void ContactorView::removeBridgesAt(const QSet<QString>& pins) {
+    for (const QString& pin : pins) {
+        while (m_bridgesByPin.contains(pin))
+            removeBridgeItem(m_bridgesByPin.value(pin).last());
+    }
+}
 
+// Tryby wstawiania
+void ContactorView::showGhost(const QRectF& rect) {
     if (!m_contGhost) {
-        m_contGhost = m_scene->addRect(0, 0, W, H, penDash(1.6), QBrush(Qt::NoBrush));
+        m_contGhost = m_scene->addRect(rect, penDash(1.6), QBrush(Qt::NoBrush));
         m_contGhost->setZValue(3.0);
     } else {
-        m_contGhost->setRect(0, 0, W, H);
+        m_contGhost->setRect(rect);
         m_contGhost->setVisible(true);
     }
 
     const qreal grid = 10.0;
     QPointF sp = mapToScene(mapFromGlobal(QCursor::pos()));
     sp = snapPt(sp, grid);
-    m_contGhost->setPos(sp - QPointF(W/2.0, H/2.0));
+    m_contGhost->setPos(sp - QPointF(rect.width()/2.0, rect.height()/2.0));
 
     setCursor(Qt::CrossCursor);
     setMouseTracking(true);
     if (viewport()) viewport()->setMouseTracking(true);
 }
 
+void ContactorView::beginPlaceContactor() {
+    if (!m_scene) return;
+    m_placeContactor = true; m_placePower3 = false; m_placeMotor3 = false; m_placeType.clear();
+    m_arrayRows = m_arrayCols = 1;
+
+    const int BODY_W        = PX(420);
+    const int BODY_H        = PX(320);
+    const int MARGIN_TOP_L  = PX(60);
+    const int MARGIN_BOT_T  = PX(60);
+    const int W = BODY_W + PX(140);
+    const int H = BODY_H + MARGIN_TOP_L + MARGIN_BOT_T + PX(40);
+
+    showGhost(QRectF(0, 0, W, H));
+}
+
 void ContactorView::beginPlacePower3() {
     if (!m_scene) return;
-    m_placePower3 = true; m_placeContactor = false; m_placeMotor3 = false;
+    m_placePower3 = true; m_placeContactor = false; m_placeMotor3 = false; m_placeType.clear();
+    m_arrayRows = m_arrayCols = 1;
 
     const int W = PX(260);
     const int H = PX(170);
-    if (!m_contGhost) {
-        m_contGhost = m_scene->addRect(0, 0, W, H, penDash(1.6), QBrush(Qt::NoBrush));
-        m_contGhost->setZValue(3.0);
-    } else {
-        m_contGhost->setRect(0, 0, W, H);
-        m_contGhost->setVisible(true);
-    }
-
-    const qreal grid = 10.0;
-    QPointF sp = mapToScene(mapFromGlobal(QCursor::pos()));
-    sp = snapPt(sp, grid);
-    m_contGhost->setPos(sp - QPointF(W/2.0, H/2.0));
-
-    setCursor(Qt::CrossCursor);
-    setMouseTracking(true);
-    if (viewport()) viewport()->setMouseTracking(true);
+    showGhost(QRectF(0, 0, W, H));
 }
 
 void ContactorView::beginPlaceMotor3() {
     if (!m_scene) return;
-    m_placeMotor3 = true; m_placeContactor = false; m_placePower3 = false;
+    m_placeMotor3 = true; m_placeContactor = false; m_placePower3 = false; m_placeType.clear();
+    m_arrayRows = m_arrayCols = 1;
 
     const int W = PX(220);
     const int H = PX(180);
-    if (!m_contGhost) {
-        m_contGhost = m_scene->addRect(0, 0, W, H, penDash(1.6), QBrush(Qt::NoBrush));
-        m_contGhost->setZValue(3.0);
-    } else {
-        m_contGhost->setRect(0, 0, W, H);
-        m_contGhost->setVisible(true);
+    showGhost(QRectF(0, 0, W, H));
+}
+
+void ContactorView::beginPlaceCatalog(const QString& type) {
+    const DeviceType* t = DeviceLibrary::instance().find(type);
+    if (!m_scene || !t) return;
+    m_placeContactor = m_placePower3 = m_placeMotor3 = false;
+    m_placeType = type;
+    m_arrayRows = m_arrayCols = 1;
+
+    showGhost(QRectF(QPointF(0, 0), t->tpl.footprint(PX(10)).size()));
+}
+
+// ---------- Wstawianie hurtowe ----------
+QRectF ContactorView::deviceFootprint(DeviceKind kind, const QString& type) {
+    switch (kind) {
+    case DeviceKind::Contactor: return Contactor_LC1D09_LADC22::deviceTemplate().footprint(PX(10));
+    case DeviceKind::Power3:    return PowerBlock::deviceTemplate().footprint(PX(10));
+    case DeviceKind::Motor3:    return Motor3PhaseBlock::deviceTemplate().footprint(8.0);
+    case DeviceKind::Catalog:
+        if (const DeviceType* t = DeviceLibrary::instance().find(type)) return t->tpl.footprint(PX(10));
+        break;
     }
+    return {};
+}
 
-    const qreal grid = 10.0;
-    QPointF sp = mapToScene(mapFromGlobal(QCursor::pos()));
-    sp = snapPt(sp, grid);
-    m_contGhost->setPos(sp - QPointF(W/2.0, H/2.0));
+QSizeF ContactorView::devicePitch(DeviceKind kind, const QString& type) {
+    const qreal gap = PX(60);
+    return deviceFootprint(kind, type).size() + QSizeF(gap, gap);
+}
 
-    setCursor(Qt::CrossCursor);
-    setMouseTracking(true);
-    if (viewport()) viewport()->setMouseTracking(true);
+// Typy katalogu z prefiksem K dzielą numerację ze stycznikiem wbudowanym
+int& ContactorView::nextIndex(DeviceKind kind, const QString& type) {
+    switch (kind) {
+    case DeviceKind::Contactor: return m_nextK;
+    case DeviceKind::Power3:    return m_nextP;
+    case DeviceKind::Motor3:    return m_nextM;
+    case DeviceKind::Catalog:   break;
+    }
+    const DeviceType* t = DeviceLibrary::instance().find(type);
+    if (!t || t->prefix == QLatin1String("K")) return m_nextK;
+    auto it = m_nextByPrefix.find(t->prefix);
+    if (it == m_nextByPrefix.end()) it = m_nextByPrefix.insert(t->prefix, 1);
+    return it.value();
+}
+
+QString ContactorView::placeDeviceAt(DeviceKind kind, int index, const QPointF& topLeft, const QString& type) {
+    if (!m_scene || index <= 0) return {};
+    switch (kind) {
+    case DeviceKind::Contactor:
+        if (m_contBlocks.contains(QStringLiteral("K%1_").arg(index))) return {};
+        m_nextK = qMax(m_nextK, index + 1); drawSingleContactorAt(topLeft, index);
+        return QStringLiteral("K%1_").arg(index);
+    case DeviceKind::Power3:
+        if (m_powerBlocks.contains(QStringLiteral("P%1_").arg(index))) return {};
+        m_nextP = qMax(m_nextP, index + 1); drawPower3At(topLeft, index);
+        return QStringLiteral("P%1_").arg(index);
+    case DeviceKind::Motor3:
+        if (m_motorBlocks.contains(QStringLiteral("M%1_").arg(index))) return {};
+        m_nextM = qMax(m_nextM, index + 1); drawMotorAt(topLeft, index);
+        return QStringLiteral("M%1_").arg(index);
+    case DeviceKind::Catalog: {
+        const DeviceType* t = DeviceLibrary::instance().find(type);
+        if (!t || m_contBlocks.contains(catalogPrefix(*t, index))) return {};
+        int& next = nextIndex(kind, type);
+        next = qMax(next, index + 1); drawCatalogAt(topLeft, *t, index);
+        return catalogPrefix(*t, index);
+    }
+    }
+    return {};
+}
+
+// Wczytywanie porcjami: nowe urządzenia użytkownika nie mogą zająć numerów,
+// których grafika jeszcze nie powstała
+void ContactorView::reserveDeviceIndex(DeviceKind kind, int index, const QString& type) {
+    if (kind == DeviceKind::Catalog && !DeviceLibrary::instance().find(type)) return;
+    int& next = nextIndex(kind, type);
+    next = qMax(next, index + 1);
+}
+
+QVector<ContactorView::PlacedDevice> ContactorView::placedDevices() const {
+    QVector<PlacedDevice> out;
+    out.reserve(m_placed.size());
+    for (const PlacedDevice& d : m_placed) out.push_back(d);
+    return out;
+}
+
+QString ContactorView::placeOne(DeviceKind kind, const QPointF& topLeft, const QString& type) {
+    switch (kind) {
+    case DeviceKind::Contactor: { const int idx = m_nextK++; drawSingleContactorAt(topLeft, idx); return QStringLiteral("K%1_").arg(idx); }
+    case DeviceKind::Power3:    { const int idx = m_nextP++; drawPower3At(topLeft, idx);          return QStringLiteral("P%1_").arg(idx); }
+    case DeviceKind::Motor3:    { const int idx = m_nextM++; drawMotorAt(topLeft, idx);           return QStringLiteral("M%1_").arg(idx); }
+    case DeviceKind::Catalog: {
+        const DeviceType* t = DeviceLibrary::instance().find(type);
+        if (!t) return {};
+        const int idx = nextIndex(kind, type)++;
+        drawCatalogAt(topLeft, *t, idx);
+        return catalogPrefix(*t, idx);
+    }
+    }
+    return {};
+}
+
+void ContactorView::beginBulk() {
+    ++m_bulkDepth;
+}
+
+void ContactorView::endBulk() {
+    if (m_bulkDepth == 0 || --m_bulkDepth > 0) return;
+
+    // jedno unieważnienie kafli i jeden sygnał na całą transakcję
+    staticChanged(m_bulkDirty);
+    m_bulkDirty = QRectF();
+
+    const QStringList ks = std::exchange(m_bulkK, {});
+    const QStringList ps = std::exchange(m_bulkP, {});
+    const QStringList ms = std::exchange(m_bulkM, {});
+    if (!ks.isEmpty()) emit contactorsPlaced(ks);
+    if (!ps.isEmpty()) emit powersPlaced(ps);
+    if (!ms.isEmpty()) emit motorsPlaced(ms);
+}
+
+QStringList ContactorView::placeDevices(DeviceKind kind, const QVector<QPointF>& topLefts, const QString& type) {
+    QStringList out;
+    if (!m_scene || topLefts.isEmpty()) return out;
+    out.reserve(topLefts.size());
+
+    beginBulk();
+    for (const QPointF& p : topLefts) out << placeOne(kind, p, type);
+    endBulk();
+    return out;
+}
+
+QStringList ContactorView::placeDeviceArray(DeviceKind kind, const QPointF& topLeft, int rows, int cols,
+                                            const QString& type) {
+    if (rows <= 0 || cols <= 0) return {};
+    const QSizeF pitch = devicePitch(kind, type);
+    QVector<QPointF> pts;
+    pts.reserve(rows * cols);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+            pts.push_back(topLeft + QPointF(c * pitch.width(), r * pitch.height()));
+    return placeDevices(kind, pts, type);
+}
+
+void ContactorView::beginPlaceArray(DeviceKind kind, int rows, int cols, const QString& type) {
+    switch (kind) {
+    case DeviceKind::Contactor: beginPlaceContactor();     break;
+    case DeviceKind::Power3:    beginPlacePower3();        break;
+    case DeviceKind::Motor3:    beginPlaceMotor3();        break;
+    case DeviceKind::Catalog:   beginPlaceCatalog(type);   break;
+    }
+    if (!m_scene) return;
+    m_arrayRows = qMax(1, rows);
+    m_arrayCols = qMax(1, cols);
+
+    // Duch obejmuje całą tablicę (obszary urządzeń z zaciskami i przyciskami)
+    const QSizeF pitch = devicePitch(kind, type);
+    const QSizeF fp    = deviceFootprint(kind, type).size();
+    const qreal  W = (m_arrayCols - 1) * pitch.width()  + fp.width();
+    const qreal  H = (m_arrayRows - 1) * pitch.height() + fp.height();
+    showGhost(QRectF(0, 0, W, H));
 }
 
 void ContactorView::mouseMoveEvent(QMouseEvent* e) {
-    if ((m_placeContactor || m_placePower3 || m_placeMotor3) && m_contGhost) {
+    if (m_panning) {
+        const QPoint d = e->pos() - m_panLast;
+        m_panLast = e->pos();
+        // płótno bez granic: przesuwanie przy krawędzi poszerza scenę
+        growCanvas(mapToScene(viewport()->rect().translated(-d)).boundingRect());
+        horizontalScrollBar()->setValue(horizontalScrollBar()->value() - d.x());
+        verticalScrollBar()->setValue(verticalScrollBar()->value() - d.y());
+        beginInteraction();
+        e->accept();
+        return;
+    }
+    if (isPlacing() && m_contGhost) {
         const qreal grid = 10.0;
         QPointF sp = mapToScene(e->pos());
         sp = snapPt(sp, grid);
         QRectF r = m_contGhost->rect();
         m_contGhost->setPos(sp - QPointF(r.width()/2, r.height()/2));
+        growCanvas(m_contGhost->sceneBoundingRect());
     }
     QGraphicsView::mouseMoveEvent(e);
 }
 void ContactorView::mousePressEvent(QMouseEvent* e) {
-    if ((m_placeContactor || m_placePower3 || m_placeMotor3) && e->button() == Qt::LeftButton) {
+    if (e->button() == Qt::MiddleButton) {
+        m_panning = true;
+        m_panLast = e->pos();
+        viewport()->setCursor(Qt::ClosedHandCursor);
+        beginInteraction();
+        e->accept();
+        return;
+    }
+    if (isPlacing() && e->button() == Qt::LeftButton) {
         const qreal grid = 10.0;
         QPointF sp = mapToScene(e->pos());
         sp = snapPt(sp, grid);
         const QSizeF  gs = m_contGhost ? m_contGhost->rect().size() : QSizeF(0,0);
         const QPointF pos = sp - QPointF(gs.width()/2.0, gs.height()/2.0);
 
-        if (m_placeContactor) {
-            const uint8_t idx = m_nextK; drawSingleContactorAt(pos, idx); if (m_nextK < 255) m_nextK++;
-        } else if (m_placePower3) {
-            const uint8_t idx = m_nextP; drawPower3At(pos, idx); if (m_nextP < 255) m_nextP++;
-        } else if (m_placeMotor3) {
-            const uint8_t idx = m_nextM; drawMotorAt(pos, idx);   if (m_nextM < 255) m_nextM++;
+        const QString    type = m_placeType;
+        const DeviceKind kind = !type.isEmpty()  ? DeviceKind::Catalog
+                              : m_placeContactor ? DeviceKind::Contactor
+                              : m_placePower3    ? DeviceKind::Power3
+                                                 : DeviceKind::Motor3;
+        if (m_arrayRows * m_arrayCols > 1) {
+            // duch tablicy zaczyna się w rogu obszaru pierwszego urządzenia
+            placeDeviceArray(kind, pos - deviceFootprint(kind, type).topLeft(), m_arrayRows, m_arrayCols, type);
+        } else {
+            placeOne(kind, pos, type);
         }
+        m_arrayRows = m_arrayCols = 1;
 
         if (m_contGhost) m_contGhost->setVisible(false);
         m_placeContactor = m_placePower3 = m_placeMotor3 = false;
+        m_placeType.clear();
         unsetCursor();
         e->accept();
         return;
@@ -387,10 +803,22 @@ void ContactorView::mousePressEvent(QMouseEvent* e) {
     QGraphicsView::mousePressEvent(e);
 }
 
+void ContactorView::mouseReleaseEvent(QMouseEvent* e) {
+    if (m_panning && e->button() == Qt::MiddleButton) {
+        m_panning = false;
+        viewport()->unsetCursor();
+        e->accept();
+        return;
+    }
+    QGraphicsView::mouseReleaseEvent(e);
+}
+
 // PPM
 void ContactorView::contextMenuEvent(QContextMenuEvent* e) {
-    QGraphicsItem* item = itemAt(e->pos());
-    if (!item) return;
+    QGraphicsItem* item = nullptr;
+    for (QGraphicsItem* it : items(e->pos()))      // nakładki (sieć, DRC) nie zasłaniają pinów
+        if (it != m_netMark && it != m_drcMark) { item = it; break; }
+    if (!item && !m_netMark) return;      // puste miejsce: tylko wyłączenie podświetlenia
 
     // Jeśli klik na mostek — menu mostka
     if (auto* path = qgraphicsitem_cast<QGraphicsPathItem*>(item)) {
@@ -422,26 +850,41 @@ void ContactorView::contextMenuEvent(QContextMenuEvent* e) {
     QAction* addN = nullptr;
     QAction* remF = nullptr;
     QAction* remN = nullptr;
+    QAction* feed = nullptr;
+    QAction* net = nullptr;
+    QAction* netOff = nullptr;
     if (!pinName.isEmpty()) {
         addF = menu.addAction("Dodaj źródło: FAZA");
         addN = menu.addAction("Dodaj źródło: ZERO");
         remF = menu.addAction("Usuń źródło: FAZA");
         remN = menu.addAction("Usuń źródło: ZERO");
-        menu.addSeparator();
+        feed = menu.addAction("Skąd zasilanie?");
+        net  = menu.addAction("Podświetl sieć");
     }
+    if (m_netMark) netOff = menu.addAction("Wyłącz podświetlenie sieci");
+    if (!menu.isEmpty()) menu.addSeparator();
     QAction* delK = nullptr;
     QAction* delP = nullptr;
     QAction* delM = nullptr;  // **NOWE**
+    QAction* resM = nullptr;
+    QAction* loadM = nullptr;
     if (!kPrefix.isEmpty()) {
-        delK = menu.addAction(QStringLiteral("Usuń stycznik %1").arg(kPrefix.left(kPrefix.size()-1)));
+        const PlacedDevice kd = m_placed.value(kPrefix);
+        if (kd.kind == DeviceKind::Catalog)
+            delK = menu.addAction(QStringLiteral("Usuń %1 (%2)").arg(kPrefix.left(kPrefix.size()-1), kd.type));
+        else
+            delK = menu.addAction(QStringLiteral("Usuń stycznik %1").arg(kPrefix.left(kPrefix.size()-1)));
     }
     if (!pPrefix.isEmpty()) {
         delP = menu.addAction(QStringLiteral("Usuń zasilanie %1").arg(pPrefix.left(pPrefix.size()-1)));
     }
     if (!mPrefix.isEmpty()) {
-        delM = menu.addAction(QStringLiteral("Usuń silnik %1").arg(mPrefix.left(mPrefix.size()-1)));
+        resM  = menu.addAction(QStringLiteral("Kasuj przekaźnik F (%1)").arg(mPrefix.left(mPrefix.size()-1)));
+        loadM = menu.addAction(QStringLiteral("Obciążenie i klasa F…"));
+        delM  = menu.addAction(QStringLiteral("Usuń silnik %1").arg(mPrefix.left(mPrefix.size()-1)));
     }
 
+    if (menu.isEmpty()) return;
     QAction* chosen = menu.exec(e->globalPos());
     if (!chosen) return;
 
@@ -449,9 +892,14 @@ void ContactorView::contextMenuEvent(QContextMenuEvent* e) {
     else if (chosen == addN) emit addNeutralSourceRequested(pinName);
     else if (chosen == remF) emit removePhaseSourceRequested(pinName);
     else if (chosen == remN) emit removeNeutralSourceRequested(pinName);
+    else if (chosen == feed) emit feedQueryRequested(pinName);
+    else if (chosen == net) emit netHighlightRequested(pinName);
+    else if (chosen == netOff) emit netHighlightRequested(QString());
     else if (chosen == delK) emit contactorDeleteRequested(kPrefix);
     else if (chosen == delP) emit powerDeleteRequested(pPrefix);
-    else if (chosen == delM) removeMotor(mPrefix);  // **NOWE**
+    else if (chosen == delM) emit motorDeleteRequested(mPrefix);
+    else if (chosen == resM) emit motorResetRequested(mPrefix);
+    else if (chosen == loadM) emit motorLoadRequested(mPrefix);
 }
 
 // --- usuwanie z widoku ---
@@ -459,17 +907,11 @@ void ContactorView::removeContactor(const QString& kPrefix) {
     if (!m_contactors.contains(kPrefix)) return;
 
     // Usuń mostki związane z tym K
-    QList<QGraphicsPathItem*> toRemove;
-    for (auto it = m_bridgeToPins.begin(); it != m_bridgeToPins.end(); ++it) {
-        const auto& pr = it.value();
-        if (pr.first.startsWith(kPrefix) || pr.second.startsWith(kPrefix)) {
-            toRemove.push_back(it.key());
-        }
-    }
-    for (auto* p : toRemove) removeBridgeItem(p);
+    removeBridgesAt(m_contactors.value(kPrefix).pins);
 
     // Usuń itemy graficzne
     auto grp = m_contactors.take(kPrefix);
+    staticChanged(boundsOf(grp.items));
     for (auto* it : std::as_const(grp.items)) {
         m_itemToK.remove(it);
         if (m_scene) m_scene->removeItem(it);
@@ -483,6 +925,7 @@ void ContactorView::removeContactor(const QString& kPrefix) {
 
     // porządek: usuń obiekt stycznika, jeśli był śledzony
     if (auto* cb = m_contBlocks.take(kPrefix)) delete cb;
+    m_placed.remove(kPrefix);
 }
 
 void ContactorView::removePowerBlock(const QString& pPrefix) {
@@ -490,14 +933,7 @@ void ContactorView::removePowerBlock(const QString& pPrefix) {
     if (!pb) return;
 
     // 1) Usuń mostki związane z pinami tego bloku
-    QList<QGraphicsPathItem*> toRemove;
-    for (auto it = m_bridgeToPins.begin(); it != m_bridgeToPins.end(); ++it) {
-        const auto& pr = it.value();
-        if (pr.first.startsWith(pPrefix) || pr.second.startsWith(pPrefix)) {
-            toRemove.push_back(it.key());
-        }
-    }
-    for (auto* p : toRemove) removeBridgeItem(p);
+    removeBridgesAt(m_powers.value(pPrefix).pins);
 
     // 2) Wyczyść mapy pinów (NIE dotykamy już sceny dla elips — będą skasowane w kroku 3)
     for (const QString& pin : m_powers[pPrefix].pins) {
@@ -506,6 +942,7 @@ void ContactorView::removePowerBlock(const QString& pPrefix) {
     }
 
     // 3) Usuń elementy graficzne JEDEN raz (w tym elipsy pinów, bo są w items())
+    staticChanged(boundsOf(m_powers[pPrefix].items));
     for (auto* it : m_powers[pPrefix].items) {
         m_itemToP.remove(it);
         if (it && it->scene() == m_scene) {
@@ -516,20 +953,14 @@ void ContactorView::removePowerBlock(const QString& pPrefix) {
 
     m_powers.remove(pPrefix);
     if (auto* pbObj = m_powerBlocks.take(pPrefix)) delete pbObj;
+    m_placed.remove(pPrefix);
 }
 
 void ContactorView::removeMotor(const QString& mPrefix) {
     if (!m_motors.contains(mPrefix)) return;
 
     // Usuń mostki zaczepione do pinów tego silnika
-    QList<QGraphicsPathItem*> toRemove;
-    for (auto it = m_bridgeToPins.begin(); it != m_bridgeToPins.end(); ++it) {
-        const auto& pr = it.value();
-        if (pr.first.startsWith(mPrefix) || pr.second.startsWith(mPrefix)) {
-            toRemove.push_back(it.key());
-        }
-    }
-    for (auto* p : toRemove) removeBridgeItem(p);
+    removeBridgesAt(m_motors.value(mPrefix).pins);
 
     // Wyczyść mapy pinów
     for (const QString& pin : std::as_const(m_motors[mPrefix].pins)) {
@@ -538,6 +969,7 @@ void ContactorView::removeMotor(const QString& mPrefix) {
     }
 
     // Usuń itemy graficzne
+    staticChanged(boundsOf(m_motors[mPrefix].items));
     for (auto* it : std::as_const(m_motors[mPrefix].items)) {
         m_itemToM.remove(it);
         if (it && it->scene() == m_scene) m_scene->removeItem(it);
@@ -547,6 +979,160 @@ void ContactorView::removeMotor(const QString& mPrefix) {
     // Usuń obiekt i wpisy
     if (auto* mb = m_motorBlocks.take(mPrefix)) delete mb;
     m_motors.remove(mPrefix);
+    m_placed.remove(mPrefix);
+}
+
+// ---------- Autotrasowanie ----------
+void ContactorView::autoRoute(const QVector<QPair<QString, QString>>& pinPairs) {
+    if (!m_scene || !m_router) return;
+
+    // Migawka przeszkód: korpusy i przyciski, zaciski, istniejące mostki
+    RouteObstacles obstacles;
+    auto addGroup = [&](const Group& g){
+        for (QGraphicsItem* it : g.items) {
+            if (!it || !it->isVisible()) continue;
+            if (qgraphicsitem_cast<QGraphicsEllipseItem*>(it)) continue;   // zaciski osobno
+            obstacles.addBody(it->sceneBoundingRect());
+        }
+    };
+    for (const Group& g : std::as_const(m_contactors)) addGroup(g);
+    for (const Group& g : std::as_const(m_powers))     addGroup(g);
+    for (const Group& g : std::as_const(m_motors))     addGroup(g);
+    for (auto it = m_terms.cbegin(); it != m_terms.cend(); ++it) {
+        if (!it.value()) continue;
+        const QRectF r = it.value()->sceneBoundingRect();
+        obstacles.addPin(r.center(), r.width() / 2.0);
+    }
+    for (QGraphicsPathItem* b : std::as_const(m_bridges)) {
+        for (const QPolygonF& poly : b->path().toSubpathPolygons())
+            obstacles.addPolyline(b->mapToScene(poly));
+    }
+
+    // Niedokończona paczka wraca do kolejki razem z nowymi zleceniami
+    QVector<QPair<QString, QString>> pairs = m_routeJobs.values().toVector();
+    pairs += pinPairs;
+    m_routeJobs.clear();
+
+    QVector<RouteRequest> requests;
+    requests.reserve(pairs.size());
+    for (const auto& pr : std::as_const(pairs)) {
+        if (!m_terms.contains(pr.first) || !m_terms.contains(pr.second)) continue;
+        if (hasBridge(pr.first, pr.second)) continue;
+        const int id = m_nextRouteId++;
+        m_routeJobs.insert(id, pr);
+        requests.push_back(RouteRequest{ id, terminalPos(pr.first), terminalPos(pr.second) });
+    }
+    m_router->routeBatch(obstacles, requests);
+}
+
+void ContactorView::onRouted(const QVector<RouteResult>& results) {
+    int count = 0, fallbacks = 0;
+    beginBulk();   // jedna fala = jedno unieważnienie kafli
+    for (const RouteResult& r : results) {
+        const auto pr = m_routeJobs.take(r.id);
+        // urządzenie mogło zniknąć albo mostek powstać ręcznie w międzyczasie
+        if (!m_terms.contains(pr.first) || !m_terms.contains(pr.second)) continue;
+        if (hasBridge(pr.first, pr.second)) continue;
+        auto* item = addBridgePolyline(r.points);
+        if (!item) continue;
+        registerBridge(item, pr.first, pr.second);
+        ++count;
+        if (!r.ok) ++fallbacks;
+    }
+    endBulk();
+    emit bridgesRouted(count, fallbacks);
+}
+
+// ---------- Płótno i kafle ----------
+void ContactorView::growCanvas(const QRectF& r) {
+    if (!m_scene || r.isEmpty()) return;
+    const QRectF want = r.adjusted(-CANVAS_MARGIN, -CANVAS_MARGIN, CANVAS_MARGIN, CANVAS_MARGIN);
+    const QRectF cur  = m_scene->sceneRect();
+    if (cur.contains(want)) return;
+    m_scene->setSceneRect(cur | want);
+}
+
+void ContactorView::staticChanged(const QRectF& r) {
+    if (r.isEmpty()) return;
+    if (m_bulkDepth > 0) { m_bulkDirty |= r; return; }
+    // zapas na grubość pióra i antialiasing na krawędziach kafli
+    if (m_tiles) m_tiles->invalidate(r.adjusted(-4, -4, 4, 4));
+    growCanvas(r);
+}
+
+void ContactorView::adoptStatic(const QVector<QGraphicsItem*>& items) {
+    for (QGraphicsItem* it : items) {
+        if (auto* body = qgraphicsitem_cast<DeviceBodyItem*>(it)) body->setTiled(true);
+    }
+    staticChanged(boundsOf(items));
+}
+
+QRectF ContactorView::boundsOf(const QVector<QGraphicsItem*>& items) {
+    QRectF r;
+    for (QGraphicsItem* it : items) if (it) r |= it->sceneBoundingRect();
+    return r;
+}
+
+QVector<TileShape> ContactorView::tileSnapshot(const QRectF& rect) const {
+    QVector<TileShape> out;
+    if (!m_scene) return out;
+    const auto hits = m_scene->items(rect, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder);
+    for (QGraphicsItem* it : hits) {
+        if (!it->isVisible()) continue;
+        if (auto* body = qgraphicsitem_cast<DeviceBodyItem*>(it)) {
+            if (!body->isTiled()) continue;
+            TileShape s;
+            s.tpl   = body->deviceTemplate();
+            s.title = body->title();
+            s.pos   = body->scenePos();
+            out.push_back(s);
+        } else if (auto* br = dynamic_cast<BridgeItem*>(it)) {
+            if (!br->isTiled()) continue;
+            TileShape s;
+            s.path = br->sceneTransform().map(br->path());
+            s.pen  = br->pen();
+            out.push_back(s);
+        }
+    }
+    return out;
+}
+
+void ContactorView::drawBackground(QPainter* painter, const QRectF& rect) {
+    QGraphicsView::drawBackground(painter, rect);
+    if (m_tiles) m_tiles->draw(painter, rect, transform().m11(), devicePixelRatioF());
+}
+
+void ContactorView::clearSchematic() {
+    m_placeContactor = m_placePower3 = m_placeMotor3 = false;
+    m_placeType.clear();
+    unsetCursor();
+
+    if (m_tiles) m_tiles->clear();
+    if (m_router) m_router->cancel();
+    m_routeJobs.clear();
+    if (m_scene) m_scene->clear();   // kasuje WSZYSTKIE itemy, także ducha i mostki
+    m_contGhost = nullptr;
+
+    qDeleteAll(m_contBlocks);  m_contBlocks.clear();
+    qDeleteAll(m_powerBlocks); m_powerBlocks.clear();
+    qDeleteAll(m_motorBlocks); m_motorBlocks.clear();
+
+    m_terms.clear();
+    m_faultMarks.clear();
+    m_bridges.clear();
+    m_bridgeToPins.clear();
+    m_bridgesByPin.clear();
+    m_netMark = nullptr;
+    m_drcMark = nullptr;
+    m_placed.clear();
+    m_contactors.clear(); m_itemToK.clear();
+    m_powers.clear();     m_itemToP.clear();
+    m_motors.clear();     m_itemToM.clear();
+    m_nextK = m_nextP = m_nextM = 1;
+    m_nextByPrefix.clear();
+
+    emit schematicCleared();
+    if (viewport()) viewport()->update();
 }
 
 // --- pomocnicze: śledzenie itemów i odwzorowania item->grupa ---
@@ -570,6 +1156,12 @@ void ContactorView::setMotorPhaseMasks(const QString& motorPrefix, int mU, int m
     }
 }
 
+void ContactorView::setMotorOverload(const QString& motorPrefix, float heat, bool tripped)
+{
+    if (Motor3PhaseBlock* mb = m_motorBlocks.value(motorPrefix, nullptr))
+        mb->setOverload(heat, tripped);
+}
+
 
 QString ContactorView::kOfItem(QGraphicsItem* it) const {
     if (!it) return {};
@@ -6,6 +6,7 @@
 #include <QPointF>
 #include <QHash>
 #include <QSet>
+#include <QStringList>
 #include <functional>
 
 class QGraphicsScene;
@@ -21,11 +22,19 @@ class QColor;
 class QPen;
 class QContextMenuEvent;
 class QMouseEvent;
+class QWheelEvent;
+class QTimer;
 
 class PowerBlock;                   // fwd
 class Contactor_LC1D09_LADC22;     // fwd
 class Motor3PhaseBlock;            // fwd
+struct DeviceTemplate;             // fwd
+struct DeviceType;                 // fwd
 class SchematicButton;             // fwd
+class TileCache;                   // fwd
+struct TileShape;                  // fwd
+class WireRouter;                  // fwd
+struct RouteResult;                // fwd
 
 class ContactorView : public QGraphicsView {
     Q_OBJECT
@@ -42,6 +51,7 @@ public:
     static QColor colPhase();
     static QColor colNeutral();
     static QColor colFault();
+    static QColor colNet();
     static QPen   penWire(qreal w = 1.6);
     static QPen   penBlock(qreal w = 1.6);
     static QPen   penDash(qreal w = 1.2);
@@ -49,6 +59,8 @@ public:
     // **NOWE**: zasil bieżącymi maskami faz na zaciskach silnika (U,V,W)
     // mX: bitmaski 0x1=L1, 0x2=L2, 0x4=L3; 0 = brak fazy na danym zacisku
     void setMotorPhaseMasks(const QString& motorPrefix, int mU, int mV, int mW);
+    // Stan przekaźnika przeciążeniowego silnika (heat: 1.0 = próg zadziałania)
+    void setMotorOverload(const QString& motorPrefix, float heat, bool tripped);
 
 signals:
     // Źródła FAZA/ZERO
@@ -56,21 +68,39 @@ signals:
     void addNeutralSourceRequested(const QString& pinView);
     void removePhaseSourceRequested(const QString& pinView);
     void removeNeutralSourceRequested(const QString& pinView);
+    void feedQueryRequested(const QString& pinView);        // PPM: które źródła zasilają pin
+    void netHighlightRequested(const QString& pinView);     // PPM: sieć pinu (pusty = wyłącz)
 
     // Mostki
     void bridgeDeleteRequested(const QString& aPin, const QString& bPin, QGraphicsPathItem* item);
 
     // Styczniki
     void contactorPlaced(const QString& kPrefix);           // np. "K1_"
+    void contactorsPlaced(const QStringList& kPrefixes);    // wstawianie hurtowe
     void contactorDeleteRequested(const QString& kPrefix);  // PPM
 
     // Zasilanie 3F
     void powerPlaced(const QString& pPrefix);               // np. "P1_"
+    void powersPlaced(const QStringList& pPrefixes);        // wstawianie hurtowe
     void powerDeleteRequested(const QString& pPrefix);      // PPM
 
+    // Silnik 3F
+    void motorPlaced(const QString& mPrefix);               // np. "M1_"
+    void motorsPlaced(const QStringList& mPrefixes);        // wstawianie hurtowe
+    void motorDeleteRequested(const QString& mPrefix);      // PPM
+    void motorResetRequested(const QString& mPrefix);       // PPM: kasowanie przekaźnika F
+    void motorLoadRequested(const QString& mPrefix);        // PPM: obciążenie / klasa
+
     // **Istniejące**: powiadomienie o zmianie „fazowości” na pinie (dla silnika 3F itp.)
     void terminalPhaseChanged(const QString& pinName, bool on);
 
+    // Scena wyczyszczona (wszystkie itemy skasowane — nie trzymać wskaźników)
+    void schematicCleared();
+
+    // Autotrasowanie: po każdej fali tras i po zakończeniu paczki
+    void bridgesRouted(int count, int fallbacks);
+    void autoRouteFinished();
+
 public slots:
     // legacy slots (puste lub proste)
     void setEnergized(bool /*on*/) {}
@@ -100,11 +130,65 @@ public:
     QGraphicsPathItem* addBridgePolyline(const QVector<QPointF>& pts);
     void     registerBridge(QGraphicsPathItem* item, const QString& aPin, const QString& bPin);
     void     removeBridgeItem(QGraphicsPathItem* item);
+    bool     hasBridge(const QString& aPin, const QString& bPin) const;
+    void     removeBridge(const QString& aPin, const QString& bPin);
+
+    // Autotrasowanie mostków H/V omijających korpusy i istniejące mostki.
+    // Trasy liczy w tle WireRouter; gotowe trafiają na scenę falami
+    // (addBridgePolyline + registerBridge). Nowa paczka przejmuje niedokończoną.
+    void     autoRoute(const QVector<QPair<QString, QString>>& pinPairs);
+    int      pendingRoutes() const { return m_routeJobs.size(); }
 
     // Tryby wstawiania
     void beginPlaceContactor();
     void beginPlacePower3();
     void beginPlaceMotor3();      // **NOWE**
+    void beginPlaceCatalog(const QString& type);   // typ z DeviceLibrary (id)
+
+    // Wstawianie hurtowe — jedna transakcja: najpierw wszystkie itemy,
+    // potem jeden sygnał zbiorczy (contactorsPlaced/powersPlaced) i jedno
+    // unieważnienie kafli. Zwraca prefiksy nowych urządzeń.
+    // Catalog = typ z DeviceLibrary (type = id); zachowuje się jak stycznik
+    // (contactorPlaced/contactorsPlaced, contactorBlock), prefiks bierze z typu.
+    enum class DeviceKind { Contactor, Power3, Motor3, Catalog };
+    QStringList placeDevices(DeviceKind kind, const QVector<QPointF>& topLefts, const QString& type = QString());
+    QStringList placeDeviceArray(DeviceKind kind, const QPointF& topLeft, int rows, int cols,
+                                 const QString& type = QString());
+    void        beginPlaceArray(DeviceKind kind, int rows, int cols, const QString& type = QString()); // duch całej tablicy
+    static QRectF deviceFootprint(DeviceKind kind, const QString& type = QString());  // lokalnie względem topLeft
+    static QSizeF devicePitch(DeviceKind kind, const QString& type = QString());      // rozstaw w tablicy
+
+    // Transakcja hurtowa: sygnały i unieważnienia kafli zbierane do endBulk()
+    void beginBulk();
+    void endBulk();
+
+    // Odtwarzanie projektu: urządzenie o zadanym numerze (liczniki idą dalej)
+    struct PlacedDevice {
+        DeviceKind kind = DeviceKind::Contactor;
+        int        index = 0;
+        QPointF    topLeft;
+        QString    type;          // Catalog: id typu
+    };
+    QString               placeDeviceAt(DeviceKind kind, int index, const QPointF& topLeft,
+                                        const QString& type = QString());
+    void                  reserveDeviceIndex(DeviceKind kind, int index,   // numer zajęty, grafika później
+                                             const QString& type = QString());
+    QVector<PlacedDevice> placedDevices() const;
+    PlacedDevice          placedDevice(const QString& prefix) const { return m_placed.value(prefix); } // index 0 = brak
+    QVector<QPointF>      bridgePoints(const QString& aPin, const QString& bPin) const;
+    void                  syncSourceButtons(const QSet<QString>& phase, const QSet<QString>& neutral);
+
+    // Podświetlenie sieci: jedna nakładka nad pinami i mostkami między nimi (bez ruszania kafli)
+    void                  highlightNet(const QStringList& pins);
+    void                  clearNetHighlight();
+
+    // Znaczniki DRC: ramki wokół pinów z błędami (jedna nakładka; pusta lista = bez znaczników)
+    void                  setDrcMarkers(const QStringList& pins);
+
+    // Stan widoku (zapisywany w projekcie)
+    qreal   zoom() const;
+    QPointF viewCenter() const;
+    void    setViewState(qreal zoom, const QPointF& center);
 
     // Usuwanie z widoku
     void removeContactor(const QString& kPrefix);
@@ -112,17 +196,32 @@ public:
     void removeMotor(const QString& mPrefix);  // **NOWE**
 
     Contactor_LC1D09_LADC22* contactorBlock(const QString& prefix) const;
+    Motor3PhaseBlock*        motorBlock(const QString& prefix) const;
+
+    // Nowy schemat: usuwa wszystkie urządzenia, mostki i kafle
+    void clearSchematic();
 
 protected:
     void contextMenuEvent(QContextMenuEvent* e) override;
     void mouseMoveEvent(QMouseEvent* e) override;
     void mousePressEvent(QMouseEvent* e) override;
+    void mouseReleaseEvent(QMouseEvent* e) override;
+    void wheelEvent(QWheelEvent* e) override;
+    void drawBackground(QPainter* painter, const QRectF& rect) override;
 
 private:
     void buildScene(); // puste
-    void drawSingleContactorAt(const QPointF& topLeft, uint8_t idx); // tworzy Contactor_LC1D09_LADC22
-    void drawPower3At(const QPointF& topLeft, uint8_t idx);          // tworzy PowerBlock
-    void drawMotorAt(const QPointF& topLeft, uint8_t idx);           // **NOWE** tworzy Motor3PhaseBlock
+    void drawSingleContactorAt(const QPointF& topLeft, int idx); // tworzy Contactor_LC1D09_LADC22
+    void drawPower3At(const QPointF& topLeft, int idx);          // tworzy PowerBlock
+    void drawMotorAt(const QPointF& topLeft, int idx);           // **NOWE** tworzy Motor3PhaseBlock
+    void drawCatalogAt(const QPointF& topLeft, const DeviceType& type, int idx);
+    void drawContactorBlock(const QString& K, const DeviceTemplate& tpl, const QPointF& topLeft);
+    QString placeOne(DeviceKind kind, const QPointF& topLeft, const QString& type = QString()); // kolejny numer + rysowanie
+    int&    nextIndex(DeviceKind kind, const QString& type);     // licznik numerów dla prefiksu
+    bool    isPlacing() const { return m_placeContactor || m_placePower3 || m_placeMotor3 || !m_placeType.isEmpty(); }
+    void    showGhost(const QRectF& rect);
+    void    removeBridgesAt(const QSet<QString>& pins);
+    void    onRouted(const QVector<RouteResult>& results);
 
     // bazowe
     QGraphicsEllipseItem* addTerminal(const QString& name, const QPointF& center);
@@ -140,6 +239,25 @@ private:
     QString   pOfItem(QGraphicsItem* it) const;
     QString   mOfItem(QGraphicsItem* it) const;   // **NOWE**
 
+    // Zoom/przesuwanie: w trakcie interakcji bez antialiasingu, LOD wg skali
+    void      beginInteraction();
+    void      endInteraction();
+    void      applyLod();
+
+    static constexpr qreal ZOOM_STEP = 1.15;   // na jeden „ząbek” kółka
+    static constexpr qreal ZOOM_MIN  = 0.05;
+    static constexpr qreal ZOOM_MAX  = 8.0;
+    static constexpr int   INTERACTION_SETTLE_MS = 150;
+
+    // Płótno bez granic + kafle statycznej zawartości
+    void      growCanvas(const QRectF& r);
+    void      staticChanged(const QRectF& r);                // unieważnia kafle, poszerza płótno
+    void      adoptStatic(const QVector<QGraphicsItem*>& items); // korpusy -> kafle
+    static QRectF boundsOf(const QVector<QGraphicsItem*>& items);
+    QVector<TileShape> tileSnapshot(const QRectF& rect) const;
+
+    static constexpr qreal CANVAS_MARGIN = 1500.0;
+
 private:
     QPointer<QGraphicsScene> m_scene;
     QMap<QString, QGraphicsEllipseItem*> m_terms;
@@ -154,19 +272,34 @@ private:
     QMap<QString, QVector<QGraphicsLineItem*>> m_faultMarks;
 
     // Mostki
-    QVector<QGraphicsPathItem*> m_bridges;
+    QSet<QGraphicsPathItem*> m_bridges;
     QHash<QGraphicsPathItem*, QPair<QString,QString>> m_bridgeToPins;
+    QHash<QString, QVector<QGraphicsPathItem*>>        m_bridgesByPin;   // pin -> mostki
+    QGraphicsPathItem*                                 m_netMark = nullptr;  // podświetlona sieć
+    QGraphicsPathItem*                                 m_drcMark = nullptr;  // znaczniki DRC
 
     // Tryb wstawiania
     bool                m_placeContactor = false;
     bool                m_placePower3    = false;
     bool                m_placeMotor3    = false;  // **NOWE**
+    QString             m_placeType;               // wstawianie typu z katalogu
     QGraphicsRectItem*  m_contGhost = nullptr;
-    uint8_t             m_nextK = 1;
-    uint8_t             m_nextP = 1;
-    uint8_t             m_nextM = 1;               // **NOWE**
+    int                 m_nextK = 1;
+    int                 m_nextP = 1;
+    int                 m_nextM = 1;               // **NOWE**
+    QHash<QString, int> m_nextByPrefix;            // prefiksy katalogu inne niż K ("KA" -> 1…)
+    int                 m_arrayRows = 1;           // tryb tablicy (1x1 = pojedynczo)
+    int                 m_arrayCols = 1;
+
+    // Wstawianie hurtowe
+    int                 m_bulkDepth = 0;
+    QRectF              m_bulkDirty;
+    QStringList         m_bulkK;
+    QStringList         m_bulkP;
+    QStringList         m_bulkM;
 
     // Rejestry i mapowania
+    QHash<QString, PlacedDevice> m_placed;                // prefiks -> rodzaj/numer/pozycja
     QHash<QString, Group>   m_contactors;                 // "K1_" -> items/pins
     QHash<QGraphicsItem*, QString>   m_itemToK;
 
@@ -184,4 +317,18 @@ private:
     QString m_buildingK;
     QString m_buildingP;
     QString m_buildingM; // **NOWE** – jeśli używasz w drawMotorAt
+
+    // Interakcja widoku
+    QTimer* m_interactionTimer = nullptr;
+    bool    m_interacting = false;
+    bool    m_panning     = false;
+    QPoint  m_panLast;
+    bool    m_lodDetail   = true;
+
+    TileCache* m_tiles = nullptr;
+
+    // Autotrasowanie
+    WireRouter*                            m_router = nullptr;
+    QHash<int, QPair<QString, QString>>    m_routeJobs;     // id zlecenia -> piny
+    int                                    m_nextRouteId = 0;
 };
@@ -0,0 +1,44 @@
+#include "device_body_item.h"
+#include "device_template.h"
+
+#include <QFont>
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+DeviceBodyItem::DeviceBodyItem(const DeviceTemplate* tpl,
+                               const QString&        title,
+                               QGraphicsItem*        parent)
+    : QGraphicsItem(parent)
+    , m_tpl(tpl)
+    , m_title(title)
+{
+    if (m_tpl) {
+        m_bounds = m_tpl->bounds;
+        if (!m_title.isEmpty()) {
+            static const QFontMetricsF fm{QFont()};
+            const qreal k = m_tpl->titleScale;
+            m_bounds |= QRectF(m_tpl->titlePos,
+                               QSizeF(fm.horizontalAdvance(m_title) * k + 2.0, fm.height() * k + 2.0));
+        }
+    }
+
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+}
+
+void DeviceBodyItem::setTiled(bool tiled)
+{
+    if (m_tiled == tiled)
+        return;
+    m_tiled = tiled;
+    // w kaflach bufor pixmapy tylko by dublował pamięć
+    setCacheMode(m_tiled ? QGraphicsItem::NoCache : QGraphicsItem::DeviceCoordinateCache);
+    update();
+}
+
+void DeviceBodyItem::paint(QPainter* p, const QStyleOptionGraphicsItem* opt, QWidget*)
+{
+    if (m_tiled || !m_tpl)
+        return;
+    m_tpl->paint(*p, m_title, opt->levelOfDetailFromTransform(p->worldTransform()));
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QGraphicsItem>
+#include <QRectF>
+#include <QString>
+
+struct DeviceTemplate;
+class QPainter;
+class QStyleOptionGraphicsItem;
+class QWidget;
+
+// Statyczny korpus urządzenia jako JEDEN element sceny.
+// Grafika pochodzi ze współdzielonego szablonu typu (DeviceTemplate) — instancja
+// trzyma tylko wskaźnik do niego i własną nazwę. Element odtwarza szablon
+// z bufora pixmapy (DeviceCoordinateCache); przy małym powiększeniu rysowany
+// jest tylko uproszczony obrys (bez etykiet i styków pomocniczych).
+// W trybie kafli (setTiled) element nic nie rysuje sam — jego obraz trafia do
+// kafli TileCache, a element służy już tylko do trafień myszą.
+class DeviceBodyItem : public QGraphicsItem {
+public:
+    enum { Type = UserType + 1 };
+
+    // Poniżej tego powiększenia (level of detail) znikają etykiety i detale
+    static constexpr qreal LOD_DETAIL_MIN = 0.45;
+
+    DeviceBodyItem(const DeviceTemplate* tpl,
+                   const QString&        title = QString(),
+                   QGraphicsItem*        parent = nullptr);
+
+    int    type() const override { return Type; }
+    QRectF boundingRect() const override { return m_bounds; }
+    void   paint(QPainter* p, const QStyleOptionGraphicsItem* opt, QWidget*) override;
+
+    const DeviceTemplate* deviceTemplate() const { return m_tpl; }
+    const QString&        title() const { return m_title; }
+
+    void setTiled(bool tiled);
+    bool isTiled() const { return m_tiled; }
+
+    static bool isDetailed(qreal lod) { return lod >= LOD_DETAIL_MIN; }
+
+private:
+    const DeviceTemplate* m_tpl = nullptr;   // współdzielony, żyje do końca programu
+    QString               m_title;
+    QRectF                m_bounds;
+    bool                  m_tiled = false;
+};
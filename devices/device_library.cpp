@@ -0,0 +1,277 @@
+#include "device_library.h"
+#include "contactor_view.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPen>
+#include <QRegularExpression>
+#include <QStandardPaths>
+
+namespace {
+
+// Prefiksy zajęte przez bloki wbudowane z osobnym licznikiem (P = zasilanie, M = silnik)
+const QStringList RESERVED_PREFIXES = { QStringLiteral("P"), QStringLiteral("M") };
+
+struct Parser {
+    qreal    scale = 1.0;
+    QString  error;
+
+    bool fail(const QString& msg)
+    {
+        if (error.isEmpty())
+            error = msg;
+        return false;
+    }
+
+    bool point(const QJsonValue& v, QPointF& out)
+    {
+        const QJsonArray a = v.toArray();
+        if (a.size() != 2 || !a[0].isDouble() || !a[1].isDouble())
+            return fail(QObject::tr("oczekiwano [x, y]"));
+        out = QPointF(a[0].toDouble() * scale, a[1].toDouble() * scale);
+        return true;
+    }
+
+    bool rect(const QJsonValue& v, QRectF& out)
+    {
+        const QJsonArray a = v.toArray();
+        if (a.size() != 4)
+            return fail(QObject::tr("oczekiwano [x, y, szerokość, wysokość]"));
+        for (const QJsonValue& c : a)
+            if (!c.isDouble())
+                return fail(QObject::tr("oczekiwano [x, y, szerokość, wysokość]"));
+        out = QRectF(a[0].toDouble() * scale, a[1].toDouble() * scale,
+                     a[2].toDouble() * scale, a[3].toDouble() * scale);
+        return true;
+    }
+
+    bool color(const QJsonValue& v, const QColor& fallback, QColor& out)
+    {
+        if (v.isUndefined()) {
+            out = fallback;
+            return true;
+        }
+        const QString name = v.toString();
+        if      (name == QLatin1String("wire"))    out = ContactorView::colWire();
+        else if (name == QLatin1String("block"))   out = ContactorView::colBlock();
+        else if (name == QLatin1String("dash"))    out = ContactorView::colDash();
+        else if (name == QLatin1String("text"))    out = ContactorView::colText();
+        else if (name == QLatin1String("phase"))   out = ContactorView::colPhase();
+        else if (name == QLatin1String("neutral")) out = ContactorView::colNeutral();
+        else                                       out = QColor(name);
+        if (!out.isValid())
+            return fail(QObject::tr("nieznany kolor „%1”").arg(name));
+        return true;
+    }
+
+    bool primitive(const QJsonObject& o, DeviceTemplate& t)
+    {
+        const QString shape = o.value(QLatin1String("shape")).toString();
+        const QString layerName = o.value(QLatin1String("layer")).toString();
+        if (!layerName.isEmpty() && layerName != QLatin1String("outline") && layerName != QLatin1String("detail"))
+            return fail(QObject::tr("nieznana warstwa „%1”").arg(layerName));
+
+        if (shape == QLatin1String("label")) {
+            QPointF at;
+            QColor c;
+            const QString text = o.value(QLatin1String("text")).toString();
+            if (text.isEmpty())
+                return fail(QObject::tr("etykieta bez tekstu"));
+            if (!point(o.value(QLatin1String("at")), at) || !color(o.value(QLatin1String("color")), ContactorView::colText(), c))
+                return false;
+            const auto layer = layerName == QLatin1String("outline") ? DeviceTemplate::Layer::Outline
+                                                                     : DeviceTemplate::Layer::Detail;
+            t.addLabel(text, at, o.value(QLatin1String("size")).toDouble(1.0) * scale, c, QFont(), layer);
+            return true;
+        }
+
+        const auto layer = layerName == QLatin1String("detail") ? DeviceTemplate::Layer::Detail
+                                                                : DeviceTemplate::Layer::Outline;
+        QColor c;
+        if (!color(o.value(QLatin1String("color")), ContactorView::colWire(), c))
+            return false;
+        QPen pen(c);
+        pen.setWidthF(o.value(QLatin1String("pen")).toDouble(1.6));
+        if (o.value(QLatin1String("dash")).toBool())
+            pen.setStyle(Qt::DashLine);
+
+        QBrush brush(Qt::NoBrush);
+        if (o.contains(QLatin1String("fill"))) {
+            QColor f;
+            if (!color(o.value(QLatin1String("fill")), c, f))
+                return false;
+            brush = QBrush(f);
+        }
+
+        if (shape == QLatin1String("line")) {
+            QPointF a, b;
+            if (!point(o.value(QLatin1String("from")), a) || !point(o.value(QLatin1String("to")), b))
+                return false;
+            t.addLine(a, b, pen, layer);
+        } else if (shape == QLatin1String("rect") || shape == QLatin1String("ellipse")) {
+            QRectF r;
+            if (!rect(o.value(QLatin1String("rect")), r))
+                return false;
+            if (shape == QLatin1String("rect")) t.addRect(r, pen, brush, layer);
+            else                                t.addEllipse(r, pen, brush, layer);
+        } else {
+            return fail(QObject::tr("nieznany kształt „%1”").arg(shape));
+        }
+        return true;
+    }
+
+    int pin(const DeviceTemplate& t, const QJsonValue& v)
+    {
+        const QString name = v.toString();
+        const int i = t.pinIndex(name);
+        if (i < 0)
+            fail(QObject::tr("nieznany pin „%1”").arg(name));
+        return i;
+    }
+};
+
+} // namespace
+
+// ======== DeviceLibrary ======================================================
+
+DeviceLibrary& DeviceLibrary::instance()
+{
+    static DeviceLibrary lib;
+    return lib;
+}
+
+QString DeviceLibrary::userDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/catalog");
+}
+
+void DeviceLibrary::load()
+{
+    load({ QStringLiteral(":/catalog"), userDir() });
+}
+
+void DeviceLibrary::load(const QStringList& dirs)
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    for (const QString& dirPath : dirs) {
+        const QDir dir(dirPath);
+        for (const QString& name : dir.entryList({ QStringLiteral("*.json") }, QDir::Files, QDir::Name)) {
+            const QString path = dir.filePath(name);
+            QFile f(path);
+            if (!f.open(QIODevice::ReadOnly)) {
+                m_errors << QStringLiteral("%1: %2").arg(path, f.errorString());
+                continue;
+            }
+            auto type = std::make_unique<DeviceType>();
+            QString error;
+            if (!parse(f.readAll(), *type, &error)) {
+                m_errors << QStringLiteral("%1: %2").arg(path, error);
+                continue;
+            }
+
+            // Ten sam id później (katalog użytkownika) zastępuje wcześniejszy w menu;
+            // stary typ zostaje w pamięci — nic go już nie wskaże
+            const DeviceType* t = type.get();
+            if (const DeviceType* old = m_byId.value(t->id, nullptr)) m_order[m_order.indexOf(old)] = t;
+            else                                                      m_order.push_back(t);
+            m_byId.insert(t->id, t);
+            m_types.push_back(std::move(type));
+        }
+    }
+}
+
+bool DeviceLibrary::parse(const QByteArray& json, DeviceType& out, QString* error)
+{
+    auto failed = [error](const QString& msg) {
+        if (error)
+            *error = msg;
+        return false;
+    };
+
+    QJsonParseError pe;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &pe);
+    if (doc.isNull())
+        return failed(pe.errorString());
+    const QJsonObject root = doc.object();
+
+    out.id     = root.value(QLatin1String("id")).toString();
+    out.title  = root.value(QLatin1String("title")).toString(out.id);
+    out.prefix = root.value(QLatin1String("prefix")).toString();
+    static const QRegularExpression prefixRe(QStringLiteral("^[A-Z]{1,3}$"));
+    if (out.id.isEmpty())
+        return failed(QObject::tr("brak „id”"));
+    if (!prefixRe.match(out.prefix).hasMatch())
+        return failed(QObject::tr("prefiks musi mieć 1–3 wielkie litery"));
+    if (RESERVED_PREFIXES.contains(out.prefix))
+        return failed(QObject::tr("prefiks „%1” jest zarezerwowany").arg(out.prefix));
+
+    Parser p;
+    p.scale = root.value(QLatin1String("scale")).toDouble(1.0);
+    DeviceTemplate& t = out.tpl;
+
+    for (const QJsonValue& g : root.value(QLatin1String("graphics")).toArray())
+        if (!p.primitive(g.toObject(), t))
+            return failed(p.error);
+
+    for (const QJsonValue& v : root.value(QLatin1String("pins")).toArray()) {
+        const QJsonObject o = v.toObject();
+        const QString name = o.value(QLatin1String("name")).toString();
+        QPointF at;
+        if (name.isEmpty())
+            return failed(QObject::tr("pin bez nazwy"));
+        if (t.pinIndex(name) >= 0)
+            return failed(QObject::tr("pin „%1” powtórzony").arg(name));
+        if (!p.point(o.value(QLatin1String("at")), at))
+            return failed(p.error);
+        t.addPin(name, at, o.value(QLatin1String("detail")).toBool());
+    }
+
+    for (const QJsonValue& v : root.value(QLatin1String("contacts")).toArray()) {
+        const QJsonObject o = v.toObject();
+        const QString kind = o.value(QLatin1String("kind")).toString();
+        if (kind != QLatin1String("NO") && kind != QLatin1String("NC"))
+            return failed(QObject::tr("rodzaj styku musi być NO albo NC"));
+        const int a = p.pin(t, o.value(QLatin1String("a")));
+        const int b = p.pin(t, o.value(QLatin1String("b")));
+        if (a < 0 || b < 0)
+            return failed(p.error);
+        t.contacts.push_back({a, b, kind == QLatin1String("NO")});
+    }
+
+    if (root.contains(QLatin1String("coil"))) {
+        const QJsonObject o = root.value(QLatin1String("coil")).toObject();
+        t.coilA = p.pin(t, o.value(QLatin1String("a")));
+        t.coilB = p.pin(t, o.value(QLatin1String("b")));
+        if (t.coilA < 0 || t.coilB < 0)
+            return failed(p.error);
+    }
+
+    for (const QJsonValue& v : root.value(QLatin1String("buttons")).toArray()) {
+        const QJsonObject o = v.toObject();
+        DeviceTemplate::Button b;
+        b.text    = o.value(QLatin1String("text")).toString();
+        b.neutral = o.value(QLatin1String("source")).toString() == QLatin1String("neutral");
+        b.onColor = b.neutral ? ContactorView::colNeutral() : ContactorView::colPhase();
+        b.pin     = p.pin(t, o.value(QLatin1String("pin")));
+        if (b.pin < 0 || !p.rect(o.value(QLatin1String("rect")), b.rect))
+            return failed(p.error);
+        t.buttons.push_back(b);
+    }
+
+    const QJsonObject name = root.value(QLatin1String("name")).toObject();
+    if (!name.isEmpty() && !p.point(name.value(QLatin1String("at")), t.titlePos))
+        return failed(p.error);
+    t.titleScale = name.value(QLatin1String("size")).toDouble(1.0) * p.scale;
+    t.titleColor = ContactorView::colText();
+
+    if (t.pins.isEmpty())
+        return failed(QObject::tr("typ bez pinów"));
+    t.finish();
+    return true;
+}
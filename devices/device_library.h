@@ -0,0 +1,63 @@
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+#include <vector>
+
+#include "device_template.h"
+
+// Typ urządzenia z katalogu — opis w danych (JSON), nie w kodzie.
+// Instancja to tylko wskaźnik na typ + prefiks („KA3_”); szablon jest wspólny.
+struct DeviceType {
+    QString        id;        // np. "LC1D18" — zapisywany w projekcie
+    QString        title;     // do menu
+    QString        prefix;    // litery prefiksu instancji: "K" -> K1_, K2_…
+    DeviceTemplate tpl;       // skompilowana grafika, piny, styki, cewka, przyciski
+};
+
+// Katalog typów urządzeń: pliki *.json wczytywane RAZ przy starcie (wątek GUI —
+// napisy zamieniane są na kontury przez silnik czcionek). Potem katalog jest
+// niezmienny i może być czytany z dowolnego wątku (np. wczytywanie projektu).
+//
+//   {
+//     "id": "LC1D18", "title": "Stycznik LC1D18", "prefix": "K", "scale": 0.7,
+//     "graphics": [ { "shape": "rect|line|ellipse|label", "rect": [x,y,w,h] | "from"/"to": [x,y]
+//                     | "at": [x,y] + "text", "pen": 1.6, "color": "wire|block|text|…|#rrggbb",
+//                     "dash": false, "size": 1.0, "layer": "outline|detail" } ],
+//     "pins":     [ { "name": "A1", "at": [x,y], "detail": false } ],
+//     "contacts": [ { "a": "L1", "b": "T1", "kind": "NO|NC" } ],
+//     "coil":     { "a": "A1", "b": "A2" },
+//     "buttons":  [ { "pin": "A1", "text": "START", "rect": [x,y,w,h], "source": "phase|neutral" } ],
+//     "name":     { "at": [x,y], "size": 1.0 }
+//   }
+//
+// Współrzędne są mnożone przez "scale". Typ o tym samym id z katalogu
+// użytkownika zastępuje wbudowany.
+class DeviceLibrary {
+public:
+    static DeviceLibrary& instance();
+
+    // Wbudowany katalog (zasoby) + katalog użytkownika; kolejne wywołania nic nie robią
+    void load();
+    void load(const QStringList& dirs);
+
+    const DeviceType*                find(const QString& id) const { return m_byId.value(id, nullptr); }
+    const QVector<const DeviceType*>& types() const { return m_order; }
+    const QStringList&               errors() const { return m_errors; }
+
+    static QString userDir();
+    static bool    parse(const QByteArray& json, DeviceType& out, QString* error = nullptr);
+
+private:
+    DeviceLibrary() = default;
+
+    std::vector<std::unique_ptr<DeviceType>> m_types;   // stałe adresy — szablony wskazywane przez instancje
+    QHash<QString, const DeviceType*>         m_byId;
+    QVector<const DeviceType*>                m_order;   // kolejność menu
+    QStringList                               m_errors;
+    bool                                      m_loaded = false;
+};
@@ -0,0 +1,107 @@
+#include "device_template.h"
+#include "device_body_item.h"
+
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QTransform>
+
+void DeviceTemplate::add(Layer layer, Stroke s)
+{
+    (layer == Layer::Outline ? outline : detail).push_back(std::move(s));
+}
+
+void DeviceTemplate::addLine(const QPointF& a, const QPointF& b, const QPen& pen, Layer layer)
+{
+    QPainterPath path(a);
+    path.lineTo(b);
+    add(layer, {path, pen, Qt::NoBrush});
+}
+
+void DeviceTemplate::addRect(const QRectF& r, const QPen& pen, const QBrush& brush, Layer layer)
+{
+    QPainterPath path;
+    path.addRect(r);
+    add(layer, {path, pen, brush});
+}
+
+void DeviceTemplate::addEllipse(const QRectF& r, const QPen& pen, const QBrush& brush, Layer layer)
+{
+    QPainterPath path;
+    path.addEllipse(r);
+    add(layer, {path, pen, brush});
+}
+
+void DeviceTemplate::addLabel(const QString& text, const QPointF& topLeft, qreal scale, const QColor& color,
+                              const QFont& font, Layer layer)
+{
+    // kontur liter liczony raz — potem rysowanie nie dotyka silnika czcionek
+    const QFontMetricsF fm(font);
+    QPainterPath glyphs;
+    glyphs.addText(QPointF(0.0, fm.ascent()), font, text);
+
+    QTransform t;
+    t.translate(topLeft.x(), topLeft.y());
+    t.scale(scale, scale);
+    add(layer, {t.map(glyphs), QPen(Qt::NoPen), QBrush(color)});
+}
+
+int DeviceTemplate::addPin(const QString& suffix, const QPointF& pos, bool isDetail)
+{
+    pins.push_back({suffix, pos, isDetail});
+    return pins.size() - 1;
+}
+
+int DeviceTemplate::pinIndex(const QString& suffix) const
+{
+    for (int i = 0; i < pins.size(); ++i)
+        if (pins[i].suffix == suffix) return i;
+    return -1;
+}
+
+QRectF DeviceTemplate::footprint(qreal terminalRadius) const
+{
+    QRectF r = bounds;
+    for (const Pin& pin : pins)
+        r |= QRectF(pin.pos - QPointF(terminalRadius, terminalRadius), QSizeF(2 * terminalRadius, 2 * terminalRadius));
+    for (const Button& b : buttons)
+        r |= b.rect;
+    return r;
+}
+
+void DeviceTemplate::finish()
+{
+    QRectF r;
+    for (const QVector<Stroke>* layer : {&outline, &detail}) {
+        for (const Stroke& s : *layer) {
+            const qreal m = (s.pen.style() == Qt::NoPen ? 0.0 : s.pen.widthF() / 2.0) + 1.0;
+            r |= s.path.boundingRect().adjusted(-m, -m, m, m);
+        }
+    }
+    bounds = r;
+}
+
+void DeviceTemplate::paint(QPainter& p, const QString& title, qreal lod) const
+{
+    auto play = [&p](const QVector<Stroke>& strokes) {
+        for (const Stroke& s : strokes) {
+            p.setPen(s.pen);
+            p.setBrush(s.brush);
+            p.drawPath(s.path);
+        }
+    };
+
+    play(outline);
+    if (!DeviceBodyItem::isDetailed(lod))
+        return;
+    play(detail);
+
+    if (!title.isEmpty()) {
+        const QFontMetricsF fm(p.font());
+        p.save();
+        p.translate(titlePos);
+        p.scale(titleScale, titleScale);
+        p.setPen(titleColor);
+        p.drawText(QPointF(0.0, fm.ascent()), title);
+        p.restore();
+    }
+}
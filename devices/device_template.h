@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+#include <QPainterPath>
+#include <QPen>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+class QPainter;
+
+// Współdzielony, niezmienny szablon typu urządzenia (flyweight).
+// Geometria korpusu jest liczona RAZ na typ — instancje trzymają tylko wskaźnik
+// do szablonu i przesunięcie; własny stan mają jedynie piny i przyciski.
+// Grafika to gotowe ścieżki (napisy zamienione na kontury), więc szablon można
+// bezpiecznie rysować równolegle z wielu wątków (kafle TileCache).
+struct DeviceTemplate {
+    enum class Layer {
+        Outline,   // obrys: widoczny zawsze (także przy małym powiększeniu)
+        Detail,    // tylko przy pełnym detalu (etykiety, opisy, styki pomocnicze)
+    };
+
+    struct Stroke {
+        QPainterPath path;
+        QPen         pen;
+        QBrush       brush;
+    };
+
+    struct Pin {
+        QString suffix;           // np. "L1" — pełna nazwa = prefiks + suffix
+        QPointF pos;              // środek zacisku, lokalnie
+        bool    detail = false;   // ukrywany przy małym powiększeniu
+    };
+
+    struct Contact {
+        int  pinA = -1;           // indeksy w pins
+        int  pinB = -1;
+        bool normallyOpen = true;
+    };
+
+    struct Button {
+        QRectF  rect;             // lokalnie
+        QString text;
+        QColor  onColor;
+        int     pin = -1;         // pin sterowany przyciskiem
+        bool    neutral = false;  // false = FAZA, true = ZERO
+    };
+
+    QVector<Stroke>  outline;     // rysowane zawsze
+    QVector<Stroke>  detail;      // dorysowywane przy pełnym detalu
+    QRectF           bounds;      // z zapasem na pióro
+
+    QVector<Pin>     pins;
+    QVector<Contact> contacts;
+    QVector<Button>  buttons;
+
+    // Cewka (indeksy w pins): załączona, gdy na coilA jest FAZA, a na coilB ZERO; -1 = bez cewki
+    int              coilA = -1;
+    int              coilB = -1;
+
+    // Nazwa instancji (np. „K1”) — jedyny napis korpusu zależny od instancji
+    QPointF titlePos;
+    qreal   titleScale = 1.0;
+    QColor  titleColor;
+
+    // ---- budowanie (tylko raz, w wątku GUI)
+    void addLine(const QPointF& a, const QPointF& b, const QPen& pen, Layer layer = Layer::Outline);
+    void addRect(const QRectF& r, const QPen& pen, const QBrush& brush = Qt::NoBrush, Layer layer = Layer::Outline);
+    void addEllipse(const QRectF& r, const QPen& pen, const QBrush& brush = Qt::NoBrush, Layer layer = Layer::Outline);
+    // napis jak QGraphicsSimpleTextItem (topLeft = lewy górny róg, przed skalą)
+    void addLabel(const QString& text, const QPointF& topLeft, qreal scale, const QColor& color,
+                  const QFont& font = QFont(), Layer layer = Layer::Detail);
+    int  addPin(const QString& suffix, const QPointF& pos, bool isDetail = false);
+    void finish();  // domyka bounds
+
+    int  pinIndex(const QString& suffix) const;
+
+    // Pełny obszar zajmowany przez instancję (korpus + zaciski + przyciski) — do rozstawu
+    QRectF footprint(qreal terminalRadius = 10.0) const;
+
+    // Rysowanie (dowolny wątek) we współrzędnych lokalnych; lod decyduje o detalach
+    void paint(QPainter& p, const QString& title, qreal lod) const;
+
+private:
+    void add(Layer layer, Stroke s);
+};
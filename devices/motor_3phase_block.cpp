@@ -1,4 +1,6 @@
 #include "motor_3phase_block.h"
+#include "device_body_item.h"
+#include "device_template.h"
 
 #include <QBrush>
 #include <QColor>
@@ -40,45 +42,109 @@ Motor3PhaseBlock::Motor3PhaseBlock(QGraphicsScene* scene,
     build(topLeft);
 }
 
-void Motor3PhaseBlock::build(const QPointF& topLeft)
+namespace {
+// Geometria lokalna (względem topLeft)
+const QPointF CENTER(120.0 * S, 70.0 * S);
+const QPointF TERMINAL_BASE(20.0 * S, 20.0 * S);
+constexpr qreal SPACING = 52.0 * S;
+// Styk NC 95-96 przekaźnika przeciążeniowego (LR2) — do obwodu sterowania
+const QPointF OVERLOAD_95(204.0 * S, 24.0 * S);
+const QPointF OVERLOAD_96(204.0 * S, 116.0 * S);
+const QPointF THERMAL_LABEL(92.0 * S, 116.0 * S);
+constexpr int PHASE_PINS = 3;            // U/V/W; dalej 95/96
+}
+
+const DeviceTemplate& Motor3PhaseBlock::deviceTemplate()
 {
-    if (!m_scene)
-        return;
+    static const DeviceTemplate tpl = buildTemplate();
+    return tpl;
+}
 
-    const QPointF center = topLeft + QPointF(120.0 * S, 70.0 * S);
-    const QPointF terminalBase = topLeft + QPointF(20.0 * S, 20.0 * S);
-    const qreal spacing = 52.0 * S;
+DeviceTemplate Motor3PhaseBlock::buildTemplate()
+{
+    using Layer = DeviceTemplate::Layer;
+    DeviceTemplate t;
 
     // Korpus silnika
-    m_body = m_scene->addEllipse(center.x() - BODY_RADIUS, center.y() - BODY_RADIUS,
-                                 BODY_RADIUS * 2.0, BODY_RADIUS * 2.0,
-                                 QPen(colFrame(), LINE_WIDTH), QBrush(colFill()));
-    m_body->setZValue(1);
-    m_items.push_back(m_body);
+    const QRectF body(CENTER - QPointF(BODY_RADIUS, BODY_RADIUS), QSizeF(BODY_RADIUS * 2.0, BODY_RADIUS * 2.0));
+    t.addEllipse(body, QPen(colFrame(), LINE_WIDTH), QBrush(colFill()));
 
-    // Etykieta "M"
-    m_labelM = addLabel(center + QPointF(-12.0, -18.0), QStringLiteral("M"), 20, QFont::Bold);
+    // Dekoracyjne połączenia i rama
+    const QPen dash(colFrame(), LINE_WIDTH, Qt::DashLine);
+    t.addLine(CENTER + QPointF(-BODY_RADIUS, -BODY_RADIUS), CENTER + QPointF(-BODY_RADIUS, BODY_RADIUS), dash, Layer::Detail);
+    t.addLine(CENTER + QPointF(BODY_RADIUS, -BODY_RADIUS),  CENTER + QPointF(BODY_RADIUS, BODY_RADIUS),  dash, Layer::Detail);
+
+    // Etykieta "M" i opisy zacisków
+    auto font = [](int pointSize, QFont::Weight weight) {
+        QFont f;
+        f.setPointSize(pointSize);
+        f.setWeight(weight);
+        return f;
+    };
+    t.addLabel(QStringLiteral("M"), CENTER + QPointF(-12.0, -18.0), 1.0, colText(), font(20, QFont::Bold));
 
-    // Zaciski U/V/W
     const QStringList pinLabels = {QStringLiteral("U"), QStringLiteral("V"), QStringLiteral("W")};
     for (int i = 0; i < pinLabels.size(); ++i) {
-        const QPointF pos = terminalBase + QPointF(0.0, spacing * i);
-        auto* term = addTerminal(m_prefix + pinLabels[i], pos);
-        m_terminals.push_back({m_prefix + pinLabels[i], term});
-        m_pins.insert(m_prefix + pinLabels[i]);
+        const QPointF pos = TERMINAL_BASE + QPointF(0.0, SPACING * i);
+        t.addPin(pinLabels[i], pos);
+        t.addLabel(pinLabels[i], pos + QPointF(-22.0, -10.0), 1.0, colText(), font(12, QFont::Normal));
+    }
+
+    // Przekaźnik termiczny: styk NC 95-96 (zwiera, dopóki nie wyzwoli) sprzężony z silnikiem
+    const QPen wire(colFrame(), LINE_WIDTH);
+    const QPointF fixedTop = OVERLOAD_95 + QPointF(0.0, 26.0);
+    const QPointF bladeTop = OVERLOAD_96 - QPointF(0.0, 30.0);
+    t.addLine(OVERLOAD_95, fixedTop, wire);
+    t.addLine(fixedTop, fixedTop + QPointF(10.0, 0.0), wire);
+    t.addLine(bladeTop, fixedTop + QPointF(10.0, -4.0), wire);
+    t.addLine(bladeTop, OVERLOAD_96, wire);
+    t.addLine(CENTER + QPointF(BODY_RADIUS, 0.0), fixedTop + QPointF(6.0, 16.0), dash, Layer::Detail);
+    t.addLabel(QStringLiteral("F"), fixedTop + QPointF(14.0, 8.0), 1.0, colText(), font(12, QFont::Bold));
+    t.addPin(QStringLiteral("95"), OVERLOAD_95);
+    t.addPin(QStringLiteral("96"), OVERLOAD_96);
+    t.addLabel(QStringLiteral("95"), OVERLOAD_95 + QPointF(12.0, -10.0), 1.0, colText(), font(10, QFont::Normal));
+    t.addLabel(QStringLiteral("96"), OVERLOAD_96 + QPointF(12.0, -10.0), 1.0, colText(), font(10, QFont::Normal));
+    t.contacts.push_back({ t.pinIndex(QStringLiteral("95")), t.pinIndex(QStringLiteral("96")), false });
+
+    t.finish();
+    return t;
+}
+
+void Motor3PhaseBlock::build(const QPointF& topLeft)
+{
+    if (!m_scene)
+        return;
+
+    const DeviceTemplate& tpl = deviceTemplate();
 
-        // krótka linia łącząca zacisk z korpusem
-        const QPointF lineEnd = pos + QPointF(42.0 * S, 0.0);
-        m_phaseTicks.push_back(addLine(pos + QPointF(TERMINAL_RADIUS, 0.0), lineEnd));
+    m_bodyRect = QRectF(topLeft + CENTER - QPointF(BODY_RADIUS, BODY_RADIUS),
+                        QSizeF(BODY_RADIUS * 2.0, BODY_RADIUS * 2.0));
 
-        addLabel(pos + QPointF(-22.0, -10.0), pinLabels[i]);
+    // Korpus silnika + opisy: wspólny szablon
+    m_body = new DeviceBodyItem(&tpl);
+    m_body->setPos(topLeft);
+    m_body->setZValue(1);
+    m_scene->addItem(m_body);
+    m_items.push_back(m_body);
+
+    // Zaciski U/V/W, potem 95/96
+    for (int i = 0; i < tpl.pins.size(); ++i) {
+        const DeviceTemplate::Pin& pin = tpl.pins[i];
+        const QPointF pos = topLeft + pin.pos;
+        const QString name = m_prefix + pin.suffix;
+        auto* term = addTerminal(name, pos);
+        m_terminals.push_back({name, term});
+        m_pins.insert(name);
+
+        // krótka linia łącząca zacisk z korpusem (kolor zależy od fazy — osobny item)
+        if (i < PHASE_PINS) {
+            const QPointF lineEnd = pos + QPointF(42.0 * S, 0.0);
+            m_phaseTicks.push_back(addLine(pos + QPointF(TERMINAL_RADIUS, 0.0), lineEnd));
+        }
     }
 
-    // Dekoracyjne połączenia i rama
-    addLine(center + QPointF(-BODY_RADIUS, -BODY_RADIUS),
-            center + QPointF(-BODY_RADIUS, BODY_RADIUS), Qt::DashLine);
-    addLine(center + QPointF(BODY_RADIUS, -BODY_RADIUS),
-            center + QPointF(BODY_RADIUS, BODY_RADIUS), Qt::DashLine);
+    // Stan cieplny przekaźnika (θ względem progu)
+    m_thermalLabel = addLabel(topLeft + THERMAL_LABEL, QString(), 9);
 
     ensureDirectionLabel();
     updateRotation();
@@ -130,13 +196,13 @@ void Motor3PhaseBlock::ensureDirectionLabel()
     if (!m_scene)
         return;
 
-    const QPointF pos = m_body ? (m_body->rect().center() + QPointF(-10.0, 6.0)) : QPointF();
+    const QPointF pos = m_body ? (m_bodyRect.center() + QPointF(-10.0, 6.0)) : QPointF();
     m_dirLabel = addLabel(pos, QStringLiteral("–"), 18, QFont::DemiBold);
 
     // strzałka dookólna (kierunek obrotów)
     if (m_body) {
         QPainterPath path;
-        const QRectF r = m_body->rect().adjusted(10.0, 10.0, -10.0, -10.0);
+        const QRectF r = m_bodyRect.adjusted(10.0, 10.0, -10.0, -10.0);
         path.arcMoveTo(r, 20.0);
         path.arcTo(r, 20.0, -320.0);
         const QPointF arrowBase = path.pointAtPercent(0.85);
@@ -164,6 +230,23 @@ void Motor3PhaseBlock::setPhaseMasks(int maskU, int maskV, int maskW)
     updateRotation();
 }
 
+void Motor3PhaseBlock::setOverload(float heat, bool tripped)
+{
+    if (!m_thermalLabel)
+        return;
+
+    const int percent = qRound(heat * 100.0f);
+    if (percent == m_heatPercent && tripped == m_tripped)
+        return;
+    m_heatPercent = percent;
+    m_tripped = tripped;
+
+    m_thermalLabel->setText(tripped ? QStringLiteral("F: WYZW. %1%").arg(percent)
+                          : percent > 0 ? QStringLiteral("F: %1%").arg(percent)
+                                        : QString());
+    m_thermalLabel->setBrush(QBrush(tripped ? colPhase() : colText()));
+}
+
 void Motor3PhaseBlock::updateTerminalAppearance(int index)
 {
     if (index < 0 || index >= m_terminals.size())
@@ -222,7 +305,7 @@ void Motor3PhaseBlock::updateRotation()
         else              text = QStringLiteral("–");
         m_dirLabel->setText(text);
         if (m_body) {
-            const QPointF c = m_body->rect().center();
+            const QPointF c = m_bodyRect.center();
             m_dirLabel->setPos(c + QPointF(-10.0, 4.0));
         }
     }
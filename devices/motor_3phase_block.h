@@ -4,6 +4,7 @@
 #include <QList>
 #include <QObject>
 #include <QPointF>
+#include <QRectF>
 #include <QSet>
 #include <QString>
 #include <QVector>
@@ -14,6 +15,8 @@ class QGraphicsEllipseItem;
 class QGraphicsLineItem;
 class QGraphicsPathItem;
 class QGraphicsSimpleTextItem;
+class DeviceBodyItem;
+struct DeviceTemplate;
 
 class Motor3PhaseBlock : public QObject {
     Q_OBJECT
@@ -33,11 +36,18 @@ public:
     const QVector<QGraphicsItem*>& items() const { return m_items; }
     const QList<Terminal>& terminals() const { return m_terminals; }
 
+    // Wspólny (niezmienny) szablon korpusu silnika
+    static const DeviceTemplate& deviceTemplate();
+
     // Aktualizuje przypisanie faz do zacisków U/V/W. maska: 0x1=L1, 0x2=L2, 0x4=L3, 0 brak fazy.
     void setPhaseMasks(int maskU, int maskV, int maskW);
 
+    // Stan przekaźnika przeciążeniowego: heat = θ względem progu (1.0 = wyzwolenie)
+    void setOverload(float heat, bool tripped);
+
 private:
     void build(const QPointF& topLeft);
+    static DeviceTemplate buildTemplate();
     QGraphicsEllipseItem* addTerminal(const QString& name, const QPointF& center);
     QGraphicsLineItem* addLine(const QPointF& p1, const QPointF& p2, Qt::PenStyle style = Qt::SolidLine);
     QGraphicsSimpleTextItem* addLabel(const QPointF& pos,
@@ -56,11 +66,14 @@ private:
     QSet<QString>            m_pins;
     QList<Terminal>          m_terminals;
 
-    QGraphicsEllipseItem*    m_body   = nullptr;
-    QGraphicsSimpleTextItem* m_labelM = nullptr;
+    DeviceBodyItem*          m_body   = nullptr; // korpus + opisy (statyczne)
+    QRectF                   m_bodyRect;          // okrąg korpusu we współrzędnych sceny
     QGraphicsSimpleTextItem* m_dirLabel = nullptr;
     QGraphicsPathItem*       m_arrow = nullptr;
     QVector<QGraphicsLineItem*> m_phaseTicks;
+    QGraphicsSimpleTextItem* m_thermalLabel = nullptr;
+    int                      m_heatPercent = 0;
+    bool                     m_tripped = false;
 
     int m_phaseMask[3] = {0, 0, 0};
 };
@@ -0,0 +1,190 @@
+#include "tile_cache.h"
+#include "device_template.h"
+
+#include <QMetaObject>
+#include <QPainter>
+#include <QThread>
+
+#include <cmath>
+
+TileCache::TileCache(SnapshotFn snapshot, QObject* parent)
+    : QObject(parent)
+    , m_snapshot(std::move(snapshot))
+{
+    m_tiles.setMaxCost(MAX_CACHE_MB * 1024);
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+TileCache::~TileCache()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+// ======== Klucze kafli =======================================================
+
+quint64 TileCache::keyOf(int zoom, int tx, int ty)
+{
+    return (quint64(quint16(qint16(zoom))) << 48)
+         | (quint64(quint32(tx) & 0xFFFFFFu) << 24)
+         |  quint64(quint32(ty) & 0xFFFFFFu);
+}
+
+int TileCache::zoomOf(qreal scale)
+{
+    // tolerancja: skala równa szczeblowi (np. 1.0) nie przeskakuje na następny
+    return int(std::ceil(std::log2(scale) * ZOOM_STEPS - 1e-6));
+}
+
+qreal TileCache::scaleOf(int zoom)
+{
+    return std::exp2(qreal(zoom) / ZOOM_STEPS);
+}
+
+QRectF TileCache::tileRect(int tx, int ty, qreal scale)
+{
+    const qreal size = TILE_PX / scale;
+    return QRectF(tx * size, ty * size, size, size);
+}
+
+QRectF TileCache::rectOfKey(quint64 key)
+{
+    // rozszerzenie znaku 24-bitowych indeksów
+    auto sx24 = [](quint64 v) { return int(qint32(quint32(v & 0xFFFFFFu) << 8) >> 8); };
+    const int zoom = qint16(quint16(key >> 48));
+    return tileRect(sx24(key >> 24), sx24(key), scaleOf(zoom));
+}
+
+// ======== Rysowanie ==========================================================
+
+void TileCache::paintShapes(QPainter& p, const QVector<TileShape>& shapes, qreal lod)
+{
+    for (const TileShape& s : shapes) {
+        if (!s.path.isEmpty()) {
+            p.setPen(s.pen);
+            p.setBrush(Qt::NoBrush);
+            p.drawPath(s.path);
+            continue;
+        }
+        if (!s.tpl)
+            continue;
+        p.save();
+        p.translate(s.pos);
+        s.tpl->paint(p, s.title, lod);
+        p.restore();
+    }
+}
+
+void TileCache::draw(QPainter* p, const QRectF& exposed, qreal scale, qreal dpr)
+{
+    if (!p || scale <= 0.0 || exposed.isEmpty())
+        return;
+
+    const int   zoom = zoomOf(scale);
+    const qreal qs   = scaleOf(zoom);
+    const qreal size = TILE_PX / qs;
+
+    const int tx0 = int(std::floor(exposed.left()   / size));
+    const int tx1 = int(std::floor(exposed.right()  / size));
+    const int ty0 = int(std::floor(exposed.top()    / size));
+    const int ty1 = int(std::floor(exposed.bottom() / size));
+
+    // Kafel jest zmniejszany do bieżącej skali (co najwyżej √2 razy)
+    const bool smooth = p->testRenderHint(QPainter::SmoothPixmapTransform);
+    p->setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    QPainterPath missing;
+    QRectF       missingBounds;
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            const quint64 key  = keyOf(zoom, tx, ty);
+            const QRectF  rect = tileRect(tx, ty, qs);
+            if (const QImage* img = m_tiles.object(key)) {
+                if (!img->isNull()) p->drawImage(rect, *img);
+                continue;
+            }
+            request(key, rect, qs, dpr);
+            if (!m_tiles.contains(key)) {   // pusty kafel trafia do bufora od razu
+                missing.addRect(rect);
+                missingBounds |= rect;
+            }
+        }
+    }
+
+    p->setRenderHint(QPainter::SmoothPixmapTransform, smooth);
+
+    // Kafle jeszcze w drodze: ten jeden raz rysujemy je na żywo
+    if (!missing.isEmpty()) {
+        p->save();
+        p->setClipPath(missing, Qt::IntersectClip);
+        paintShapes(*p, m_snapshot(missingBounds & exposed), qs);   // LOD jak w kaflu
+        p->restore();
+    }
+}
+
+// ======== Zlecenia w tle =====================================================
+
+void TileCache::request(quint64 key, const QRectF& sceneRect, qreal scale, qreal dpr)
+{
+    if (m_pending.contains(key))
+        return;
+
+    QVector<TileShape> shapes = m_snapshot(sceneRect);
+    if (shapes.isEmpty()) {
+        m_tiles.insert(key, new QImage(), 1);
+        return;
+    }
+
+    const quint64 generation = ++m_generation;
+    m_pending.insert(key, generation);
+
+    m_pool.start([this, key, generation, sceneRect, scale, dpr, shapes] {
+        QImage img(QSize(TILE_PX, TILE_PX) * dpr, QImage::Format_ARGB32_Premultiplied);
+        img.setDevicePixelRatio(dpr);
+        img.fill(Qt::transparent);
+        {
+            QPainter p(&img);
+            p.setRenderHint(QPainter::Antialiasing, true);
+            p.scale(scale, scale);
+            p.translate(-sceneRect.topLeft());
+            paintShapes(p, shapes, scale);
+        }
+        QMetaObject::invokeMethod(this, [this, key, generation, img] {
+            onRendered(key, generation, img);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void TileCache::onRendered(quint64 key, quint64 generation, const QImage& img)
+{
+    auto it = m_pending.find(key);
+    if (it == m_pending.end() || it.value() != generation)
+        return; // kafel unieważniony w międzyczasie
+    m_pending.erase(it);
+
+    const int costKb = qMax<qsizetype>(1, img.sizeInBytes() / 1024);
+    m_tiles.insert(key, new QImage(img), costKb);
+    emit tileReady(rectOfKey(key));
+}
+
+void TileCache::invalidate(const QRectF& sceneRect)
+{
+    if (sceneRect.isEmpty())
+        return;
+    const QList<quint64> keys = m_tiles.keys();
+    for (quint64 key : keys) {
+        if (rectOfKey(key).intersects(sceneRect))
+            m_tiles.remove(key);
+    }
+    for (auto it = m_pending.begin(); it != m_pending.end(); ) {
+        if (rectOfKey(it.key()).intersects(sceneRect)) it = m_pending.erase(it);
+        else ++it;
+    }
+}
+
+void TileCache::clear()
+{
+    m_pool.clear();
+    m_tiles.clear();
+    m_pending.clear();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPainterPath>
+#include <QPen>
+#include <QString>
+#include <QPointF>
+#include <QRectF>
+#include <QThreadPool>
+#include <QVector>
+#include <functional>
+
+class QPainter;
+
+struct DeviceTemplate;
+
+// Kopia statycznej grafiki do narysowania w kaflu (bez wskaźników na itemy —
+// kafle renderuje wątek roboczy, a itemy żyją w wątku GUI).
+// Szablony urządzeń są niezmienne i nieśmiertelne, a QPainterPath jest
+// współdzielony niejawnie, więc kopia jest tania i bezpieczna między wątkami.
+struct TileShape {
+    const DeviceTemplate* tpl = nullptr;  // korpus urządzenia (DeviceBodyItem)
+    QString               title;
+    QPainterPath          path;           // mostek (gdy brak szablonu)
+    QPen                  pen;
+    QPointF               pos;
+};
+
+// Bufor kafli statycznej zawartości sceny.
+// Kafle TILE_PX x TILE_PX pikseli urządzenia są renderowane w tle dla bieżącej
+// skali i tylko kopiowane przy odświeżaniu widoku. Brakujący kafel jest
+// zamawiany w puli wątków, a do czasu jego gotowości rysowany synchronicznie.
+class TileCache : public QObject {
+    Q_OBJECT
+public:
+    // Zwraca (w wątku GUI) statyczną grafikę przecinającą prostokąt sceny, w kolejności Z
+    using SnapshotFn = std::function<QVector<TileShape>(const QRectF& sceneRect)>;
+
+    static constexpr int TILE_PX       = 256;
+    static constexpr int MAX_CACHE_MB  = 128;
+
+    explicit TileCache(SnapshotFn snapshot, QObject* parent = nullptr);
+    ~TileCache() override;
+
+    // Rysuje kafle pokrywające „exposed” (painter we współrzędnych sceny)
+    void draw(QPainter* p, const QRectF& exposed, qreal scale, qreal dpr);
+
+    // Zawartość w prostokącie sceny się zmieniła — unieważnij kafle i zlecenia w locie
+    void invalidate(const QRectF& sceneRect);
+    void clear();
+
+    static void paintShapes(QPainter& p, const QVector<TileShape>& shapes, qreal lod);
+
+signals:
+    void tileReady(const QRectF& sceneRect);
+
+private:
+    // Skala jest kwantowana do drabinki potęg √2 (ZOOM_STEPS szczebli na podwojenie):
+    // kafle jednego szczebla służą całemu przedziałowi skal, więc przybliżanie
+    // kółkiem (×1.15 na ząbek) trafia w gotowe kafle zamiast zamawiać nowe.
+    // Kafel rysowany jest dla szczebla nad bieżącą skalą i tylko zmniejszany.
+    static constexpr int ZOOM_STEPS = 2;
+
+    static quint64 keyOf(int zoom, int tx, int ty);
+    static int     zoomOf(qreal scale);
+    static qreal   scaleOf(int zoom);
+    static QRectF  tileRect(int tx, int ty, qreal scale);
+    static QRectF  rectOfKey(quint64 key);
+
+    void request(quint64 key, const QRectF& sceneRect, qreal scale, qreal dpr);
+    void onRendered(quint64 key, quint64 generation, const QImage& img);
+
+    SnapshotFn                 m_snapshot;
+    QCache<quint64, QImage>    m_tiles;          // koszt w KB
+    QHash<quint64, quint64>    m_pending;        // kafel -> generacja zlecenia
+    quint64                    m_generation = 0;
+    QThreadPool                m_pool;           // ostatni — niszczony pierwszy (czeka na zadania)
+};
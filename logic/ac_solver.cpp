@@ -0,0 +1,354 @@
+#include "ac_solver.h"
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+AcSolver::Complex sourceEmf(const QString& pin) {
+    double deg = 0.0;                                   // L1 (i nieoznaczone)
+    if      (pin.endsWith(QLatin1String("L2"))) deg = -120.0;
+    else if (pin.endsWith(QLatin1String("L3"))) deg =  120.0;
+    return std::polar(AcSolver::PHASE_VOLTAGE, deg * PI / 180.0);
+}
+
+// Union-find po numerach pinów (kompresja ścieżek przez połowienie)
+int findRoot(QVector<int>& parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+} // namespace
+
+// ===================== Struktura =====================
+void AcSolver::setTopology(const QVector<Edge>& edges, const QSet<QString>& nodes,
+                           const QVector<Coil>& coils, const QVector<Motor>& motors) {
+    QElapsedTimer clock;
+    clock.start();
+    *this = AcSolver();
+
+    // 1) Piny -> węzły: przewody i mostki scalają
+    QHash<QString, int> pins;
+    QVector<int> parent;
+    auto pinId = [&](const QString& p) {
+        const auto it = pins.constFind(p);
+        if (it != pins.constEnd()) return it.value();
+        const int id = parent.size();
+        pins.insert(p, id);
+        parent.push_back(id);
+        return id;
+    };
+    pins.reserve(nodes.size());
+    for (const QString& n : nodes) pinId(n);
+    for (const Edge& e : edges) {
+        const int a = pinId(e.a);
+        const int b = pinId(e.b);
+        if (e.owner.isEmpty() && a != b) parent[findRoot(parent, a)] = findRoot(parent, b);
+    }
+    for (const Coil& c : coils) { pinId(c.a); pinId(c.b); }
+    for (const Motor& m : motors) { pinId(m.u); pinId(m.v); pinId(m.w); }
+
+    QVector<int> netOfRoot(parent.size(), -1);
+    m_net.reserve(pins.size());
+    for (auto it = pins.constBegin(); it != pins.constEnd(); ++it) {
+        int& net = netOfRoot[findRoot(parent, it.value())];
+        if (net < 0) net = m_n++;
+        m_net.insert(it.key(), net);
+    }
+    const int firstStar = m_n;
+    m_n += motors.size();                               // punkt gwiazdy każdego silnika
+
+    // 2) Wzorzec: gałęzie między węzłami (pozycje w Ax uzupełniane po zbudowaniu CSR)
+    QVector<QVector<int>> adj(m_n);
+    auto branch = [&](int i, int j) {
+        if (i != j) { adj[i].push_back(j); adj[j].push_back(i); }
+        return Branch{ i, j, -1, -1, -1, -1 };
+    };
+    for (const Edge& e : edges) {
+        if (e.owner.isEmpty() || !(e.a < e.b)) continue;    // para zapisana w obie strony
+        m_switchBranch.push_back(branch(m_net.value(e.a), m_net.value(e.b)));
+        m_switchCond.push_back(e.conducts);
+        m_switchName.push_back(QStringLiteral("%1 %2-%3").arg(e.owner,
+                               e.a.startsWith(e.owner) ? e.a.mid(e.owner.size()) : e.a,
+                               e.b.startsWith(e.owner) ? e.b.mid(e.owner.size()) : e.b));
+    }
+    for (const Coil& c : coils) {
+        m_coilBranch.push_back(branch(m_net.value(c.a), m_net.value(c.b)));
+        m_coilName.push_back(c.owner);
+    }
+    for (int k = 0; k < motors.size(); ++k) {
+        const Motor& m = motors[k];
+        for (const QString& p : { m.u, m.v, m.w })
+            m_motorBranch.push_back(branch(m_net.value(p), firstStar + k));
+        m_motorLoad.push_back(m.load);
+        m_motorName.push_back(m.owner);
+    }
+
+    // 3) CSR pełnej macierzy (z przekątną), wiersze posortowane
+    m_Ap.resize(m_n + 1);
+    m_Ap[0] = 0;
+    for (int i = 0; i < m_n; ++i) {
+        QVector<int>& row = adj[i];
+        row.push_back(i);
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+        m_Ap[i + 1] = m_Ap[i] + row.size();
+    }
+    m_Ai.reserve(m_Ap[m_n]);
+    for (const QVector<int>& row : std::as_const(adj)) m_Ai += row;
+    m_Ax.resize(m_Ai.size());
+    m_diag.resize(m_n);
+    for (int i = 0; i < m_n; ++i) m_diag[i] = position(i, i);
+
+    auto locate = [this](QVector<Branch>& list) {
+        for (Branch& b : list) {
+            if (b.i == b.j) continue;                   // zwarty przewodem — bez wpisu
+            b.ii = m_diag[b.i];
+            b.jj = m_diag[b.j];
+            b.ij = position(b.i, b.j);
+            b.ji = position(b.j, b.i);
+        }
+    };
+    locate(m_switchBranch);
+    locate(m_coilBranch);
+    locate(m_motorBranch);
+
+    // 4) Porządek eliminacji i faktoryzacja symboliczna — raz na topologię
+    for (int i = 0; i < m_n; ++i) adj[i].removeOne(i);
+    order(adj);
+    symbolic();
+
+    m_b.resize(m_n);
+    m_V.resize(m_n);
+    m_hasTopology = true;
+    m_result.nodes = m_n;
+    m_result.nnzL = m_Lp.isEmpty() ? 0 : m_Lp[m_n];
+    m_result.symbolicMs = clock.nsecsElapsed() / 1e6;
+}
+
+int AcSolver::position(int row, int col) const {
+    const auto first = m_Ai.constBegin() + m_Ap[row];
+    const auto last  = m_Ai.constBegin() + m_Ap[row + 1];
+    const auto it = std::lower_bound(first, last, col);
+    return (it != last && *it == col) ? int(it - m_Ai.constBegin()) : -1;
+}
+
+// Minimalny stopień na grafie eliminacji: wierzchołek o najmniejszej liczbie
+// sąsiadów idzie pierwszy, jego sąsiedzi tworzą klikę (wypełnienie).
+// Kolejka z leniwymi wpisami — nieaktualne stopnie są pomijane przy zdjęciu.
+void AcSolver::order(const QVector<QVector<int>>& adj0) {
+    const int n = m_n;
+    std::vector<std::vector<int>> adj(n);
+    for (int i = 0; i < n; ++i) adj[i].assign(adj0[i].begin(), adj0[i].end());
+
+    using Item = std::pair<int, int>;                   // (stopień, węzeł)
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    for (int i = 0; i < n; ++i) queue.push({ int(adj[i].size()), i });
+
+    std::vector<char> done(n, 0);
+    std::vector<int> merged;
+    m_P.clear();
+    m_P.reserve(n);
+    while (!queue.empty()) {
+        const auto [deg, v] = queue.top();
+        queue.pop();
+        if (done[v] || deg != int(adj[v].size())) continue;
+        done[v] = 1;
+        m_P.push_back(v);
+
+        const std::vector<int> nb = std::move(adj[v]);
+        adj[v] = {};
+        for (int u : nb) {
+            merged.clear();
+            std::set_union(adj[u].begin(), adj[u].end(), nb.begin(), nb.end(), std::back_inserter(merged));
+            merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                        [u, v](int x) { return x == u || x == v; }), merged.end());
+            adj[u].swap(merged);
+            queue.push({ int(adj[u].size()), u });
+        }
+    }
+
+    m_Pinv.resize(n);
+    for (int k = 0; k < n; ++k) m_Pinv[m_P[k]] = k;
+}
+
+// Drzewo eliminacji i liczby niezerowych w kolumnach L (górny trójkąt P·Y·Pᵀ)
+void AcSolver::symbolic() {
+    const int n = m_n;
+    QVector<int> lnz(n, 0), flag(n);
+    m_parent.resize(n);
+    for (int k = 0; k < n; ++k) {
+        m_parent[k] = -1;
+        flag[k] = k;
+        const int kk = m_P[k];
+        for (int p = m_Ap[kk]; p < m_Ap[kk + 1]; ++p) {
+            for (int i = m_Pinv[m_Ai[p]]; i < k && flag[i] != k; i = m_parent[i]) {
+                if (m_parent[i] == -1) m_parent[i] = k;
+                ++lnz[i];
+                flag[i] = k;
+            }
+        }
+    }
+    m_Lp.resize(n + 1);
+    m_Lp[0] = 0;
+    for (int k = 0; k < n; ++k) m_Lp[k + 1] = m_Lp[k] + lnz[k];
+    m_Li.resize(m_Lp[n]);
+    m_Lx.resize(m_Lp[n]);
+    m_D.resize(n);
+}
+
+// ===================== Stan =====================
+// Faktoryzacja numeryczna „od góry”: wiersz k macierzy L z rozwiązania trójkątnego
+// po wzorcu wyznaczonym drzewem eliminacji
+bool AcSolver::numeric() {
+    const int n = m_n;
+    QVector<Complex> y(n);
+    QVector<int> pattern(n), flag(n), lnz(n);
+    for (int k = 0; k < n; ++k) {
+        y[k] = 0.0;
+        int top = n;
+        flag[k] = k;
+        lnz[k] = 0;
+        const int kk = m_P[k];
+        for (int p = m_Ap[kk]; p < m_Ap[kk + 1]; ++p) {
+            int i = m_Pinv[m_Ai[p]];
+            if (i > k) continue;
+            y[i] += m_Ax[p];
+            int len = 0;
+            for (; flag[i] != k; i = m_parent[i]) {
+                pattern[len++] = i;
+                flag[i] = k;
+            }
+            while (len > 0) pattern[--top] = pattern[--len];
+        }
+        m_D[k] = y[k];
+        y[k] = 0.0;
+        for (; top < n; ++top) {
+            const int i = pattern[top];
+            const Complex yi = y[i];
+            y[i] = 0.0;
+            const int p2 = m_Lp[i] + lnz[i];
+            for (int p = m_Lp[i]; p < p2; ++p) y[m_Li[p]] -= m_Lx[p] * yi;
+            const Complex lki = yi / m_D[i];
+            m_D[k] -= lki * yi;
+            m_Li[p2] = k;
+            m_Lx[p2] = lki;
+            ++lnz[i];
+        }
+        if (m_D[k] == Complex(0.0)) return false;
+    }
+    return true;
+}
+
+void AcSolver::stamp(const Branch& b, Complex y) {
+    if (b.ii < 0) return;
+    m_Ax[b.ii] += y;
+    m_Ax[b.jj] += y;
+    m_Ax[b.ij] -= y;
+    m_Ax[b.ji] -= y;
+}
+
+bool AcSolver::solve(const QSet<QString>& phaseSources, const QSet<QString>& neutralSources, QString* error) {
+    if (!m_hasTopology) {
+        if (error) *error = QStringLiteral("brak topologii");
+        return false;
+    }
+    QElapsedTimer clock;
+    clock.start();
+
+    // 1) Wartości na stałym wzorcu
+    std::fill(m_Ax.begin(), m_Ax.end(), Complex(0.0));
+    std::fill(m_b.begin(), m_b.end(), Complex(0.0));
+    for (int d : std::as_const(m_diag)) m_Ax[d] = G_MIN;
+
+    const Complex yClosed = 1.0 / CONTACT_R;
+    for (int s = 0; s < m_switchBranch.size(); ++s)
+        if (m_switchCond[s] && m_switchCond[s]()) stamp(m_switchBranch[s], yClosed);
+
+    const Complex yCoil = 1.0 / Complex(COIL_R, COIL_X);
+    for (const Branch& b : std::as_const(m_coilBranch)) stamp(b, yCoil);
+
+    const Complex yMotor = 1.0 / Complex(MOTOR_R, MOTOR_X);
+    QVector<Complex> motorY(m_motorLoad.size());
+    for (int k = 0; k < m_motorLoad.size(); ++k) {
+        const double load = m_motorLoad[k] ? m_motorLoad[k]() : 1.0;
+        motorY[k] = yMotor * std::max(load, MIN_LOAD);
+        for (int ph = 0; ph < 3; ++ph) stamp(m_motorBranch[3 * k + ph], motorY[k]);
+    }
+
+    const Complex ySource = 1.0 / Complex(SOURCE_R, SOURCE_X);
+    for (const QString& pin : phaseSources) {
+        const int i = m_net.value(pin, -1);
+        if (i < 0) continue;
+        m_Ax[m_diag[i]] += ySource;
+        m_b[i] += sourceEmf(pin) * ySource;
+    }
+    for (const QString& pin : neutralSources) {
+        const int i = m_net.value(pin, -1);
+        if (i >= 0) m_Ax[m_diag[i]] += ySource;
+    }
+
+    // 2) L·D·Lᵀ na gotowym wzorcu + podstawienia
+    if (!numeric()) {
+        if (error) *error = QStringLiteral("macierz osobliwa");
+        return false;
+    }
+    const int n = m_n;
+    QVector<Complex> x(n);
+    for (int k = 0; k < n; ++k) x[k] = m_b[m_P[k]];
+    for (int j = 0; j < n; ++j)
+        for (int p = m_Lp[j]; p < m_Lp[j + 1]; ++p) x[m_Li[p]] -= m_Lx[p] * x[j];
+    for (int j = 0; j < n; ++j) x[j] /= m_D[j];
+    for (int j = n - 1; j >= 0; --j)
+        for (int p = m_Lp[j]; p < m_Lp[j + 1]; ++p) x[j] -= m_Lx[p] * x[m_Li[p]];
+    for (int k = 0; k < n; ++k) m_V[m_P[k]] = x[k];
+
+    // 3) Odczyty
+    Result& r = m_result;
+    r.sources.clear();
+    r.coils.clear();
+    r.motors.clear();
+    r.contacts.clear();
+    for (const QString& pin : phaseSources) {
+        const int i = m_net.value(pin, -1);
+        if (i >= 0) r.sources.push_back({ pin, std::abs((sourceEmf(pin) - m_V[i]) * ySource) });
+    }
+    for (const QString& pin : neutralSources) {
+        const int i = m_net.value(pin, -1);
+        if (i >= 0) r.sources.push_back({ pin, std::abs(m_V[i] * ySource) });
+    }
+    for (int c = 0; c < m_coilBranch.size(); ++c) {
+        const Branch& b = m_coilBranch[c];
+        r.coils.push_back({ m_coilName[c], std::abs(m_V[b.i] - m_V[b.j]) });
+    }
+    for (int k = 0; k < m_motorName.size(); ++k) {
+        double amps = 0.0;
+        for (int ph = 0; ph < 3; ++ph) {
+            const Branch& b = m_motorBranch[3 * k + ph];
+            amps = std::max(amps, std::abs((m_V[b.i] - m_V[b.j]) * motorY[k]));
+        }
+        r.motors.push_back({ m_motorName[k], amps });
+    }
+    for (int s = 0; s < m_switchBranch.size(); ++s) {
+        const Branch& b = m_switchBranch[s];
+        if (b.i == b.j || !m_switchCond[s] || !m_switchCond[s]()) continue;
+        r.contacts.push_back({ m_switchName[s], std::abs((m_V[b.i] - m_V[b.j]) * yClosed) });
+    }
+    r.numericMs = clock.nsecsElapsed() / 1e6;
+    return true;
+}
+
+AcSolver::Complex AcSolver::voltage(const QString& pin) const {
+    const int i = m_net.value(pin, -1);
+    return i < 0 ? Complex(0.0) : m_V[i];
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include <complex>
+#include <functional>
+
+#include "propagation.h"
+
+// Opcjonalna analiza AC (stan ustalony 50 Hz): napięcia węzłów i prądy
+// z zespolonej macierzy admitancji Y·V = I dla bieżącej topologii.
+//
+// Przewody i mostki (krawędzie bez właściciela) są idealne — piny scala
+// union-find w węzły. Styki to przełączniki: zamknięty 1/CONTACT_R, otwarty 0,
+// ale ich miejsce w macierzy istnieje zawsze, więc wzorzec nie zależy od stanu
+// styczników ani źródeł. Cewki i fazy silników (gwiazda z własnym punktem
+// wspólnym) to impedancje, źródła — zastępczo Norton z impedancją sieci do
+// ziemi (punktu zerowego), każdy węzeł ma upływ G_MIN (węzły pływające).
+//
+// Y jest zespolona symetryczna (Y = Yᵀ) i bez przestawień rozkłada się jako
+// L·D·Lᵀ. setTopology() robi raz porządek minimalnego stopnia i faktoryzację
+// symboliczną (drzewo eliminacji, wzorzec L); solve() dla każdego stanu tylko
+// wpisuje wartości, liczy faktoryzację numeryczną i podstawienia.
+class AcSolver {
+public:
+    using Complex = std::complex<double>;
+
+    static constexpr double PHASE_VOLTAGE = 230.0;                  // V, faza–N
+    static constexpr double SOURCE_R  = 0.05,   SOURCE_X  = 0.10;    // Ω sieci na źródło
+    static constexpr double CONTACT_R = 1e-3;                       // Ω zamkniętego styku
+    static constexpr double G_MIN     = 1e-9;                       // S upływu węzła
+    static constexpr double COIL_R    = 2565.0, COIL_X    = 7048.0;  // Ω: ~7 VA przy 230 V
+    static constexpr double MOTOR_R   = 23.0,   MOTOR_X   = 14.2;    // Ω/fazę przy Ir (4 kW, 400 V)
+    static constexpr double MIN_LOAD  = 0.05;                       // silnik bez obciążenia
+
+    struct Coil  { QString owner, a, b; };
+    struct Motor { QString owner, u, v, w; std::function<double()> load; };   // load: prąd / Ir
+
+    struct Reading { QString name; double value; };                 // A albo V
+    struct Result {
+        QVector<Reading> sources;        // prąd każdego źródła [A]
+        QVector<Reading> coils;          // napięcie na cewce [V]
+        QVector<Reading> motors;         // największy prąd fazowy [A]
+        QVector<Reading> contacts;       // prąd zamkniętego styku [A] ("K1_ 1-2")
+        int     nodes = 0;
+        int     nnzL = 0;
+        double  symbolicMs = 0.0;        // ostatnie setTopology()
+        double  numericMs = 0.0;         // faktoryzacja + podstawienia
+    };
+
+    // Struktura po edycji schematu: węzły, elementy, wzorzec, porządek, faktoryzacja symboliczna
+    void setTopology(const QVector<Edge>& edges, const QSet<QString>& nodes,
+                     const QVector<Coil>& coils, const QVector<Motor>& motors);
+    bool hasTopology() const { return m_hasTopology; }
+
+    // Bieżący stan: styki z warunków krawędzi, obciążenia silników, źródła
+    bool solve(const QSet<QString>& phaseSources, const QSet<QString>& neutralSources,
+               QString* error = nullptr);
+
+    Complex       voltage(const QString& pin) const;                // względem punktu zerowego sieci
+    const Result& result() const { return m_result; }
+
+private:
+    struct Branch { int i, j; int ii, jj, ij, ji; };                // węzły i pozycje w Ax
+
+    int  position(int row, int col) const;
+    void order(const QVector<QVector<int>>& adj);
+    void symbolic();
+    bool numeric();
+    void stamp(const Branch& b, Complex y);
+
+    bool                 m_hasTopology = false;
+    QHash<QString, int>  m_net;          // pin -> węzeł macierzy
+    int                  m_n = 0;
+
+    // Elementy (węzły i pozycje wpisów ustalone w setTopology)
+    QVector<Branch>                 m_switchBranch;
+    QVector<std::function<bool()>>  m_switchCond;
+    QVector<QString>                m_switchName;
+    QVector<Branch>                 m_coilBranch;
+    QVector<QString>                m_coilName;
+    QVector<Branch>                 m_motorBranch;    // 3 na silnik (U, V, W do gwiazdy)
+    QVector<std::function<double()>> m_motorLoad;
+    QVector<QString>                m_motorName;
+
+    // Y w CSR (pełna, symetryczna strukturalnie; wiersze posortowane)
+    QVector<int>     m_Ap;
+    QVector<int>     m_Ai;
+    QVector<Complex> m_Ax;
+    QVector<int>     m_diag;          // pozycja (i,i) w Ax
+
+    // Porządek eliminacji i faktoryzacja L·D·Lᵀ (styl LDL: drzewo eliminacji + wzorzec)
+    QVector<int>     m_P;             // k-ty eliminowany -> węzeł
+    QVector<int>     m_Pinv;
+    QVector<int>     m_parent;
+    QVector<int>     m_Lp;
+    QVector<int>     m_Li;
+    QVector<Complex> m_Lx;
+    QVector<Complex> m_D;
+
+    QVector<Complex> m_b;
+    QVector<Complex> m_V;
+    Result           m_result;
+};
@@ -0,0 +1,255 @@
+#include "autosave.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr char MAGIC[8]    = { 'C', 'N', 'E', 'T', 'J', 'R', 'N', '\0' };
+constexpr int  HEADER_SIZE = 24;
+constexpr auto STREAM_VERSION = QDataStream::Qt_5_12;
+constexpr char LOCK_NAME[] = "session.lock";
+
+QByteArray header(quint64 seq) {
+    QByteArray h(HEADER_SIZE, '\0');
+    uchar* p = reinterpret_cast<uchar*>(h.data());
+    std::memcpy(p, MAGIC, sizeof(MAGIC));
+    qToLittleEndian<quint32>(Autosave::VERSION, p + 8);
+    qToLittleEndian<quint64>(seq, p + 16);
+    return h;
+}
+
+void encode(QByteArray& out, const UndoJournal::Entry& e) {
+    QByteArray payload;
+    {
+        QDataStream s(&payload, QIODevice::WriteOnly);
+        s.setVersion(STREAM_VERSION);
+        s << e.label << quint32(e.deltas.size());
+        for (const UndoJournal::Delta& d : e.deltas) {
+            s << quint8(d.op) << d.neutral << d.on
+              << quint8(d.device.kind) << qint32(d.device.index) << d.device.topLeft << d.device.type
+              << d.a << d.b << d.points;
+        }
+    }
+    uchar len[4];
+    qToLittleEndian<quint32>(quint32(payload.size()), len);
+    out.append(reinterpret_cast<const char*>(len), 4);
+    out.append(payload);
+}
+
+// version 1: bez typu z katalogu (i bez rodzaju Catalog)
+bool decode(const QByteArray& payload, quint32 version, UndoJournal::Entry& e) {
+    QDataStream s(payload);
+    s.setVersion(STREAM_VERSION);
+    quint32 n = 0;
+    s >> e.label >> n;
+    if (s.status() != QDataStream::Ok || n > quint32(payload.size())) return false;
+    e.deltas.resize(int(n));
+    const auto lastKind = version >= 2 ? ProjectFile::DeviceKind::Catalog : ProjectFile::DeviceKind::Motor3;
+    for (UndoJournal::Delta& d : e.deltas) {
+        quint8 op = 0, kind = 0;
+        qint32 index = 0;
+        s >> op >> d.neutral >> d.on >> kind >> index >> d.device.topLeft;
+        if (version >= 2) s >> d.device.type;
+        s >> d.a >> d.b >> d.points;
+        if (op > quint8(UndoJournal::Op::SetSource) || kind > quint8(lastKind))
+            return false;
+        d.op = UndoJournal::Op(op);
+        d.device.kind = ProjectFile::DeviceKind(kind);
+        d.device.index = index;
+    }
+    return s.status() == QDataStream::Ok;
+}
+
+void removeCheckpoints(const QString& dir, const QString& keep = QString()) {
+    const QDir d(dir);
+    for (const QString& name : d.entryList({ QStringLiteral("checkpoint-*.cnp") }, QDir::Files))
+        if (name != keep) QFile::remove(d.filePath(name));
+}
+
+// Blokada bez limitu wieku: za nieaktualną uchodzi tylko blokada martwego procesu
+std::unique_ptr<QLockFile> lockOf(const QString& dir) {
+    auto lock = std::make_unique<QLockFile>(QDir(dir).filePath(QLatin1String(LOCK_NAME)));
+    lock->setStaleLockTime(0);
+    return lock;
+}
+
+} // namespace
+
+Autosave::Autosave(const QString& root)
+    : m_root(root)
+    , m_dir(QDir(root).filePath(QStringLiteral("session-%1-%2")
+                                    .arg(QCoreApplication::applicationPid())
+                                    .arg(QDateTime::currentMSecsSinceEpoch())))
+{
+    m_pool.setMaxThreadCount(1);     // zadania plikowe ściśle po kolei
+    QDir().mkpath(m_dir);
+    m_lock = lockOf(m_dir);
+    m_lock->tryLock(0);              // nowy katalog: nikt inny go nie zna
+}
+
+Autosave::~Autosave() {
+    flush();
+    m_pool.waitForDone();
+    m_lock->unlock();
+    QDir().rmdir(m_dir);             // tylko pusty — po discard(); po awarii pliki zostają
+}
+
+QString Autosave::journalPath(const QString& dir) {
+    return QDir(dir).filePath(QStringLiteral("journal.cnj"));
+}
+
+QString Autosave::checkpointPath(const QString& dir, quint64 seq) {
+    return QDir(dir).filePath(QStringLiteral("checkpoint-%1.cnp").arg(seq));
+}
+
+void Autosave::append(const UndoJournal::Entry& e) {
+    if (!m_active || e.deltas.isEmpty()) return;
+    encode(m_pending, e);
+    ++m_ops;
+}
+
+void Autosave::flush() {
+    if (!m_active || m_pending.isEmpty()) return;
+    const QByteArray bytes = std::exchange(m_pending, {});
+    const QString path = journalPath(m_dir);
+    m_pool.start([this, path, bytes] {
+        if (!m_journalReady) return;     // bez nagłówka (pierwszy punkt się nie udał) nic do odtworzenia
+        QFile f(path);
+        if (f.open(QIODevice::WriteOnly | QIODevice::Append)) f.write(bytes);
+    });
+}
+
+// Nieudany zapis punktu zostawia poprzednią parę (punkt + dziennik) — dopisywanie trwa dalej
+void Autosave::checkpoint(ProjectFile::Data data) {
+    flush();
+    m_seq = qMax(quint64(QDateTime::currentMSecsSinceEpoch()), m_seq + 1);
+    m_ops = 0;
+    m_active = true;
+
+    const QString dir = m_dir;
+    const quint64 seq = m_seq;
+    m_pool.start([this, dir, seq, data = std::move(data)] {
+        QDir().mkpath(dir);
+        const QString ckpt = checkpointPath(dir, seq);
+        if (!ProjectFile::save(ckpt, data)) return;
+
+        QSaveFile journal(journalPath(dir));
+        if (!journal.open(QIODevice::WriteOnly)) return;
+        journal.write(header(seq));
+        if (!journal.commit()) return;
+        m_journalReady = true;
+
+        removeCheckpoints(dir, QFileInfo(ckpt).fileName());
+    });
+
+    // Stan nowej sesji zapisany: przejęta sesja (odtworzona albo odrzucona) nie jest już potrzebna
+    if (m_claimed) {
+        std::shared_ptr<QLockFile> lock = std::move(m_claimed);
+        const QString claimed = std::exchange(m_claimedDir, {});
+        m_pool.start([lock, claimed] {
+            QFile::remove(journalPath(claimed));
+            removeCheckpoints(claimed);
+            lock->unlock();
+            QDir().rmdir(claimed);
+        });
+    }
+}
+
+void Autosave::discard() {
+    m_active = false;
+    m_pending.clear();
+    m_ops = 0;
+    const QString dir = m_dir;
+    m_pool.start([this, dir] {
+        m_journalReady = false;
+        QFile::remove(journalPath(dir));
+        removeCheckpoints(dir);
+    });
+}
+
+QString Autosave::claimRecovery() {
+    QString   best;
+    QDateTime bestTime;
+    std::unique_ptr<QLockFile> bestLock;
+    const QDir root(m_root);
+    const QStringList sessions = root.entryList({ QStringLiteral("session-*") }, QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& name : sessions) {
+        const QString dir = root.filePath(name);
+        if (dir == m_dir || dir == m_claimedDir) continue;
+        auto lock = lockOf(dir);
+        if (!lock->tryLock(0)) continue;                 // sesja innego, działającego programu
+        if (!hasRecovery(dir)) {
+            // porzucona przed pierwszym punktem kontrolnym — nic do odzyskania
+            std::shared_ptr<QLockFile> held = std::move(lock);
+            m_pool.start([held, dir] {
+                removeCheckpoints(dir);
+                QFile::remove(journalPath(dir));
+                held->unlock();
+                QDir().rmdir(dir);
+            });
+            continue;
+        }
+        const QDateTime time = QFileInfo(journalPath(dir)).lastModified();
+        if (bestLock && time <= bestTime) continue;      // starsze zostają na następne uruchomienie
+        best = dir;
+        bestTime = time;
+        bestLock = std::move(lock);
+    }
+    if (!bestLock) return QString();
+    m_claimed = std::move(bestLock);
+    m_claimedDir = best;
+    return best;
+}
+
+bool Autosave::hasRecovery(const QString& dir) {
+    return QFileInfo(journalPath(dir)).size() >= HEADER_SIZE;
+}
+
+Autosave::Recovery Autosave::readRecovery(const QString& dir) {
+    Recovery r;
+    QFile f(journalPath(dir));
+    if (!f.open(QIODevice::ReadOnly)) {
+        r.error = f.errorString();
+        return r;
+    }
+    const QByteArray all = f.readAll();
+    const uchar* p = reinterpret_cast<const uchar*>(all.constData());
+    if (all.size() < HEADER_SIZE || std::memcmp(p, MAGIC, sizeof(MAGIC)) != 0) {
+        r.error = QObject::tr("To nie jest dziennik autozapisu");
+        return r;
+    }
+    const quint32 version = qFromLittleEndian<quint32>(p + 8);
+    if (version == 0 || version > VERSION) {       // starsze dzienniki odczytujemy (awaria przed aktualizacją)
+        r.error = QObject::tr("Nieobsługiwana wersja dziennika: %1").arg(version);
+        return r;
+    }
+    r.checkpoint = checkpointPath(dir, qFromLittleEndian<quint64>(p + 16));
+    if (!QFile::exists(r.checkpoint)) {
+        r.error = QObject::tr("Brak punktu kontrolnego %1").arg(r.checkpoint);
+        return r;
+    }
+
+    // Rekordy do pierwszego niepełnego (awaria w trakcie dopisywania)
+    qint64 pos = HEADER_SIZE;
+    while (pos < all.size()) {
+        if (pos + 4 > all.size()) { r.truncated = true; break; }
+        const quint32 len = qFromLittleEndian<quint32>(p + pos);
+        if (pos + 4 + qint64(len) > all.size()) { r.truncated = true; break; }
+        UndoJournal::Entry e;
+        if (!decode(all.mid(int(pos + 4), int(len)), version, e)) { r.truncated = true; break; }
+        r.entries.push_back(std::move(e));
+        pos += 4 + len;
+    }
+    return r;
+}
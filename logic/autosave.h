@@ -0,0 +1,79 @@
+#pragma once
+#include <QByteArray>
+#include <QLockFile>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include <memory>
+
+#include "project_file.h"
+#include "undo_journal.h"
+
+// Autozapis jako dziennik dopisywany w tle + okresowy punkt kontrolny.
+//
+//   journal.cnj       nagłówek { magic "CNETJRN\0", u32 wersja, u32 0, u64 numer punktu }
+//                     i rekordy { u32 długość, wpis UndoJournal (QDataStream) }
+//   checkpoint-N.cnp  pełny stan w formacie ProjectFile, od którego liczy się dziennik
+//
+// Wątek GUI tylko koduje wpisy do bufora; dopisywanie, kompaktowanie i usuwanie
+// plików idą kolejno (pula z jednym wątkiem) poza wątkiem GUI. Kompaktowanie:
+// nowy punkt kontrolny, potem atomowa podmiana dziennika na pusty z jego numerem,
+// na końcu usunięcie starego punktu — awaria w dowolnym miejscu zostawia spójną parę.
+//
+// Każda sesja (uruchomiony program) pisze do własnego katalogu session-<pid>-<czas>
+// pod katalogiem głównym i trzyma w nim blokadę (QLockFile) do końca działania.
+// Odzyskiwanie bierze tylko sesje, których blokadę da się przejąć — czyli po
+// procesach, które już nie żyją; cudzego, żywego dziennika nie rusza.
+class Autosave {
+public:
+    static constexpr quint32 VERSION = 2;            // 2: typ urządzenia z katalogu w delcie (1 nadal czytany)
+    static constexpr int     COMPACT_OPS = 500;        // wpisów do kolejnego punktu kontrolnego
+
+    explicit Autosave(const QString& root);           // katalog główny wszystkich sesji
+    ~Autosave();                                       // czeka na zapisy w tle, zwalnia blokadę
+
+    Autosave(const Autosave&) = delete;
+    Autosave& operator=(const Autosave&) = delete;
+
+    // ---- sesja (wątek GUI)
+    void append(const UndoJournal::Entry& e);          // tylko kodowanie do bufora
+    void flush();                                      // bufor -> dopisanie w tle
+    void checkpoint(ProjectFile::Data data);           // pełny stan + pusty dziennik, w tle; usuwa przejętą sesję
+    void discard();                                    // czyste zamknięcie: pliki usuwane w tle
+    int  opsSinceCheckpoint() const { return m_ops; }
+    const QString& dir() const { return m_dir; }       // katalog tej sesji
+    bool isActive() const { return m_active; }
+
+    // ---- odzyskiwanie (dowolny wątek)
+    struct Recovery {
+        QString                   error;               // niepuste = dziennik nieczytelny
+        QString                   checkpoint;          // plik .cnp, od którego odtwarzać
+        QVector<UndoJournal::Entry> entries;
+        bool                      truncated = false;   // urwany ostatni rekord (pominięty)
+    };
+    static bool     hasRecovery(const QString& dir);
+    static Recovery readRecovery(const QString& dir);
+
+    // Najnowsza porzucona sesja z dziennikiem (wątek GUI): blokada zostaje przy
+    // nas do najbliższego checkpoint(), który usuwa jej pliki. Pusty = brak.
+    QString claimRecovery();
+    const QString& recoveryDir() const { return m_claimedDir; }
+
+    static QString journalPath(const QString& dir);
+    static QString checkpointPath(const QString& dir, quint64 seq);
+
+private:
+    QString     m_root;
+    QString     m_dir;
+    std::unique_ptr<QLockFile> m_lock;                 // blokada katalogu tej sesji
+    QString     m_claimedDir;                          // przejęta sesja do odzyskania
+    std::unique_ptr<QLockFile> m_claimed;
+    QByteArray  m_pending;                             // zakodowane wpisy czekające na dopisanie
+    int         m_ops = 0;
+    quint64     m_seq = 0;                             // numer ostatniego punktu kontrolnego
+    bool        m_active = false;
+    bool        m_journalReady = false;                // nagłówek zapisany — tylko w zadaniach puli
+
+    QThreadPool m_pool;                                // ostatni — niszczony pierwszy (czeka na zadania)
+};
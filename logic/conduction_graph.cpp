@@ -0,0 +1,231 @@
+#include "conduction_graph.h"
+#include "parallel_for.h"
+#include <QThread>
+#include <QThreadPool>
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Własna pula: zadania BFS nie czekają za wczytywaniem czy zapisem w puli globalnej
+QThreadPool& bfsPool() {
+    static QThreadPool pool;
+    return pool;
+}
+
+} // namespace
+
+// ===================== Struktura =====================
+void ConductionGraph::build(const QVector<Edge>& edges) {
+    m_edges = edges;
+    m_id.clear();
+    m_name.clear();
+    m_switched.clear();
+    m_id.reserve(edges.size());
+
+    auto idOf = [&](const QString& pin) {
+        const auto it = m_id.constFind(pin);
+        if (it != m_id.constEnd()) return it.value();
+        const int v = m_name.size();
+        m_id.insert(pin, v);
+        m_name.push_back(pin);
+        return v;
+    };
+
+    const int m = edges.size();
+    QVector<int> from(m), to(m);
+    for (int i = 0; i < m; ++i) {
+        from[i] = idOf(edges[i].a);
+        to[i]   = idOf(edges[i].b);
+        if (edges[i].conducts) m_switched.push_back(i);
+    }
+
+    // Zliczanie + rozkład (counting sort po węźle)
+    const int n = m_name.size();
+    auto fill = [&](const QVector<int>& key, const QVector<int>& other,
+                    QVector<int>& off, QVector<int>& adj, QVector<int>& edge) {
+        off.fill(0, n + 1);
+        for (int i = 0; i < m; ++i) ++off[key[i] + 1];
+        for (int v = 0; v < n; ++v) off[v + 1] += off[v];
+        adj.resize(m);
+        edge.resize(m);
+        QVector<int> pos(off.begin(), off.end() - 1);
+        for (int i = 0; i < m; ++i) {
+            const int k = pos[key[i]]++;
+            adj[k]  = other[i];
+            edge[k] = i;
+        }
+    };
+    fill(from, to, m_outOff, m_outTo, m_outEdge);
+    fill(to, from, m_inOff, m_inFrom, m_inEdge);
+
+    m_open.fill(1, m);
+}
+
+void ConductionGraph::refresh() {
+    for (int i : std::as_const(m_switched))
+        m_open[i] = m_edges[i].conducts() ? 1 : 0;
+}
+
+// ===================== BFS =====================
+bool ConductionGraph::reach(const QVector<int>& sources, Bits& visited, const CancelToken& cancel) const {
+    if (nodeCount() < PARALLEL_MIN_NODES || QThread::idealThreadCount() < 2)
+        return reachSerial(sources, visited, cancel);
+    return reachParallel(sources, visited, cancel);
+}
+
+bool ConductionGraph::reachSerial(const QVector<int>& sources, Bits& visited, const CancelToken& cancel) const {
+    visited.fill(0, (nodeCount() + 63) >> 6);
+    QVector<int> queue;
+    for (int s : sources) {
+        if (test(visited, s)) continue;
+        visited[s >> 6] |= quint64(1) << (s & 63);
+        queue.push_back(s);
+    }
+    for (int head = 0; head < queue.size(); ++head) {
+        if ((head & (CANCEL_CHECK - 1)) == CANCEL_CHECK - 1 && cancel.isCancelled()) return false;
+        const int u = queue[head];
+        for (int k = m_outOff[u]; k < m_outOff[u + 1]; ++k) {
+            if (!m_open[m_outEdge[k]]) continue;
+            const int v = m_outTo[k];
+            if (test(visited, v)) continue;
+            visited[v >> 6] |= quint64(1) << (v & 63);
+            queue.push_back(v);
+        }
+    }
+    return true;
+}
+
+// Poziomami; front to kolejka (góra-dół) albo mapa bitowa (dół-góra)
+bool ConductionGraph::reachParallel(const QVector<int>& sources, Bits& visited, const CancelToken& cancel) const {
+    const int n = nodeCount();
+    const int words = (n + 63) >> 6;
+    const int threads = QThread::idealThreadCount();
+    const int* outOff = m_outOff.constData();
+    const int* outTo  = m_outTo.constData();
+    const int* outEdge = m_outEdge.constData();
+    const int* inOff  = m_inOff.constData();
+    const int* inFrom = m_inFrom.constData();
+    const int* inEdge = m_inEdge.constData();
+    const quint8* open = m_open.constData();
+
+    std::unique_ptr<std::atomic<quint64>[]> seen(new std::atomic<quint64>[words]);
+    for (int w = 0; w < words; ++w) seen[w].store(0, std::memory_order_relaxed);
+
+    QVector<int> queue;
+    Bits front(words, 0), next(words, 0);
+    std::vector<QVector<int>> local(threads);
+    std::vector<qint64> localEdges(threads);
+    std::vector<int>    localCount(threads);
+
+    qint64 frontEdges = 0;
+    for (int s : sources) {
+        const quint64 bit = quint64(1) << (s & 63);
+        if (seen[s >> 6].load(std::memory_order_relaxed) & bit) continue;
+        seen[s >> 6].fetch_or(bit, std::memory_order_relaxed);
+        queue.push_back(s);
+        frontEdges += degree(s);
+    }
+    qint64 edgesLeft = m_outTo.size() - frontEdges;     // krawędzie wychodzące z nieodwiedzonych
+    int  frontSize = queue.size();
+    int  prevSize = 0;
+    bool bottomUp = false;
+
+    while (frontSize > 0) {
+        if (cancel.isCancelled()) return false;      // między poziomami — pula wolna
+
+        // Kierunek na ten poziom (front rośnie -> dół-góra, maleje -> góra-dół): zamiana postaci frontu
+        const bool growing = frontSize > prevSize;
+        prevSize = frontSize;
+        if (!bottomUp && growing && frontEdges > edgesLeft / ALPHA) {
+            front.fill(0);
+            for (int v : std::as_const(queue)) front[v >> 6] |= quint64(1) << (v & 63);
+            bottomUp = true;
+        } else if (bottomUp && !growing && frontSize < n / BETA) {
+            queue.clear();
+            for (int w = 0; w < words; ++w)
+                for (quint64 bits = front[w]; bits; bits &= bits - 1)
+                    queue.push_back((w << 6) + qCountTrailingZeroBits(bits));
+            bottomUp = false;
+        }
+
+        if (!bottomUp) {
+            // Góra-dół: każdy węzeł frontu zgłasza nieodwiedzonych sąsiadów; wygrywa pierwszy fetch_or
+            const int* cur = queue.constData();
+            parallelFor(bfsPool(), queue.size(), threads, GRAIN, [&](int c, int b, int e) {
+                QVector<int>& out = local[c];
+                qint64 deg = 0;
+                for (int i = b; i < e; ++i) {
+                    const int u = cur[i];
+                    for (int k = outOff[u]; k < outOff[u + 1]; ++k) {
+                        if (!open[outEdge[k]]) continue;
+                        const int v = outTo[k];
+                        const quint64 bit = quint64(1) << (v & 63);
+                        std::atomic<quint64>& word = seen[v >> 6];
+                        if (word.load(std::memory_order_relaxed) & bit) continue;
+                        if (word.fetch_or(bit, std::memory_order_relaxed) & bit) continue;
+                        out.push_back(v);
+                        deg += outOff[v + 1] - outOff[v];
+                    }
+                }
+                localEdges[c] = deg;
+            });
+            queue.clear();
+            frontEdges = 0;
+            for (int c = 0; c < threads; ++c) {
+                queue += local[c];
+                local[c].clear();            // porcja, która na następnym poziomie nie ruszy
+                frontEdges += std::exchange(localEdges[c], 0);
+            }
+            frontSize = queue.size();
+        } else {
+            // Dół-góra: wątek ma swój zakres słów — zapis do seen/next bez wyścigów
+            const quint64* cur = front.constData();
+            quint64* nextBits = next.data();
+            parallelFor(bfsPool(), words, threads, GRAIN, [&](int c, int b, int e) {
+                int count = 0;
+                qint64 deg = 0;
+                for (int w = b; w < e; ++w) {
+                    const quint64 have = seen[w].load(std::memory_order_relaxed);
+                    quint64 found = 0;
+                    for (quint64 todo = ~have; todo; todo &= todo - 1) {
+                        const int v = (w << 6) + qCountTrailingZeroBits(todo);
+                        if (v >= n) break;
+                        for (int k = inOff[v]; k < inOff[v + 1]; ++k) {
+                            const int u = inFrom[k];
+                            if (open[inEdge[k]] && ((cur[u >> 6] >> (u & 63)) & 1)) {
+                                found |= quint64(1) << (v & 63);
+                                deg += outOff[v + 1] - outOff[v];
+                                break;
+                            }
+                        }
+                    }
+                    nextBits[w] = found;
+                    if (found) {
+                        seen[w].store(have | found, std::memory_order_relaxed);
+                        count += qPopulationCount(found);
+                    }
+                }
+                localCount[c] = count;
+                localEdges[c] = deg;
+            });
+            std::swap(front, next);
+            frontSize = 0;
+            frontEdges = 0;
+            for (int c = 0; c < threads; ++c) {
+                frontSize  += std::exchange(localCount[c], 0);
+                frontEdges += std::exchange(localEdges[c], 0);
+            }
+        }
+        edgesLeft -= frontEdges;
+    }
+
+    visited.resize(words);
+    for (int w = 0; w < words; ++w) visited[w] = seen[w].load(std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "propagation.h"
+
+// Graf przewodzenia w postaci zwartej (CSR) dla propagacji po dużych schematach.
+//
+// build() numeruje piny i układa krawędzie w tablice sąsiedztwa wychodzącego
+// i wchodzącego — tylko po zmianie struktury grafu. refresh() wylicza warunki
+// przewodzenia raz na przeliczenie i tylko dla krawędzi, które warunek mają
+// (styki); mostki przewodzą zawsze.
+//
+// reach() to BFS od wielu źródeł naraz. Poniżej PARALLEL_MIN_NODES zwykła
+// kolejka. Powyżej — BFS poziomami na puli wątków, z przełączaniem kierunku
+// (Beamer): góra-dół, gdy front jest mały (front jako kolejka, odwiedzone
+// w atomowej mapie bitowej), dół-góra, gdy front obejmuje dużą część grafu
+// (każdy nieodwiedzony węzeł szuka rodzica we froncie; wątek ma własne słowa
+// mapy, bez operacji atomowych).
+class ConductionGraph {
+public:
+    static constexpr int PARALLEL_MIN_NODES = 1 << 16;   // mniejsze grafy: ścieżka szeregowa
+    static constexpr int GRAIN = 2048;                    // min. węzłów frontu / słów mapy na zadanie
+    static constexpr int ALPHA = 14;   // góra-dół -> dół-góra: krawędzie frontu > nieodwiedzone / ALPHA
+    static constexpr int BETA  = 24;   // dół-góra -> góra-dół: front < węzły / BETA
+    static constexpr int CANCEL_CHECK = 4096;   // ścieżka szeregowa: co tyle węzłów sprawdzenie cancel
+
+    using Bits = QVector<quint64>;     // mapa bitowa węzłów (bit v = węzeł v)
+
+    void build(const QVector<Edge>& edges);    // struktura (kopia edges jest współdzielona)
+    void refresh();                            // stan styków: warunki wszystkich krawędzi z warunkiem
+
+    int  nodeCount() const { return m_name.size(); }
+    int  node(const QString& pin) const { return m_id.value(pin, -1); }
+    const QString& name(int v) const { return m_name[v]; }
+    const QHash<QString, int>& ids() const { return m_id; }
+    const QVector<Edge>& edges() const { return m_edges; }
+
+    // f(v, krawędź) dla krawędzi przewodzących teraz z u (stan z ostatniego refresh())
+    template <typename F>
+    void forEachOpen(int u, F f) const {
+        for (int k = m_outOff[u]; k < m_outOff[u + 1]; ++k)
+            if (m_open[m_outEdge[k]]) f(m_outTo[k], m_outEdge[k]);
+    }
+
+    // Węzły osiągalne ze źródeł (numery węzłów) po krawędziach przewodzących, ze źródłami;
+    // false = przerwane (cancel), visited niepełne
+    bool reach(const QVector<int>& sources, Bits& visited, const CancelToken& cancel = {}) const;
+    static bool test(const Bits& bits, int v) { return (bits[v >> 6] >> (v & 63)) & 1; }
+
+private:
+    bool reachSerial(const QVector<int>& sources, Bits& visited, const CancelToken& cancel) const;
+    bool reachParallel(const QVector<int>& sources, Bits& visited, const CancelToken& cancel) const;
+    int  degree(int v) const { return m_outOff[v + 1] - m_outOff[v]; }
+
+    QVector<Edge>        m_edges;        // warunki krawędzi (dane współdzielone z EdgeStore)
+    QHash<QString, int>  m_id;
+    QVector<QString>     m_name;
+
+    // CSR: sąsiedzi v to [off[v], off[v+1]); *Edge = indeks krawędzi w m_edges (i w m_open)
+    QVector<int>         m_outOff, m_outTo, m_outEdge;
+    QVector<int>         m_inOff,  m_inFrom, m_inEdge;
+
+    QVector<int>         m_switched;     // krawędzie z warunkiem
+    QVector<quint8>      m_open;         // per krawędź: przewodzi teraz
+};
@@ -0,0 +1,104 @@
+#include "contactor_bank.h"
+#include <algorithm>
+#include <cstring>
+
+int ContactorBank::add(const QString& prefix, const QString& coilA, const QString& coilB) {
+    if (m_byPrefix.contains(prefix)) return NONE;
+
+    int i;
+    if (!m_free.isEmpty()) {
+        i = m_free.takeLast();
+    } else {
+        i = m_used.size();
+        m_coilA.push_back(0);     m_coilB.push_back(0);
+        m_energized.push_back(0); m_used.push_back(0); m_diff.push_back(0);
+        m_operations.push_back(0);
+        m_pickupMs.push_back(0);  m_dropoutMs.push_back(0);
+        m_prefix.push_back({});   m_pinA.push_back({}); m_pinB.push_back({});
+    }
+
+    m_coilA[i] = m_coilB[i] = m_energized[i] = m_diff[i] = 0;
+    m_used[i]       = 1;
+    m_operations[i] = 0;
+    m_pickupMs[i]   = DEFAULT_PICKUP_MS;
+    m_dropoutMs[i]  = DEFAULT_DROPOUT_MS;
+    m_prefix[i]     = prefix;
+    m_byPrefix.insert(prefix, i);
+    if (!coilA.isEmpty() && !coilB.isEmpty()) {
+        m_pinA[i] = coilA;
+        m_pinB[i] = coilB;
+        m_byPinA.insert(coilA, i);
+        m_byPinB.insert(coilB, i);
+    }
+    return i;
+}
+
+bool ContactorBank::remove(const QString& prefix) {
+    const auto it = m_byPrefix.find(prefix);
+    if (it == m_byPrefix.end()) return false;
+    const int i = it.value();
+    m_byPrefix.erase(it);
+
+    if (!m_pinA[i].isEmpty()) {
+        m_byPinA.remove(m_pinA[i]);
+        m_byPinB.remove(m_pinB[i]);
+    }
+    m_prefix[i].clear(); m_pinA[i].clear(); m_pinB[i].clear();
+    m_coilA[i] = m_coilB[i] = m_energized[i] = m_diff[i] = 0;
+    m_used[i] = 0;
+    m_free.push_back(i);
+    return true;
+}
+
+void ContactorBank::clear() {
+    *this = ContactorBank();
+}
+
+// Wejścia z gorących zbiorów: przez mniejszą stronę — piny gorące albo piny cewek
+void ContactorBank::gather(QVector<quint8>& in, const QHash<QString, int>& byPin, const QSet<QString>& hot) {
+    std::fill(in.begin(), in.end(), quint8(0));
+    if (hot.size() < byPin.size()) {
+        for (const QString& p : hot) {
+            const auto it = byPin.constFind(p);
+            if (it != byPin.constEnd()) in[it.value()] = 1;
+        }
+    } else {
+        for (auto it = byPin.constBegin(); it != byPin.constEnd(); ++it)
+            if (hot.contains(it.key())) in[it.value()] = 1;
+    }
+}
+
+void ContactorBank::loadCoils(const QSet<QString>& phaseHot, const QSet<QString>& neutralHot) {
+    gather(m_coilA, m_byPinA, phaseHot);
+    gather(m_coilB, m_byPinB, neutralHot);
+}
+
+int ContactorBank::evaluate() {
+    const int n = m_used.size();
+    const quint8* a    = m_coilA.constData();
+    const quint8* b    = m_coilB.constData();
+    const quint8* used = m_used.constData();
+    quint8* en   = m_energized.data();
+    quint8* diff = m_diff.data();
+
+    // Gorąca pętla: same bajty, bez rozgałęzień
+    for (int i = 0; i < n; ++i) {
+        const quint8 next = quint8(a[i] & b[i] & used[i]);
+        diff[i] = quint8(next ^ en[i]);
+        en[i]   = next;
+    }
+
+    // Zmiany są rzadkie: słowami po 8 bajtów, zera pomijane w całości
+    m_changed.clear();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        quint64 w;
+        std::memcpy(&w, diff + i, sizeof w);
+        if (!w) continue;
+        for (int k = i; k < i + 8; ++k)
+            if (diff[k]) { m_changed.push_back(k); m_operations[k] += en[k]; }
+    }
+    for (; i < n; ++i)
+        if (diff[i]) { m_changed.push_back(i); m_operations[i] += en[i]; }
+    return m_changed.size();
+}
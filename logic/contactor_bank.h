@@ -0,0 +1,74 @@
+#pragma once
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// Stan wszystkich styczników (także z katalogu) jako tablice równoległe
+// indeksowane numerem stycznika: wejścia cewki, energizacja, licznik łączeń
+// i parametry czasowe. Przeliczenie energizacji to jedna płaska pętla po
+// bajtach (wektoryzowalna), bez szukania w tablicy mieszającej per stycznik.
+// Napisy (prefiks, piny cewki) są potrzebne tylko przy dodawaniu/usuwaniu
+// i przy zbieraniu wejść z gorących zbiorów.
+//
+// Numery są stałe przez cały czas życia stycznika; zwolnione trafiają na listę
+// wolnych i są używane ponownie. Warunki styków (EdgeStore::Cond) trzymają numer.
+class ContactorBank {
+public:
+    static constexpr int   NONE = -1;
+    static constexpr float DEFAULT_PICKUP_MS  = 20.0f;   // zamykanie (typowo 12–22 ms dla LC1D)
+    static constexpr float DEFAULT_DROPOUT_MS = 10.0f;   // otwieranie (typowo 4–19 ms)
+
+    // Nowy stycznik; piny cewki puste = brak cewki (nigdy nie zadziała). NONE, jeśli prefiks zajęty.
+    int  add(const QString& prefix, const QString& coilA = QString(), const QString& coilB = QString());
+    bool remove(const QString& prefix);
+    void clear();
+
+    int  id(const QString& prefix) const { return m_byPrefix.value(prefix, NONE); }
+    bool contains(const QString& prefix) const { return m_byPrefix.contains(prefix); }
+    const QString& prefix(int id) const { return m_prefix[id]; }
+    const QString& coilPinA(int id) const { return m_pinA[id]; }   // puste = brak cewki
+    const QString& coilPinB(int id) const { return m_pinB[id]; }
+    int  size() const { return m_used.size(); }           // zakres numerów (z wolnymi)
+    int  count() const { return m_byPrefix.size(); }
+
+    // ---- wejścia cewki: FAZA na zacisku A, ZERO na zacisku B
+    void setCoil(int id, bool phaseA, bool neutralB) { m_coilA[id] = phaseA; m_coilB[id] = neutralB; }
+    void loadCoils(const QSet<QString>& phaseHot, const QSet<QString>& neutralHot);
+
+    // Energizacja = A & B dla wszystkich naraz; zwraca liczbę zmian, numery w changed()
+    int  evaluate();
+    const QVector<int>& changed() const { return m_changed; }
+
+    bool    isEnergized(int id) const { return m_energized[id] != 0; }
+    bool    isEnergized(const QString& prefix) const { const int i = id(prefix); return i != NONE && isEnergized(i); }
+    quint32 operations(int id) const  { return m_operations[id]; }     // liczba zadziałań cewki
+
+    void  setTiming(int id, float pickupMs, float dropoutMs) { m_pickupMs[id] = pickupMs; m_dropoutMs[id] = dropoutMs; }
+    float pickupMs(int id) const  { return m_pickupMs[id]; }
+    float dropoutMs(int id) const { return m_dropoutMs[id]; }
+
+private:
+    static void gather(QVector<quint8>& in, const QHash<QString, int>& byPin, const QSet<QString>& hot);
+
+    // Tablice równoległe (indeks = numer stycznika)
+    QVector<quint8>  m_coilA;
+    QVector<quint8>  m_coilB;
+    QVector<quint8>  m_energized;
+    QVector<quint8>  m_used;           // 0 = numer wolny
+    QVector<quint8>  m_diff;           // zmiany z ostatniego evaluate()
+    QVector<quint32> m_operations;
+    QVector<float>   m_pickupMs;
+    QVector<float>   m_dropoutMs;
+
+    // Zimne dane: tylko dodawanie/usuwanie i zbieranie wejść
+    QVector<QString>    m_prefix;
+    QVector<QString>    m_pinA;           // piny cewki (puste = brak cewki)
+    QVector<QString>    m_pinB;
+    QHash<QString, int> m_byPrefix;
+    QHash<QString, int> m_byPinA;
+    QHash<QString, int> m_byPinB;
+    QVector<int>        m_free;
+
+    QVector<int>        m_changed;
+};
@@ -0,0 +1,345 @@
+#include "drc.h"
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+QString deviceName(const QString& prefix) { return prefix.chopped(1); }
+
+QString phaseList(int mask) {
+    QStringList out;
+    for (int k = 0; k < 3; ++k)
+        if (mask & (1 << k)) out << QStringLiteral("L%1").arg(k + 1);
+    return out.join(QStringLiteral(", "));
+}
+
+// Zacisk cewki bez mostka (i bez źródła wprost na nim) — cewka nigdy nie zadziała
+class CoilOpenRule : public DrcRule {
+public:
+    QString id() const override { return QStringLiteral("coil-open"); }
+    QString title() const override { return QStringLiteral("Niepodłączona cewka"); }
+    void checkDevice(const DrcModel& m, const QString& prefix, QVector<DrcIssue>& out) const override {
+        const DrcModel::Device* d = m.device(prefix);
+        if (!d || d->coilA1.isEmpty()) return;
+        for (const QString& pin : { d->coilA1, d->coilA2 })
+            if (m.nets().net(pin) < 0 && !m.isSource(pin))
+                out.push_back({ id(), prefix,
+                                QStringLiteral("%1: zacisk cewki %2 niepodłączony").arg(deviceName(prefix), pin),
+                                { pin } });
+    }
+};
+
+// Mostki łączące wprost zaciski różnych faz zasilań
+class PhaseShortRule : public DrcRule {
+public:
+    QString id() const override { return QStringLiteral("phase-short"); }
+    QString title() const override { return QStringLiteral("Zwarcie faz mostkiem"); }
+    void checkNet(const DrcModel& m, const QStringList& pins, QVector<DrcIssue>& out) const override {
+        int mask = 0;
+        QStringList hit;
+        for (const QString& pin : pins) {
+            const int ph = DrcModel::phaseOfPin(pin);
+            if (!ph) continue;
+            const DrcModel::Device* d = m.device(m.owner(pin));
+            if (!d || d->kind != DrcModel::Kind::Power) continue;
+            mask |= ph;
+            hit << pin;
+        }
+        if (qPopulationCount(quint32(mask)) < 2) return;
+        hit.sort();
+        out.push_back({ id(), hit.first(),
+                        QStringLiteral("Mostki zwierają fazy %1: %2").arg(phaseList(mask), hit.join(QStringLiteral(", "))),
+                        hit });
+    }
+};
+
+// Styk NO i styk NC tego samego urządzenia między tymi samymi sieciami — tor zawsze zamknięty
+class NoNcParallelRule : public DrcRule {
+public:
+    QString id() const override { return QStringLiteral("no-nc-parallel"); }
+    QString title() const override { return QStringLiteral("Styki NO i NC równolegle"); }
+    void checkDevice(const DrcModel& m, const QString& prefix, QVector<DrcIssue>& out) const override {
+        const DrcModel::Device* d = m.device(prefix);
+        if (!d) return;
+        auto joined = [&](const QString& a, const QString& b) {
+            if (a == b) return true;
+            const int n = m.nets().net(a);
+            return n >= 0 && n == m.nets().net(b);
+        };
+        for (const DrcModel::Contact& no : d->contacts) {
+            if (!no.isNO) continue;
+            for (const DrcModel::Contact& nc : d->contacts) {
+                if (nc.isNO) continue;
+                if (!(joined(no.a, nc.a) && joined(no.b, nc.b)) && !(joined(no.a, nc.b) && joined(no.b, nc.a)))
+                    continue;
+                out.push_back({ id(), prefix,
+                                QStringLiteral("%1: styki %2–%3 (NO) i %4–%5 (NC) równolegle — tor zawsze zamknięty")
+                                    .arg(deviceName(prefix), no.a, no.b).arg(nc.a, nc.b),
+                                { no.a, no.b, nc.a, nc.b } });
+            }
+        }
+    }
+};
+
+// Zaciski U/V/W osiągalne (przez dowolne styki) z mniej niż trzech faz
+class MotorPhasesRule : public DrcRule {
+public:
+    QString id() const override { return QStringLiteral("motor-phases"); }
+    QString title() const override { return QStringLiteral("Niepełne zasilanie silnika"); }
+    void checkDevice(const DrcModel& m, const QString& prefix, QVector<DrcIssue>& out) const override {
+        const DrcModel::Device* d = m.device(prefix);
+        if (!d || d->kind != DrcModel::Kind::Motor) return;
+        const QStringList terms = { prefix + QLatin1Char('U'), prefix + QLatin1Char('V'), prefix + QLatin1Char('W') };
+        int mask = 0;
+        for (const QString& t : terms) mask |= m.phasesReaching(t);
+        const int count = qPopulationCount(quint32(mask));
+        if (count == 0 || count == 3) return;     // niepodłączony albo pełne zasilanie
+        out.push_back({ id(), prefix,
+                        count == 1 ? QStringLiteral("%1 zasilany tylko fazą %2").arg(deviceName(prefix), phaseList(mask))
+                                   : QStringLiteral("%1 zasilany tylko fazami %2").arg(deviceName(prefix), phaseList(mask)),
+                        terms });
+    }
+};
+
+} // namespace
+
+// ===================== Model =====================
+const DrcModel::Device* DrcModel::device(const QString& prefix) const {
+    const auto it = m_devices.constFind(prefix);
+    return it == m_devices.constEnd() ? nullptr : &it.value();
+}
+
+bool DrcModel::isSource(const QString& pin) const {
+    return m_sources.contains(pin);
+}
+
+int DrcModel::phaseOfPin(const QString& pin) {
+    if (pin.endsWith(QLatin1String("L1"))) return 0x1;
+    if (pin.endsWith(QLatin1String("L2"))) return 0x2;
+    if (pin.endsWith(QLatin1String("L3"))) return 0x4;
+    return 0;
+}
+
+// Jedno przejście sieci zamkniętej na przegląd (silniki na wspólnej szynie dzielą wynik)
+int DrcModel::phasesReaching(const QString& pin) const {
+    const int net = m_closed.net(pin);
+    if (net >= 0) {
+        const auto it = m_phaseCache.constFind(net);
+        if (it != m_phaseCache.constEnd()) return it.value();
+    }
+    int mask = 0;
+    for (const QString& p : m_closed.pins(pin)) {
+        const int ph = phaseOfPin(p);
+        if (!ph) continue;
+        const Device* d = device(m_owner.value(p));
+        if (d && d->kind == Kind::Power) mask |= ph;
+    }
+    if (net >= 0) m_phaseCache.insert(net, mask);
+    return mask;
+}
+
+// ===================== Silnik reguł =====================
+DrcEngine::DrcEngine() {
+    addRule(std::make_unique<CoilOpenRule>());
+    addRule(std::make_unique<PhaseShortRule>());
+    addRule(std::make_unique<NoNcParallelRule>());
+    addRule(std::make_unique<MotorPhasesRule>());
+}
+
+void DrcEngine::addRule(std::unique_ptr<DrcRule> rule) {
+    m_rules.push_back(std::move(rule));
+    m_all = true;
+}
+
+const DrcRule* DrcEngine::rule(const QString& id) const {
+    for (const auto& r : m_rules)
+        if (r->id() == id) return r.get();
+    return nullptr;
+}
+
+void DrcEngine::clear() {
+    m_model = DrcModel();
+    m_dirtyDevices.clear();
+    m_dirtyPins.clear();
+    m_dirtyClosed.clear();
+    m_deviceIssues.clear();
+    m_netIssues.clear();
+    m_anchorOf.clear();
+    m_anchorPins.clear();
+    m_all = true;                 // pusty wynik też trzeba opublikować
+}
+
+void DrcEngine::checkAll() {
+    m_all = true;
+}
+
+// Rozwinięcie do całych sieci dopiero w check(): seria edycji jednej sieci to jedno przejście.
+// Po usunięciu mostka sieci a i b razem to dawna sieć, więc wystarczą oba końce.
+void DrcEngine::touch(const QString& pin) {
+    if (m_all) return;
+    m_dirtyPins.insert(pin);
+    m_dirtyClosed.insert(pin);
+}
+
+void DrcEngine::addDevice(const QString& prefix, DrcModel::Device device) {
+    if (m_model.m_devices.contains(prefix)) removeDevice(prefix);
+    for (const QString& pin : std::as_const(device.pins)) {
+        m_model.m_owner.insert(pin, prefix);
+        touch(pin);
+    }
+    for (const DrcModel::Contact& c : std::as_const(device.contacts))
+        m_model.m_closed.addWire(c.a, c.b);
+    m_model.m_devices.insert(prefix, std::move(device));
+    if (!m_all) m_dirtyDevices.insert(prefix);
+}
+
+// Z mostkami i źródłami na pinach (jak forgetDevice w GUI); sieci rozwijane przed podziałem
+void DrcEngine::removeDevice(const QString& prefix) {
+    const auto it = m_model.m_devices.constFind(prefix);
+    if (it == m_model.m_devices.constEnd()) return;
+    const QStringList pins = it->pins;
+    if (!m_all) {
+        for (const QString& pin : pins) {
+            for (const QString& p : m_model.m_nets.pins(pin)) m_dirtyPins.insert(p);
+            for (const QString& p : m_model.m_closed.pins(pin)) m_dirtyClosed.insert(p);
+        }
+    }
+    for (const QString& pin : pins) {
+        m_model.m_nets.removePin(pin);
+        m_model.m_closed.removePin(pin);
+        m_model.m_owner.remove(pin);
+        m_model.m_sources.remove(pin);
+    }
+    m_model.m_devices.remove(prefix);
+    m_deviceIssues.remove(prefix);
+    m_dirtyDevices.remove(prefix);
+}
+
+void DrcEngine::addWire(const QString& a, const QString& b) {
+    m_model.m_nets.addWire(a, b);
+    m_model.m_closed.addWire(a, b);
+    touch(a);
+}
+
+void DrcEngine::removeWire(const QString& a, const QString& b) {
+    m_model.m_nets.removeWire(a, b);
+    m_model.m_closed.removeWire(a, b);
+    // Styk równoległy do usuniętego mostka zostaje w sieci zamkniętej
+    for (const QString& prefix : { m_model.owner(a), m_model.owner(b) }) {
+        const DrcModel::Device* d = m_model.device(prefix);
+        if (!d) continue;
+        for (const DrcModel::Contact& c : d->contacts)
+            if ((c.a == a && c.b == b) || (c.a == b && c.b == a)) m_model.m_closed.addWire(c.a, c.b);
+    }
+    touch(a);
+    touch(b);
+}
+
+void DrcEngine::setSource(const QString& pin, bool on) {
+    if (on) m_model.m_sources.insert(pin);
+    else    m_model.m_sources.remove(pin);
+    const QString prefix = m_model.owner(pin);
+    if (!m_all && !prefix.isEmpty()) m_dirtyDevices.insert(prefix);
+}
+
+bool DrcEngine::check() {
+    if (!m_all && m_dirtyDevices.isEmpty() && m_dirtyPins.isEmpty() && m_dirtyClosed.isEmpty())
+        return false;
+    m_model.invalidate();
+
+    QSet<QString> devices;
+    QVector<QStringList> nets;
+    QSet<int> seen;
+
+    auto dropNetIssues = [&](const QString& pin) {
+        const auto it = m_anchorOf.constFind(pin);
+        if (it == m_anchorOf.constEnd()) return;
+        const QString anchor = it.value();
+        for (const QString& p : m_anchorPins.take(anchor)) m_anchorOf.remove(p);
+        m_netIssues.remove(anchor);
+    };
+
+    if (m_all) {
+        m_deviceIssues.clear();
+        m_netIssues.clear();
+        m_anchorOf.clear();
+        m_anchorPins.clear();
+        for (auto it = m_model.m_devices.constBegin(); it != m_model.m_devices.constEnd(); ++it)
+            devices.insert(it.key());
+        // Mostki łączą zaciski urządzeń, więc każda sieć ma pin w rejestrze właścicieli
+        for (auto it = m_model.m_owner.constBegin(); it != m_model.m_owner.constEnd(); ++it) {
+            const int n = m_model.m_nets.net(it.key());
+            if (n >= 0 && !seen.contains(n)) {
+                seen.insert(n);
+                nets.push_back(m_model.m_nets.pins(it.key()));
+            }
+        }
+    } else {
+        // Silniki w dotkniętych sieciach zamkniętych
+        for (const QString& pin : std::as_const(m_dirtyClosed)) {
+            const int n = m_model.m_closed.net(pin);
+            if (n >= 0) {
+                if (seen.contains(n)) continue;
+                seen.insert(n);
+            }
+            for (const QString& p : m_model.m_closed.pins(pin)) {
+                const DrcModel::Device* d = m_model.device(m_model.owner(p));
+                if (d && d->kind == DrcModel::Kind::Motor) devices.insert(m_model.owner(p));
+            }
+        }
+        // Dotknięte sieci mostków: ich urządzenia, stare wyniki sieci do kosza
+        seen.clear();
+        for (const QString& pin : std::as_const(m_dirtyPins)) {
+            const int n = m_model.m_nets.net(pin);
+            if (n >= 0) {
+                if (seen.contains(n)) continue;
+                seen.insert(n);
+            }
+            const QStringList pins = m_model.m_nets.pins(pin);
+            for (const QString& p : pins) {
+                const QString prefix = m_model.owner(p);
+                if (!prefix.isEmpty()) devices.insert(prefix);
+                dropNetIssues(p);
+            }
+            if (n >= 0) nets.push_back(pins);
+        }
+        devices += m_dirtyDevices;
+    }
+
+    for (const QString& prefix : std::as_const(devices)) {
+        m_deviceIssues.remove(prefix);
+        if (!m_model.device(prefix)) continue;
+        QVector<DrcIssue> out;
+        for (const auto& r : m_rules) r->checkDevice(m_model, prefix, out);
+        if (!out.isEmpty()) m_deviceIssues.insert(prefix, std::move(out));
+    }
+    for (const QStringList& pins : std::as_const(nets)) {
+        QVector<DrcIssue> out;
+        for (const auto& r : m_rules) r->checkNet(m_model, pins, out);
+        if (out.isEmpty()) continue;
+        const QString anchor = pins.first();
+        for (const QString& p : pins) m_anchorOf.insert(p, anchor);
+        m_anchorPins.insert(anchor, pins);
+        m_netIssues.insert(anchor, std::move(out));
+    }
+
+    m_checkedDevices = devices.size();
+    m_checkedNets = nets.size();
+    m_dirtyDevices.clear();
+    m_dirtyPins.clear();
+    m_dirtyClosed.clear();
+    m_all = false;
+    return true;
+}
+
+QVector<DrcIssue> DrcEngine::issues() const {
+    QVector<DrcIssue> out;
+    for (const QVector<DrcIssue>& list : m_deviceIssues) out += list;
+    for (const QVector<DrcIssue>& list : m_netIssues) out += list;
+    std::sort(out.begin(), out.end(), [](const DrcIssue& a, const DrcIssue& b) {
+        return a.rule != b.rule ? a.rule < b.rule : a.subject < b.subject;
+    });
+    return out;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+#include <vector>
+
+#include "net_index.h"
+
+// Kontrola reguł projektowych (DRC): błędy widoczne w samym schemacie,
+// niezależnie od stanu styków i źródeł.
+//
+// DrcModel to schemat widziany przez reguły: urządzenia (piny, cewka, styki),
+// sieci mostków i „sieci zamknięte” — mostki plus wszystkie styki zwarte, czyli
+// wszystko, dokąd zasilanie może kiedykolwiek dotrzeć.
+//
+// Reguła (DrcRule) sprawdza jedno urządzenie albo jedną sieć. DrcEngine
+// przyjmuje edycje i zapamiętuje, czego dotknęły: urządzenie, piny jego sieci,
+// silniki w dotkniętej sieci zamkniętej. check() przegląda tylko to — pozostałe
+// wyniki zostają z poprzednich przebiegów.
+struct DrcIssue {
+    QString     rule;       // DrcRule::id()
+    QString     subject;    // prefiks urządzenia albo pin sieci
+    QString     message;
+    QStringList pins;       // do oznaczenia na schemacie
+};
+
+class DrcModel {
+public:
+    enum class Kind : quint8 { Contactor, Power, Motor };
+    struct Contact {
+        QString a, b;
+        bool    isNO = true;
+    };
+    struct Device {
+        Kind             kind = Kind::Contactor;
+        QStringList      pins;
+        QString          coilA1, coilA2;     // puste = bez cewki
+        QVector<Contact> contacts;
+    };
+
+    const Device* device(const QString& prefix) const;
+    QString       owner(const QString& pin) const { return m_owner.value(pin); }
+    const NetIndex& nets() const { return m_nets; }
+    bool          isSource(const QString& pin) const;
+
+    // Fazy (0x1=L1, 0x2=L2, 0x4=L3) zasilań w sieci zamkniętej pinu — pamiętane do invalidate()
+    int           phasesReaching(const QString& pin) const;
+    static int    phaseOfPin(const QString& pin);    // po sufiksie L1/L2/L3, 0 = nie faza
+
+private:
+    friend class DrcEngine;
+    void invalidate() { m_phaseCache.clear(); }
+
+    QHash<QString, Device>  m_devices;
+    QHash<QString, QString> m_owner;         // pin -> prefiks
+    NetIndex                m_nets;          // mostki
+    NetIndex                m_closed;        // mostki + styki (wszystkie zwarte)
+    QSet<QString>           m_sources;       // FAZA i ZERO
+    mutable QHash<int, int> m_phaseCache;    // sieć zamknięta -> fazy
+};
+
+class DrcRule {
+public:
+    virtual ~DrcRule() = default;
+    virtual QString id() const = 0;
+    virtual QString title() const = 0;
+    virtual void checkDevice(const DrcModel&, const QString& /*prefix*/, QVector<DrcIssue>& /*out*/) const {}
+    virtual void checkNet(const DrcModel&, const QStringList& /*pins*/, QVector<DrcIssue>& /*out*/) const {}
+};
+
+class DrcEngine {
+public:
+    DrcEngine();                                         // reguły wbudowane
+    void addRule(std::unique_ptr<DrcRule> rule);         // kolejna reguła: pełny przegląd
+    const DrcRule* rule(const QString& id) const;
+
+    // Edycje
+    void clear();
+    void addDevice(const QString& prefix, DrcModel::Device device);
+    void removeDevice(const QString& prefix);
+    void addWire(const QString& a, const QString& b);
+    void removeWire(const QString& a, const QString& b);
+    void setSource(const QString& pin, bool on);
+    void checkAll();                                     // następny check() przejrzy wszystko
+
+    // Przegląd dotkniętych urządzeń i sieci; false = nic do sprawdzenia
+    bool check();
+    QVector<DrcIssue> issues() const;
+    int  checkedDevices() const { return m_checkedDevices; }
+    int  checkedNets() const { return m_checkedNets; }
+
+private:
+    void touch(const QString& pin);             // sieć mostków i sieć zamknięta pinu do przejrzenia
+
+    DrcModel                               m_model;
+    std::vector<std::unique_ptr<DrcRule>>  m_rules;
+
+    QSet<QString>                          m_dirtyDevices;
+    QSet<QString>                          m_dirtyPins;      // -> urządzenia i wyniki ich sieci
+    QSet<QString>                          m_dirtyClosed;    // -> silniki w sieci zamkniętej
+    bool                                   m_all = false;
+
+    QHash<QString, QVector<DrcIssue>>      m_deviceIssues;   // prefiks -> błędy
+    QHash<QString, QVector<DrcIssue>>      m_netIssues;      // kotwica sieci -> błędy
+    QHash<QString, QString>                m_anchorOf;       // pin sieci z błędem -> kotwica
+    QHash<QString, QStringList>            m_anchorPins;     // kotwica -> piny sieci z chwili przeglądu
+    int                                    m_checkedDevices = 0;
+    int                                    m_checkedNets = 0;
+};
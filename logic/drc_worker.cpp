@@ -0,0 +1,39 @@
+#include "drc_worker.h"
+#include <QElapsedTimer>
+
+#include <utility>
+
+DrcWorker::DrcWorker(std::function<void()> notify)
+    : m_loop(std::move(notify), [this] { drain(); })
+{
+}
+
+// ===================== Wątek roboczy =====================
+void DrcWorker::drain() {
+    Op op;
+    while (m_loop.pop(op)) apply(op);
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!m_engine.check()) return;
+
+    Result& r = m_loop.back();
+    r.issues  = m_engine.issues();
+    r.devices = m_engine.checkedDevices();
+    r.nets    = m_engine.checkedNets();
+    r.ms      = timer.nsecsElapsed() / 1e6;
+    m_loop.publish();
+}
+
+void DrcWorker::apply(Op& op) {
+    using Kind = Op::Kind;
+    switch (op.kind) {
+    case Kind::Clear:        m_engine.clear(); break;
+    case Kind::AddDevice:    m_engine.addDevice(op.prefix, std::move(op.device)); break;
+    case Kind::RemoveDevice: m_engine.removeDevice(op.prefix); break;
+    case Kind::AddWire:      m_engine.addWire(op.a, op.b); break;
+    case Kind::RemoveWire:   m_engine.removeWire(op.a, op.b); break;
+    case Kind::SetSource:    m_engine.setSource(op.a, op.on); break;
+    case Kind::CheckAll:     m_engine.checkAll(); break;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+#include "drc.h"
+#include "worker_loop.h"
+
+// DRC w osobnym wątku — ten sam WorkerLoop co SimWorker: edycje jako operacje,
+// zdejmowane hurtem i nanoszone na własny DrcEngine; po każdej paczce przegląd
+// tylko dotkniętych urządzeń i sieci, pełna lista błędów do potrójnego bufora
+// i najwyżej jedno notify(), dopóki GUI jej nie odbierze.
+class DrcWorker {
+public:
+    struct Op {
+        enum class Kind : quint8 {
+            Clear,
+            AddDevice,      // prefix, device
+            RemoveDevice,   // prefix
+            AddWire,        // a, b
+            RemoveWire,     // a, b
+            SetSource,      // a, on (FAZA i ZERO jednakowo)
+            CheckAll,
+        };
+        Kind             kind = Kind::CheckAll;
+        QString          prefix;
+        QString          a, b;
+        DrcModel::Device device;
+        bool             on = false;
+    };
+
+    struct Result {
+        QVector<DrcIssue> issues;
+        int               devices = 0;      // przejrzane w ostatnim przebiegu
+        int               nets = 0;
+        double            ms = 0.0;
+    };
+
+    // notify() jest wołane z wątku roboczego — ma tylko zlecić odbiór
+    explicit DrcWorker(std::function<void()> notify);
+    ~DrcWorker() { stop(); }
+    DrcWorker(const DrcWorker&) = delete;
+    DrcWorker& operator=(const DrcWorker&) = delete;
+
+    // ---- wątek GUI
+    void    post(Op op) { m_loop.post(std::move(op)); }
+    void    stop() { m_loop.stop(); }
+    bool    fetch() { return m_loop.fetch(); }
+    Result& result() { return m_loop.result(); }
+
+private:
+    void drain();
+    void apply(Op& op);
+
+    DrcEngine              m_engine;          // wyłącznie wątek roboczy
+    WorkerLoop<Op, Result> m_loop;            // ostatni — wątek startuje po reszcie pól
+};
@@ -0,0 +1,103 @@
+#include "edge_store.h"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace {
+std::atomic<quint64> g_revision{0};
+}
+
+int EdgeStore::addPair(const QString& a, const QString& b, Cond cond, const QString& owner) {
+    add(Edge{a, b, cond, owner});
+    add(Edge{b, a, std::move(cond), owner});
+    return 2;
+}
+
+void EdgeStore::add(Edge e) {
+    m_revision = ++g_revision;
+    const int i = m_edges.size();
+    m_byPin[e.a].push_back(i);
+    if (e.b != e.a) m_byPin[e.b].push_back(i);
+    if (!e.owner.isEmpty()) m_byOwner[e.owner].push_back(i);
+    m_edges.push_back(std::move(e));
+}
+
+void EdgeStore::unlink(QHash<QString, QVector<int>>& index, const QString& key, int i) {
+    auto it = index.find(key);
+    if (it == index.end()) return;
+    QVector<int>& v = it.value();
+    const int pos = v.indexOf(i);
+    if (pos < 0) return;
+    v[pos] = v.last();
+    v.removeLast();
+    if (v.isEmpty()) index.erase(it);
+}
+
+void EdgeStore::relink(QHash<QString, QVector<int>>& index, const QString& key, int from, int to) {
+    auto it = index.find(key);
+    if (it == index.end()) return;
+    for (int& x : it.value())
+        if (x == from) { x = to; return; }
+}
+
+// swap-remove: ostatnia krawędź trafia na miejsce usuwanej, indeksy są łatane
+void EdgeStore::removeAt(int i) {
+    m_revision = ++g_revision;
+    const int last = m_edges.size() - 1;
+    {
+        const Edge& e = m_edges[i];
+        unlink(m_byPin, e.a, i);
+        if (e.b != e.a) unlink(m_byPin, e.b, i);
+        if (!e.owner.isEmpty()) unlink(m_byOwner, e.owner, i);
+    }
+    if (i != last) {
+        m_edges[i] = std::move(m_edges[last]);
+        const Edge& m = m_edges[i];
+        relink(m_byPin, m.a, last, i);
+        if (m.b != m.a) relink(m_byPin, m.b, last, i);
+        if (!m.owner.isEmpty()) relink(m_byOwner, m.owner, last, i);
+    }
+    m_edges.removeLast();
+}
+
+int EdgeStore::removePin(const QString& pin) {
+    int n = 0;
+    for (;;) {
+        auto it = m_byPin.constFind(pin);
+        if (it == m_byPin.constEnd()) break;
+        removeAt(it.value().last());   // removeAt kasuje pusty wpis
+        ++n;
+    }
+    return n;
+}
+
+int EdgeStore::removeOwner(const QString& owner) {
+    int n = 0;
+    for (;;) {
+        auto it = m_byOwner.constFind(owner);
+        if (it == m_byOwner.constEnd()) break;
+        removeAt(it.value().last());
+        ++n;
+    }
+    return n;
+}
+
+int EdgeStore::removeBetween(const QString& a, const QString& b) {
+    QVector<int> hit;
+    for (int i : m_byPin.value(a)) {
+        const Edge& e = m_edges[i];
+        if ((e.a == a && e.b == b) || (e.a == b && e.b == a))
+            hit.push_back(i);
+    }
+    // malejąco — swap-remove nie przesuwa wtedy pozostałych trafień
+    std::sort(hit.begin(), hit.end(), std::greater<int>());
+    for (int i : hit) removeAt(i);
+    return hit.size();
+}
+
+void EdgeStore::clear() {
+    m_revision = ++g_revision;
+    m_edges.clear();
+    m_byPin.clear();
+    m_byOwner.clear();
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+#include "propagation.h"
+
+// Krawędzie grafu połączeń z indeksami własności.
+// Krawędzie leżą w ciągłym wektorze (tak, jak oczekuje propagacja), a indeksy
+// per pin i per właściciel („K1_”, mostek…) pozwalają usuwać je kosztem
+// proporcjonalnym do liczby krawędzi danego pinu/urządzenia, bez skanowania
+// całego grafu. Usuwanie to swap-remove: kolejność krawędzi nie jest stała.
+class EdgeStore {
+public:
+    using Cond = std::function<bool()>;
+
+    // Krawędź w obie strony (a->b i b->a); zwraca liczbę dodanych krawędzi.
+    // Pusty warunek = mostek, przewodzi zawsze (ConductionGraph go nie odpytuje)
+    int  addPair(const QString& a, const QString& b, Cond cond, const QString& owner = QString());
+
+    int  removePin(const QString& pin);                    // wszystkie krawędzie pinu
+    int  removeOwner(const QString& owner);                // wszystkie krawędzie właściciela
+    int  removeBetween(const QString& a, const QString& b); // obie strony a<->b
+    void clear();
+
+    const QVector<Edge>& edges() const { return m_edges; }
+    int  size() const { return m_edges.size(); }
+    int  degree(const QString& pin) const { return m_byPin.value(pin).size(); }
+    QVector<int> edgesAt(const QString& pin) const { return m_byPin.value(pin); } // ważne do następnej zmiany
+
+    // Numer wersji struktury: każda zmiana nadaje nowy, unikalny także między magazynami
+    // (graf przeniesiony z wczytywania nie zrówna się z poprzednim)
+    quint64 revision() const { return m_revision; }
+
+private:
+    void add(Edge e);
+    void removeAt(int i);
+
+    static void unlink(QHash<QString, QVector<int>>& index, const QString& key, int i);
+    static void relink(QHash<QString, QVector<int>>& index, const QString& key, int from, int to);
+
+    QVector<Edge>                 m_edges;
+    QHash<QString, QVector<int>>  m_byPin;     // pin -> indeksy krawędzi (a lub b)
+    QHash<QString, QVector<int>>  m_byOwner;   // właściciel -> indeksy krawędzi
+    quint64                       m_revision = 0;
+};
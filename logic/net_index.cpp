@@ -0,0 +1,105 @@
+#include "net_index.h"
+#include <utility>
+
+// ===================== Edycja =====================
+int NetIndex::idOf(const QString& pin) {
+    const auto it = m_id.constFind(pin);
+    if (it != m_id.constEnd()) return it.value();
+    int v;
+    if (!m_free.isEmpty()) {
+        v = m_free.takeLast();
+        m_name[v] = pin;
+    } else {
+        v = m_name.size();
+        m_name.push_back(pin);
+        m_net.push_back(-1);
+        m_members.push_back({});
+        m_wires.push_back({});
+    }
+    m_id.insert(pin, v);
+    m_net[v] = v;
+    m_members[v] = { v };
+    return v;
+}
+
+// Mniejsza sieć do większej: każdy pin zmienia sieć najwyżej log2(n) razy
+void NetIndex::merge(int a, int b) {
+    int ra = m_net[a], rb = m_net[b];
+    if (ra == rb) return;
+    if (m_members[ra].size() < m_members[rb].size()) std::swap(ra, rb);
+    for (int v : std::as_const(m_members[rb])) m_net[v] = ra;
+    m_members[ra] += m_members[rb];
+    m_members[rb].clear();
+}
+
+void NetIndex::addWire(const QString& a, const QString& b) {
+    const int u = idOf(a);
+    const int v = idOf(b);
+    m_wires[u].push_back(v);
+    if (v != u) m_wires[v].push_back(u);
+    merge(u, v);
+}
+
+// Sieć od nowa z mostków jej pinów; piny bez mostków wypadają z indeksu
+void NetIndex::split(int net) {
+    const QVector<int> old = std::move(m_members[net]);
+    m_members[net].clear();
+    for (int v : old) m_net[v] = -1;
+
+    QVector<int> queue;
+    for (int s : old) {
+        if (m_net[s] >= 0) continue;
+        if (m_wires[s].isEmpty()) {
+            m_id.remove(m_name[s]);
+            m_name[s].clear();
+            m_free.push_back(s);
+            continue;
+        }
+        m_net[s] = s;
+        queue = { s };
+        for (int head = 0; head < queue.size(); ++head)
+            for (int w : std::as_const(m_wires[queue[head]]))
+                if (m_net[w] < 0) {
+                    m_net[w] = s;
+                    queue.push_back(w);
+                }
+        m_members[s] = queue;
+    }
+}
+
+void NetIndex::removeWire(const QString& a, const QString& b) {
+    const int u = m_id.value(a, -1);
+    const int v = m_id.value(b, -1);
+    if (u < 0 || v < 0) return;
+    if (m_wires[u].removeAll(v) == 0) return;
+    m_wires[v].removeAll(u);
+    split(m_net[u]);
+}
+
+void NetIndex::removePin(const QString& pin) {
+    const int u = m_id.value(pin, -1);
+    if (u < 0) return;
+    const QVector<int> wires = std::move(m_wires[u]);
+    m_wires[u].clear();
+    for (int w : wires) m_wires[w].removeAll(u);
+    split(m_net[u]);
+}
+
+void NetIndex::clear() {
+    *this = NetIndex();
+}
+
+// ===================== Zapytania =====================
+int NetIndex::net(const QString& pin) const {
+    const int v = m_id.value(pin, -1);
+    return v < 0 ? -1 : m_net[v];
+}
+
+QStringList NetIndex::pins(const QString& pin) const {
+    const int net = this->net(pin);
+    if (net < 0) return { pin };
+    QStringList out;
+    out.reserve(m_members[net].size());
+    for (int v : m_members[net]) out << m_name[v];
+    return out;
+}
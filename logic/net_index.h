@@ -0,0 +1,39 @@
+#pragma once
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Sieci: zbiory pinów połączonych mostkami (bez styków — te zmieniają się w symulacji).
+//
+// Zbiory rozłączne z jawnymi listami członków: każdy pin zna numer swojej sieci
+// wprost (net() = jedno wyszukanie), a addWire() łączy dwie sieci, przepisując
+// mniejszą do większej — łącznie O(n log n) dla n pinów. Usunięcia mostka zbiory
+// rozłączne nie umieją cofnąć, więc removeWire()/removePin() dzielą od nowa
+// tylko dotkniętą sieć (BFS po jej mostkach), nie cały schemat.
+//
+// Numer sieci to numer jednego z jej pinów — ważny do następnej zmiany.
+// Pin bez mostków nie należy do żadnej sieci (net() == -1).
+class NetIndex {
+public:
+    void addWire(const QString& a, const QString& b);
+    void removeWire(const QString& a, const QString& b);   // wszystkie mostki a<->b
+    void removePin(const QString& pin);                    // z mostkami pinu
+    void clear();
+
+    int         net(const QString& pin) const;
+    QStringList pins(const QString& pin) const;    // cała sieć pinu (sam pin, gdy bez mostków)
+    int         size() const { return m_id.size(); }   // piny z mostkami
+
+private:
+    int  idOf(const QString& pin);
+    void merge(int a, int b);
+    void split(int net);
+
+    QHash<QString, int>   m_id;
+    QVector<QString>      m_name;
+    QVector<int>          m_net;       // pin -> sieć (-1 = numer wolny)
+    QVector<QVector<int>> m_members;   // sieć -> piny (puste dla nie-reprezentantów)
+    QVector<QVector<int>> m_wires;     // pin -> drugie końce mostków (z powtórzeniami)
+    QVector<int>          m_free;      // numery do ponownego użycia
+};
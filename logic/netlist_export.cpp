@@ -0,0 +1,211 @@
+#include "netlist_export.h"
+#include "edge_store.h"
+#include "device_template.h"
+
+#include <QSaveFile>
+#include <QVector>
+
+#include <utility>
+
+namespace {
+
+constexpr int FLUSH_BYTES = 1 << 16;
+
+// Bufor przed QSaveFile — zapis blokami, bez składania całego pliku w pamięci
+class Sink {
+public:
+    explicit Sink(QSaveFile& f) : m_file(f) { m_buf.reserve(FLUSH_BYTES + 1024); }
+
+    Sink& operator<<(const QString& s) { m_buf += s.toUtf8(); return spill(); }
+    Sink& operator<<(const char* s)    { m_buf += s; return spill(); }
+    Sink& operator<<(int v)            { m_buf += QByteArray::number(v); return spill(); }
+
+    bool finish() { flush(); return m_ok; }
+
+private:
+    Sink& spill() { if (m_buf.size() >= FLUSH_BYTES) flush(); return *this; }
+    void flush() {
+        if (m_ok && !m_buf.isEmpty() && m_file.write(m_buf) != m_buf.size()) m_ok = false;
+        m_buf.clear();
+    }
+
+    QSaveFile& m_file;
+    QByteArray m_buf;
+    bool       m_ok = true;
+};
+
+// Węzły połączone samymi mostkami -> jeden net (union-find, kompresja ścieżek)
+class Nets {
+public:
+    int pin(const QString& name) {
+        auto it = m_index.constFind(name);
+        if (it != m_index.constEnd()) return it.value();
+        const int id = m_parent.size();
+        m_index.insert(name, id);
+        m_names.push_back(name);
+        m_parent.push_back(id);
+        m_size.push_back(1);
+        return id;
+    }
+    int find(int x) {
+        while (m_parent[x] != x) {
+            m_parent[x] = m_parent[m_parent[x]];
+            x = m_parent[x];
+        }
+        return x;
+    }
+    void join(int a, int b) {
+        a = find(a); b = find(b);
+        if (a == b) return;
+        if (m_size[a] < m_size[b]) std::swap(a, b);
+        m_parent[b] = a;
+        m_size[a] += m_size[b];
+    }
+    // Numer netu (1…) nadawany przy pierwszym użyciu korzenia
+    int label(const QString& name) {
+        const int root = find(m_index.value(name));
+        int& n = m_label[root];
+        if (n == 0) n = ++m_labels;
+        return n;
+    }
+    int labels() const { return m_labels; }
+
+    bool contains(const QString& name) const { return m_index.contains(name); }
+    const QVector<QString>& names() const { return m_names; }    // w kolejności dodania
+    void reserveLabels() { m_label.fill(0, m_parent.size()); }
+
+private:
+    QHash<QString, int> m_index;
+    QVector<QString>    m_names;
+    QVector<int>        m_parent;
+    QVector<int>        m_size;
+    QVector<int>        m_label;
+    int                 m_labels = 0;
+};
+
+QString netName(int n) { return QStringLiteral("N%1").arg(n); }
+
+QString csvField(const QString& s) {
+    if (!s.contains(QLatin1Char(',')) && !s.contains(QLatin1Char('"'))) return s;
+    QString q = s;
+    q.replace(QLatin1Char('"'), QLatin1String("\"\""));
+    return QStringLiteral("\"%1\"").arg(q);
+}
+
+// Rodzaj styku (NO/NC) po sufiksach pinów — z szablonu typu urządzenia
+QHash<QString, bool> contactKinds(const DeviceTemplate& t) {
+    QHash<QString, bool> out;
+    for (const DeviceTemplate::Contact& c : t.contacts) {
+        const QString& a = t.pins[c.pinA].suffix;
+        const QString& b = t.pins[c.pinB].suffix;
+        out.insert(a + QLatin1Char('-') + b, c.normallyOpen);
+        out.insert(b + QLatin1Char('-') + a, c.normallyOpen);
+    }
+    return out;
+}
+
+QStringList sorted(const QSet<QString>& set) {
+    QStringList out(set.cbegin(), set.cend());
+    out.sort();
+    return out;
+}
+
+} // namespace
+
+NetlistExport::Format NetlistExport::formatFor(const QString& path) {
+    return path.endsWith(QLatin1String(".csv"), Qt::CaseInsensitive) ? Format::Csv : Format::Spice;
+}
+
+bool NetlistExport::write(const QString& path, Format format, const Input& in,
+                          Stats* stats, QString* error) {
+    const QVector<Edge>& edges = in.edges.edges();
+
+    // 1) Nety: wszystkie piny, mostki scalają (każda para zapisana w obie strony — bierzemy a < b).
+    //    Piny dodawane w stałej kolejności (urządzenia po prefiksie, źródła i same mostki
+    //    posortowane) — numery netów i kolejność wierszy nie zależą od ziarna QHash,
+    //    więc dwa eksporty tego samego projektu dają identyczny plik.
+    //    Cena deterministycznego wyniku: posortowane listy źródeł i pinów samych mostków.
+    //    To kopie płytkie (QString współdzielony niejawnie) — po wskaźniku na pin,
+    //    tekst nazw się nie powiela; sam plik nadal idzie strumieniem przez Sink.
+    Nets nets;
+    QStringList prefixes = in.devicePins.keys();
+    prefixes.sort();
+    for (const QString& prefix : prefixes)
+        for (const QString& p : in.devicePins.value(prefix)) nets.pin(p);
+    const QStringList phase   = sorted(in.phaseSources);
+    const QStringList neutral = sorted(in.neutralSources);
+    for (const QString& p : phase)   nets.pin(p);
+    for (const QString& p : neutral) nets.pin(p);
+    QStringList wireOnly;
+    for (const Edge& e : edges) {
+        if (!nets.contains(e.a)) wireOnly << e.a;
+        if (!nets.contains(e.b)) wireOnly << e.b;
+    }
+    wireOnly.sort();
+    for (const QString& p : wireOnly) nets.pin(p);       // duplikaty: pin() zwraca istniejący
+    for (const Edge& e : edges)
+        if (e.owner.isEmpty() && e.a < e.b) nets.join(nets.pin(e.a), nets.pin(e.b));
+    nets.reserveLabels();
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    Sink out(f);
+    Stats st;
+    const bool spice = (format == Format::Spice);
+
+    if (spice) out << "* ControlNet netlist\n";
+    else       out << "type,name,net_a,net_b,device,kind\n";
+
+    // 2) Piny -> nety
+    for (const QString& pin : nets.names()) {
+        const QString net = netName(nets.label(pin));
+        if (spice) out << "*PIN " << pin << " " << net << "\n";
+        else       out << "pin," << csvField(pin) << "," << net << ",,,\n";
+        ++st.pins;
+    }
+
+    // 3) Styki urządzeń — jedna linia na parę krawędzi
+    QHash<const DeviceTemplate*, QHash<QString, bool>> kindsByType;   // raz na typ, nie na urządzenie
+    for (const Edge& e : edges) {
+        if (e.owner.isEmpty() || !(e.a < e.b)) continue;
+        const QString sa = e.a.startsWith(e.owner) ? e.a.mid(e.owner.size()) : e.a;
+        const QString sb = e.b.startsWith(e.owner) ? e.b.mid(e.owner.size()) : e.b;
+        const DeviceTemplate* tpl = in.templates.value(e.owner, nullptr);
+        auto kt = kindsByType.find(tpl);
+        if (kt == kindsByType.end())
+            kt = kindsByType.insert(tpl, tpl ? contactKinds(*tpl) : QHash<QString, bool>());
+        const QHash<QString, bool>& kinds = kt.value();
+        const auto kind = kinds.constFind(sa + QLatin1Char('-') + sb);
+        const char* k = (kind == kinds.constEnd()) ? "SW" : (kind.value() ? "NO" : "NC");
+        const QString na = netName(nets.label(e.a));
+        const QString nb = netName(nets.label(e.b));
+        ++st.contacts;
+        if (spice) out << "S" << st.contacts << " " << na << " " << nb << " " << k
+                       << " ; " << e.owner << " " << sa << "-" << sb << "\n";
+        else       out << "contact," << csvField(e.a + QLatin1Char('-') + e.b) << "," << na << "," << nb
+                       << "," << csvField(e.owner) << "," << k << "\n";
+    }
+
+    // 4) Źródła
+    int src = 0;
+    auto source = [&](const QString& pin, const char* kind) {
+        const QString net = netName(nets.label(pin));
+        if (spice) out << "V" << ++src << " " << net << " " << kind << " ; " << pin << "\n";
+        else       out << "source," << csvField(pin) << "," << net << ",,," << kind << "\n";
+    };
+    for (const QString& p : phase)   source(p, "PHASE");
+    for (const QString& p : neutral) source(p, "NEUTRAL");
+
+    if (spice) out << ".END\n";
+
+    if (!out.finish() || !f.commit()) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    st.nets = nets.labels();
+    if (stats) *stats = st;
+    return true;
+}
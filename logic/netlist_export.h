@@ -0,0 +1,43 @@
+#pragma once
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class EdgeStore;
+struct DeviceTemplate;
+
+// Eksport logicznej listy połączeń (netlisty) — jednym przebiegiem po grafie.
+//
+// Mostki (krawędzie bez właściciela) nie są elementami: piny połączone samymi
+// mostkami tworzą jeden węzeł (net) N1, N2, … Elementami są tylko styki
+// urządzeń (NO/NC), po jednym na parę krawędzi a->b / b->a.
+//
+//   SPICE: „*PIN <pin> <net>”, „S<n> <netA> <netB> <NO|NC> ; <urządzenie> <pinA>-<pinB>”,
+//          „V<n> <net> PHASE|NEUTRAL” dla źródeł, na końcu „.END”
+//   CSV:   type,name,net_a,net_b,device,kind — wiersze pin / contact / source
+//
+// Poza tablicą węzłów (pin -> indeks) nic nie jest kopiowane: wiersze idą
+// prosto do buforowanego pliku (zapis atomowy przez QSaveFile).
+class NetlistExport {
+public:
+    enum class Format { Spice, Csv };
+
+    struct Input {
+        const EdgeStore&                   edges;
+        const QHash<QString, QStringList>& devicePins;   // także piny bez połączeń
+        const QSet<QString>&               phaseSources;
+        const QSet<QString>&               neutralSources;
+        const QHash<QString, const DeviceTemplate*>& templates;   // właściciel styków -> szablon (NO/NC)
+    };
+
+    struct Stats {
+        int nets = 0;
+        int pins = 0;
+        int contacts = 0;
+    };
+
+    static Format formatFor(const QString& path);   // po rozszerzeniu: .csv -> Csv, reszta -> Spice
+    static bool   write(const QString& path, Format format, const Input& in,
+                        Stats* stats = nullptr, QString* error = nullptr);
+};
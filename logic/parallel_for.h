@@ -0,0 +1,25 @@
+#pragma once
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <algorithm>
+
+// f(porcja, od, do) na [0, n) w co najwyżej `parts` porcjach, każda co najmniej
+// `grain` elementów; porcja 0 w wątku wołającym, reszta na puli `pool`.
+// Wraca po zakończeniu wszystkich porcji. Porcja o numerze c jest jedna na
+// wywołanie — f może trzymać stan roboczy w tablicy indeksowanej porcją.
+template <typename F>
+void parallelFor(QThreadPool& pool, int n, int parts, int grain, const F& f) {
+    parts = std::max(1, std::min(parts, (n + grain - 1) / grain));
+    const int step = (n + parts - 1) / parts;
+    QSemaphore done;
+    int started = 0;
+    for (int c = 1; c < parts; ++c) {
+        const int b = c * step, e = std::min(n, b + step);
+        if (b >= e) break;
+        ++started;
+        pool.start([&f, &done, c, b, e] { f(c, b, e); done.release(); });
+    }
+    f(0, 0, std::min(n, step));
+    done.acquire(started);
+}
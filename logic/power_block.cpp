@@ -1,14 +1,15 @@
 #include "power_block.h"
 #include "contactor_LC1D09_LADC22.h"
 #include "contactor_view.h"
+#include "device_body_item.h"
+#include "device_template.h"
 #include <QGraphicsScene>
-#include <QGraphicsRectItem>
-#include <QGraphicsSimpleTextItem>
 #include <QGraphicsEllipseItem>
-#include <QGraphicsLineItem>
 #include <QBrush>
 #include <QPen>
+#include <QStringList>
 #include <cmath>
+#include <utility>
 
 static inline int PX(qreal v){ return int(std::lround(v * 0.7)); }
 
@@ -16,64 +17,69 @@ PowerBlock::PowerBlock(QGraphicsScene* scene,
                        const QString& prefix,
                        const QPointF& topLeft,
                        AddTerminalFn addTerminal,
-                       AddLineFn addLine,
                        TrackFn track,
                        QObject* parent)
     : QObject(parent),
     m_scene(scene),
     m_prefix(prefix),
     m_addTerminal(std::move(addTerminal)),
-    m_addLine(std::move(addLine)),
     m_track(std::move(track))
 {
     build(topLeft);
 }
 
+// Wspólny szablon ramy zasilania (geometria lokalna względem rogu ramy)
+const DeviceTemplate& PowerBlock::deviceTemplate() {
+    static const DeviceTemplate tpl = []{
+        const int BW   = PX(260);
+        const int BH   = PX(170);
+        const int pinX = -PX(30);
+        const int gap  = PX(40);
+        const int L1y  = PX(40);
+
+        DeviceTemplate t;
+        t.addRect(QRectF(0, 0, BW, BH), ContactorView::penWire(1.8));
+        int y = L1y;
+        for (const char* p : {"L1","L2","L3"}) {
+            t.addLine(QPointF(pinX, y), QPointF(0, y), ContactorView::penWire(1.6));
+            t.addLabel(QString::fromLatin1(p), QPointF(pinX - PX(20), y - PX(26)), 0.7, ContactorView::colText());
+            t.addPin(QString::fromLatin1(p), QPointF(pinX, y));
+            y += gap;
+        }
+        t.titlePos   = QPointF(PX(8), -PX(22));
+        t.titleScale = 0.7;
+        t.titleColor = ContactorView::colText();
+        t.finish();
+        return t;
+    }();
+    return tpl;
+}
+
 void PowerBlock::build(const QPointF& off) {
     const int BW = PX(260);
     const int BH = PX(170);
     const int X  = int(off.x());
     const int Y  = int(off.y());
 
-    // Rama + tytuł
-    auto* r = m_scene->addRect(X, Y, BW, BH, ContactorView::penWire(1.8), QBrush(Qt::NoBrush));
-    m_track(r); m_items.push_back(r);
-
-    auto* title = m_scene->addSimpleText(QStringLiteral("ZASILANIE 3F (%1)").arg(m_prefix.left(m_prefix.size()-1)));
-    title->setBrush(ContactorView::colText());
-    title->setScale(0.7);
-    title->setPos(QPointF(X + PX(8), Y - PX(22)));
-    m_track(title); m_items.push_back(title);
-
-    // Piny L1/L2/L3 po lewej
-    const int pinX = X - PX(30);
-    const int gap  = PX(40);
-    const int L1y  = Y + PX(40);
-    const int L2y  = L1y + gap;
-    const int L3y  = L2y + gap;
+    const DeviceTemplate& tpl = deviceTemplate();
 
-    // <<< KLUCZOWE: zapisz wskaźniki linii i dodaj do m_items >>>
-    if (auto* l = m_addLine(QPointF(pinX, L1y), QPointF(X, L1y))) m_items.push_back(l);
-    if (auto* l = m_addLine(QPointF(pinX, L2y), QPointF(X, L2y))) m_items.push_back(l);
-    if (auto* l = m_addLine(QPointF(pinX, L3y), QPointF(X, L3y))) m_items.push_back(l);
+    // Rama, doprowadzenia i opisy — wspólny szablon; tytuł zależny od instancji
+    auto* body = new DeviceBodyItem(&tpl, QStringLiteral("ZASILANIE 3F (%1)").arg(m_prefix.left(m_prefix.size()-1)));
+    body->setPos(X, Y);
+    body->setZValue(0.5);
+    m_scene->addItem(body);
+    m_track(body); m_items.push_back(body);
 
-    const QString pL1 = m_prefix + "L1";
-    const QString pL2 = m_prefix + "L2";
-    const QString pL3 = m_prefix + "L3";
-
-    if (auto* t = m_addTerminal(pL1, QPointF(pinX, L1y))) { m_pins.insert(pL1); m_items.push_back(t); }
-    if (auto* t = m_addTerminal(pL2, QPointF(pinX, L2y))) { m_pins.insert(pL2); m_items.push_back(t); }
-    if (auto* t = m_addTerminal(pL3, QPointF(pinX, L3y))) { m_pins.insert(pL3); m_items.push_back(t); }
-
-    auto* l1 = m_scene->addSimpleText("L1");
-    l1->setBrush(ContactorView::colText()); l1->setScale(0.7); l1->setPos(QPointF(pinX - PX(20), L1y - PX(26)));
-    m_track(l1); m_items.push_back(l1);
-    auto* l2 = m_scene->addSimpleText("L2");
-    l2->setBrush(ContactorView::colText()); l2->setScale(0.7); l2->setPos(QPointF(pinX - PX(20), L2y - PX(26)));
-    m_track(l2); m_items.push_back(l2);
-    auto* l3 = m_scene->addSimpleText("L3");
-    l3->setBrush(ContactorView::colText()); l3->setScale(0.7); l3->setPos(QPointF(pinX - PX(20), L3y - PX(26)));
-    m_track(l3); m_items.push_back(l3);
+    QStringList names;
+    for (const DeviceTemplate::Pin& pin : tpl.pins) {
+        const QString name = m_prefix + pin.suffix;
+        if (auto* t = m_addTerminal(name, QPointF(X, Y) + pin.pos)) { m_pins.insert(name); m_items.push_back(t); }
+        names << name;
+    }
+    const QString pL1 = names.value(0);
+    const QString pL2 = names.value(1);
+    const QString pL3 = names.value(2);
+    m_phasePins = { pL1, pL2, pL3 };
 
     // Przycisk POWER (FAZA na L1/L2/L3)
     const QRectF rBtn(X + BW - PX(90), Y + BH/2 - PX(12), PX(70), PX(24));
@@ -86,3 +92,11 @@ void PowerBlock::build(const QPointF& off) {
         else    { emit requestRemovePhase(pL1); emit requestRemovePhase(pL2); emit requestRemovePhase(pL3); }
     });
 }
+
+void PowerBlock::syncButton(const QSet<QString>& phase)
+{
+    if (!m_btnPower) return;
+    bool all = !m_phasePins.isEmpty();
+    for (const QString& p : std::as_const(m_phasePins)) all = all && phase.contains(p);
+    m_btnPower->setOn(all);
+}
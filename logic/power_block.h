@@ -3,26 +3,25 @@
 #include <QPointF>
 #include <QVector>
 #include <QSet>
+#include <QStringList>
 #include <functional>
 
 class QGraphicsScene;
 class QGraphicsItem;
 class QGraphicsEllipseItem;
-class QGraphicsLineItem;
 class SchematicButton;
+struct DeviceTemplate;
 
 class PowerBlock : public QObject {
     Q_OBJECT
 public:
     using AddTerminalFn = std::function<QGraphicsEllipseItem*(const QString&, const QPointF&)>;
-    using AddLineFn     = std::function<QGraphicsLineItem*(const QPointF&, const QPointF&)>; // zwraca QGraphicsLineItem*
     using TrackFn       = std::function<void(QGraphicsItem*)>;
 
     PowerBlock(QGraphicsScene* scene,
                const QString& prefix,
                const QPointF& topLeft,
                AddTerminalFn addTerminal,
-               AddLineFn addLine,
                TrackFn track,
                QObject* parent = nullptr);
 
@@ -30,6 +29,11 @@ public:
     const QSet<QString>& pins() const { return m_pins; }
     const QVector<QGraphicsItem*>& items() const { return m_items; }
 
+    static const DeviceTemplate& deviceTemplate();
+
+    // POWER wciśnięty, gdy wszystkie trzy fazy są źródłami (bez emitowania sygnałów)
+    void syncButton(const QSet<QString>& phase);
+
 signals:
     void requestAddPhase(const QString& pin);
     void requestRemovePhase(const QString& pin);
@@ -41,11 +45,11 @@ private:
     QGraphicsScene* m_scene = nullptr;
     QString m_prefix;
     AddTerminalFn m_addTerminal;
-    AddLineFn     m_addLine;
     TrackFn       m_track;
 
-    QVector<QGraphicsItem*> m_items; // WSZYSTKIE itemy (rect, napisy, elipsy, linie, przycisk)
+    QVector<QGraphicsItem*> m_items; // WSZYSTKIE itemy (korpus, elipsy pinów, przycisk)
     QSet<QString>           m_pins;
 
     SchematicButton* m_btnPower = nullptr;
+    QStringList      m_phasePins;   // L1, L2, L3
 };
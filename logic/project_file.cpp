@@ -0,0 +1,341 @@
+#include "project_file.h"
+
+#include <QHash>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr char    MAGIC[8]     = { 'C', 'N', 'E', 'T', 'P', 'R', 'J', '\0' };
+constexpr int     HEADER_SIZE  = 32;
+constexpr int     SECTION_SIZE = 24;
+
+constexpr quint32 fourcc(const char (&s)[5]) {
+    return quint32(quint8(s[0])) | quint32(quint8(s[1])) << 8
+         | quint32(quint8(s[2])) << 16 | quint32(quint8(s[3])) << 24;
+}
+constexpr quint32 SEC_STRS = fourcc("STRS");
+constexpr quint32 SEC_DEVS = fourcc("DEVS");
+constexpr quint32 SEC_WIRE = fourcc("WIRE");
+constexpr quint32 SEC_PNTS = fourcc("PNTS");
+constexpr quint32 SEC_SRCS = fourcc("SRCS");
+constexpr quint32 SEC_VIEW = fourcc("VIEW");
+constexpr quint32 SEC_TYPS = fourcc("TYPS");
+
+constexpr int DEV_REC  = 24;
+constexpr int WIRE_REC = 16;
+constexpr int PNT_REC  = 16;
+constexpr int SRC_REC  = 8;
+constexpr int VIEW_REC = 24;
+constexpr int TYPE_REC = 4;
+
+template <typename T> T rd(const uchar* p) { return qFromLittleEndian<T>(p); }
+inline double rdF64(const uchar* p) {
+    const quint64 bits = qFromLittleEndian<quint64>(p);
+    double v; std::memcpy(&v, &bits, sizeof v); return v;
+}
+
+// Bufor zapisu: dopisywanie little-endian + wyrównanie sekcji
+struct Writer {
+    QByteArray out;
+
+    template <typename T> void put(T v) {
+        uchar b[sizeof(T)];
+        qToLittleEndian<T>(v, b);
+        out.append(reinterpret_cast<const char*>(b), int(sizeof(T)));
+    }
+    void putF64(double v) { quint64 bits; std::memcpy(&bits, &v, sizeof v); put<quint64>(bits); }
+    void align8() { while (out.size() % 8) out.append('\0'); }
+    void patch32(int at, quint32 v) { qToLittleEndian<quint32>(v, reinterpret_cast<uchar*>(out.data()) + at); }
+    void patch64(int at, quint64 v) { qToLittleEndian<quint64>(v, reinterpret_cast<uchar*>(out.data()) + at); }
+};
+
+} // namespace
+
+// ===================== Zapis =====================
+bool ProjectFile::save(const QString& path, const Data& data, QString* error) {
+    // Internowanie nazw pinów — każda nazwa zapisana raz
+    QHash<QString, quint32> ids;
+    QVector<QByteArray>     strings;
+    auto intern = [&](const QString& s) -> quint32 {
+        auto it = ids.constFind(s);
+        if (it != ids.constEnd()) return it.value();
+        const quint32 id = quint32(strings.size());
+        ids.insert(s, id);
+        strings.push_back(s.toUtf8());
+        return id;
+    };
+
+    struct WireRec { quint32 a, b, first, count; };
+    QVector<WireRec> wires;
+    wires.reserve(data.wires.size());
+    quint32 pointCount = 0;
+    for (const Wire& w : data.wires) {
+        wires.push_back({ intern(w.a), intern(w.b), pointCount, quint32(w.points.size()) });
+        pointCount += quint32(w.points.size());
+    }
+    QVector<QPair<quint32, quint32>> sources;
+    sources.reserve(data.sources.size());
+    for (const Source& s : data.sources)
+        sources.push_back(qMakePair(intern(s.pin), s.neutral ? 1u : 0u));
+
+    // Typy z katalogu: tablica nazw, urządzenie trzyma tylko jej indeks
+    QHash<QString, quint16> typeIds;
+    QVector<quint32>        types;
+    QVector<quint16>        deviceTypes(data.devices.size(), 0);
+    for (int i = 0; i < data.devices.size(); ++i) {
+        const Device& d = data.devices[i];
+        if (d.kind != DeviceKind::Catalog) continue;
+        auto it = typeIds.constFind(d.type);
+        if (it == typeIds.constEnd()) {
+            if (types.size() > 0xFFFF) {
+                if (error) *error = QObject::tr("Za dużo typów urządzeń w projekcie");
+                return false;
+            }
+            it = typeIds.insert(d.type, quint16(types.size()));
+            types.push_back(intern(d.type));
+        }
+        deviceTypes[i] = it.value();
+    }
+
+    const quint32 sectionCount = 7;
+    Writer w;
+    w.out.reserve(HEADER_SIZE + SECTION_SIZE * sectionCount
+                  + data.devices.size() * DEV_REC + wires.size() * WIRE_REC
+                  + int(pointCount) * PNT_REC + sources.size() * SRC_REC + strings.size() * 16);
+
+    // --- nagłówek + pusta tablica sekcji (uzupełniana niżej)
+    w.out.append(MAGIC, sizeof MAGIC);
+    w.put<quint32>(types.isEmpty() ? VERSION_BASE : VERSION_CATALOG);
+    w.put<quint32>(sectionCount);
+    w.put<quint64>(0);   // rozmiar pliku
+    w.put<quint64>(0);
+    const int table = w.out.size();
+    w.out.append(QByteArray(SECTION_SIZE * sectionCount, '\0'));
+    w.align8();
+
+    int section = 0;
+    auto begin = [&](quint32 id, quint32 count) {
+        w.align8();
+        const int entry = table + SECTION_SIZE * section++;
+        w.patch32(entry, id);
+        w.patch32(entry + 4, count);
+        w.patch64(entry + 8, quint64(w.out.size()));
+        return entry;
+    };
+    auto end = [&](int entry) {
+        const quint64 offset = qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(w.out.constData()) + entry + 8);
+        w.patch64(entry + 16, quint64(w.out.size()) - offset);
+    };
+
+    int e = begin(SEC_STRS, quint32(strings.size()));
+    {
+        quint32 off = 0;
+        for (const QByteArray& s : std::as_const(strings)) { w.put<quint32>(off); off += quint32(s.size()); }
+        w.put<quint32>(off);
+        for (const QByteArray& s : std::as_const(strings)) w.out.append(s);
+    }
+    end(e);
+
+    e = begin(SEC_DEVS, quint32(data.devices.size()));
+    for (int i = 0; i < data.devices.size(); ++i) {
+        const Device& d = data.devices[i];
+        w.put<quint8>(quint8(d.kind)); w.put<quint8>(0); w.put<quint16>(deviceTypes[i]);
+        w.put<qint32>(d.index);
+        w.putF64(d.topLeft.x()); w.putF64(d.topLeft.y());
+    }
+    end(e);
+
+    e = begin(SEC_WIRE, quint32(wires.size()));
+    for (const WireRec& r : std::as_const(wires)) {
+        w.put<quint32>(r.a); w.put<quint32>(r.b); w.put<quint32>(r.first); w.put<quint32>(r.count);
+    }
+    end(e);
+
+    e = begin(SEC_PNTS, pointCount);
+    for (const Wire& wr : data.wires)
+        for (const QPointF& p : wr.points) { w.putF64(p.x()); w.putF64(p.y()); }
+    end(e);
+
+    e = begin(SEC_SRCS, quint32(sources.size()));
+    for (const auto& s : std::as_const(sources)) { w.put<quint32>(s.first); w.put<quint32>(s.second); }
+    end(e);
+
+    e = begin(SEC_VIEW, 1);
+    w.putF64(data.view.scale); w.putF64(data.view.center.x()); w.putF64(data.view.center.y());
+    end(e);
+
+    e = begin(SEC_TYPS, quint32(types.size()));
+    for (quint32 id : std::as_const(types)) w.put<quint32>(id);
+    end(e);
+
+    w.align8();
+    w.patch64(16, quint64(w.out.size()));
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly) || f.write(w.out) != w.out.size() || !f.commit()) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    return true;
+}
+
+// ===================== Odczyt =====================
+bool ProjectFile::fail(QString* error, const QString& msg) {
+    close();
+    if (error) *error = msg;
+    return false;
+}
+
+void ProjectFile::close() {
+    if (m_mapped) m_file.unmap(const_cast<uchar*>(m_data));
+    m_mapped = false;
+    m_file.close();
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_strOffsets = m_strBlob = m_devs = m_wires = m_points = m_srcs = m_view = m_types = nullptr;
+    m_strCount = m_devCount = m_wireCount = m_pointCount = m_srcCount = m_typeCount = 0;
+    m_strings.clear();
+}
+
+bool ProjectFile::open(const QString& path, QString* error) {
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return fail(error, m_file.errorString());
+
+    m_size = m_file.size();
+    m_data   = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    m_mapped = m_data != nullptr;
+    if (!m_mapped) {   // np. system plików bez mmap — czytamy w całości
+        m_buffer = m_file.readAll();
+        m_data   = reinterpret_cast<const uchar*>(m_buffer.constData());
+        m_size   = m_buffer.size();
+    }
+
+    // --- nagłówek
+    if (m_size < HEADER_SIZE || std::memcmp(m_data, MAGIC, sizeof MAGIC) != 0)
+        return fail(error, QObject::tr("To nie jest plik projektu"));
+    const quint32 version = rd<quint32>(m_data + 8);
+    if (version == 0 || version > VERSION)
+        return fail(error, QObject::tr("Nieobsługiwana wersja pliku: %1").arg(version));
+    const quint32 sections = rd<quint32>(m_data + 12);
+    if (rd<quint64>(m_data + 16) != quint64(m_size)
+        || qint64(HEADER_SIZE) + qint64(sections) * SECTION_SIZE > m_size)
+        return fail(error, QObject::tr("Plik projektu jest uszkodzony (nagłówek)"));
+
+    // --- sekcje: jednorazowa walidacja granic, potem akcesory już nie sprawdzają
+    for (quint32 s = 0; s < sections; ++s) {
+        const uchar* e = m_data + HEADER_SIZE + s * SECTION_SIZE;
+        const quint32 id     = rd<quint32>(e);
+        const quint32 count  = rd<quint32>(e + 4);
+        const quint64 offset = rd<quint64>(e + 8);
+        const quint64 size   = rd<quint64>(e + 16);
+        if (offset > quint64(m_size) || size > quint64(m_size) - offset)
+            return fail(error, QObject::tr("Plik projektu jest uszkodzony (sekcja)"));
+        const uchar* p = m_data + offset;
+
+        auto fits = [&](int rec){ return quint64(count) * quint64(rec) <= size; };
+        switch (id) {
+        case SEC_STRS: {
+            if ((quint64(count) + 1) * 4 > size) return fail(error, QObject::tr("Plik projektu jest uszkodzony (nazwy)"));
+            m_strOffsets = p; m_strCount = count;
+            m_strBlob    = p + (quint64(count) + 1) * 4;
+            const quint64 blob = size - (quint64(count) + 1) * 4;
+            quint32 prev = 0;
+            for (quint32 i = 0; i <= count; ++i) {
+                const quint32 o = rd<quint32>(p + 4 * i);
+                if (o < prev || o > blob) return fail(error, QObject::tr("Plik projektu jest uszkodzony (nazwy)"));
+                prev = o;
+            }
+            break;
+        }
+        case SEC_DEVS: if (!fits(DEV_REC))  return fail(error, QObject::tr("Plik projektu jest uszkodzony (urządzenia)"));
+                       m_devs = p;   m_devCount = count;   break;
+        case SEC_WIRE: if (!fits(WIRE_REC)) return fail(error, QObject::tr("Plik projektu jest uszkodzony (połączenia)"));
+                       m_wires = p;  m_wireCount = count;  break;
+        case SEC_PNTS: if (!fits(PNT_REC))  return fail(error, QObject::tr("Plik projektu jest uszkodzony (punkty)"));
+                       m_points = p; m_pointCount = count; break;
+        case SEC_SRCS: if (!fits(SRC_REC))  return fail(error, QObject::tr("Plik projektu jest uszkodzony (źródła)"));
+                       m_srcs = p;   m_srcCount = count;   break;
+        case SEC_VIEW: if (count >= 1 && fits(VIEW_REC)) m_view = p; break;
+        case SEC_TYPS: if (!fits(TYPE_REC)) return fail(error, QObject::tr("Plik projektu jest uszkodzony (typy)"));
+                       m_types = p;  m_typeCount = count;  break;
+        default: break;   // sekcja z nowszej wersji — pomijamy
+        }
+    }
+    // --- odwołania między sekcjami
+    for (quint32 i = 0; i < m_wireCount; ++i) {
+        const uchar* r = m_wires + i * WIRE_REC;
+        const quint32 first = rd<quint32>(r + 8), n = rd<quint32>(r + 12);
+        if (rd<quint32>(r) >= m_strCount || rd<quint32>(r + 4) >= m_strCount
+            || first > m_pointCount || n > m_pointCount - first)
+            return fail(error, QObject::tr("Plik projektu jest uszkodzony (połączenie %1)").arg(i));
+    }
+    for (quint32 i = 0; i < m_srcCount; ++i) {
+        if (rd<quint32>(m_srcs + i * SRC_REC) >= m_strCount)
+            return fail(error, QObject::tr("Plik projektu jest uszkodzony (źródło %1)").arg(i));
+    }
+    for (quint32 i = 0; i < m_typeCount; ++i) {
+        if (rd<quint32>(m_types + i * TYPE_REC) >= m_strCount)
+            return fail(error, QObject::tr("Plik projektu jest uszkodzony (typ %1)").arg(i));
+    }
+    const DeviceKind lastKind = version >= VERSION_CATALOG ? DeviceKind::Catalog : DeviceKind::Motor3;
+    for (quint32 i = 0; i < m_devCount; ++i) {
+        const uchar* r = m_devs + i * DEV_REC;
+        if (r[0] > quint8(lastKind)
+            || (r[0] == quint8(DeviceKind::Catalog) && rd<quint16>(r + 2) >= m_typeCount))
+            return fail(error, QObject::tr("Plik projektu jest uszkodzony (urządzenie %1)").arg(i));
+    }
+
+    m_strings.resize(int(m_strCount));
+    return true;
+}
+
+QString ProjectFile::string(quint32 id) const {
+    QString& s = m_strings[int(id)];
+    if (s.isNull()) {
+        const quint32 a = rd<quint32>(m_strOffsets + 4 * id);
+        const quint32 b = rd<quint32>(m_strOffsets + 4 * (id + 1));
+        s = QString::fromUtf8(reinterpret_cast<const char*>(m_strBlob + a), int(b - a));
+    }
+    return s;
+}
+
+ProjectFile::Device ProjectFile::device(int i) const {
+    const uchar* r = m_devs + quint64(i) * DEV_REC;
+    Device d;
+    d.kind    = DeviceKind(r[0]);
+    d.index   = rd<qint32>(r + 4);
+    d.topLeft = QPointF(rdF64(r + 8), rdF64(r + 16));
+    if (d.kind == DeviceKind::Catalog)
+        d.type = string(rd<quint32>(m_types + quint64(rd<quint16>(r + 2)) * TYPE_REC));
+    return d;
+}
+
+quint32 ProjectFile::wirePinA(int i) const { return rd<quint32>(m_wires + quint64(i) * WIRE_REC); }
+quint32 ProjectFile::wirePinB(int i) const { return rd<quint32>(m_wires + quint64(i) * WIRE_REC + 4); }
+int     ProjectFile::wirePointCount(int i) const { return int(rd<quint32>(m_wires + quint64(i) * WIRE_REC + 12)); }
+
+QPointF ProjectFile::wirePoint(int i, int k) const {
+    const quint32 first = rd<quint32>(m_wires + quint64(i) * WIRE_REC + 8);
+    const uchar* p = m_points + (quint64(first) + quint64(k)) * PNT_REC;
+    return QPointF(rdF64(p), rdF64(p + 8));
+}
+
+ProjectFile::Source ProjectFile::source(int i) const {
+    const uchar* r = m_srcs + quint64(i) * SRC_REC;
+    return Source{ string(rd<quint32>(r)), rd<quint32>(r + 4) != 0 };
+}
+
+ProjectFile::ViewState ProjectFile::viewState() const {
+    ViewState v;
+    if (!m_view) return v;
+    v.scale  = rdF64(m_view);
+    v.center = QPointF(rdF64(m_view + 8), rdF64(m_view + 16));
+    return v;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <QFile>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+// Plik projektu (.cnp) — zwarty format binarny, gotowy do mapowania w pamięć.
+//
+//   nagłówek (32 B):  magic "CNETPRJ\0", u32 wersja, u32 liczba sekcji, u64 rozmiar pliku, u64 0
+//   tablica sekcji:   { u32 id, u32 liczba rekordów, u64 offset, u64 rozmiar } x N
+//   sekcje (wyrównane do 8 B):
+//     STRS  tablica nazw pinów (internowana): u32 offset[n+1], potem UTF-8
+//     DEVS  urządzenia: { u8 rodzaj, u8 0, u16 typ, i32 numer, f64 x, f64 y } 24 B
+//     TYPS  typy z katalogu: { u32 nazwa (STRS) }; „typ” w DEVS to indeks tutaj  4 B
+//     WIRE  połączenia: { u32 pinA, u32 pinB, u32 pierwszy punkt, u32 liczba } 16 B
+//     PNTS  punkty łamanych mostków: { f64 x, f64 y }                           16 B
+//     SRCS  źródła: { u32 pin, u32 rodzaj (0 = FAZA, 1 = ZERO) }               8 B
+//     VIEW  widok: { f64 skala, f64 środek x, f64 środek y }                   24 B
+//
+// Wszystkie liczby są little-endian. Czytnik nie kopiuje danych — po jednorazowej
+// walidacji akcesory czytają rekordy wprost z mapowania. Nieznane sekcje są
+// pomijane (nowsze pliki w tej samej wersji głównej dalej się otwierają).
+//
+// Wersje: 1 — bez urządzeń z katalogu; 2 — rodzaj Catalog w DEVS i sekcja TYPS.
+// Projekt bez urządzeń z katalogu zapisuje się jako 1, więc starsze czytniki
+// nadal go otwierają; z katalogiem — jako 2, więc odmawiają wersji zamiast
+// zgłaszać uszkodzony plik.
+class ProjectFile {
+public:
+    static constexpr quint32 VERSION         = 2;
+    static constexpr quint32 VERSION_BASE    = 1;   // projekt bez urządzeń z katalogu
+    static constexpr quint32 VERSION_CATALOG = 2;   // pierwsza wersja z DeviceKind::Catalog
+
+    enum class DeviceKind : quint8 { Contactor = 0, Power3 = 1, Motor3 = 2, Catalog = 3 };
+
+    struct Device {
+        DeviceKind kind = DeviceKind::Contactor;
+        int        index = 0;      // numer w prefiksie („K7_” -> 7)
+        QPointF    topLeft;
+        QString    type;           // Catalog: id typu w DeviceLibrary
+    };
+    struct Wire {
+        QString          a, b;
+        QVector<QPointF> points;   // pusta = połączenie bez geometrii (do trasowania)
+    };
+    struct Source {
+        QString pin;
+        bool    neutral = false;
+    };
+    struct ViewState {
+        qreal   scale = 1.0;
+        QPointF center;
+    };
+
+    // Pełny opis projektu do zapisu
+    struct Data {
+        QVector<Device> devices;
+        QVector<Wire>   wires;
+        QVector<Source> sources;
+        ViewState       view;
+    };
+
+    // ---- zapis (atomowy, przez QSaveFile)
+    static bool save(const QString& path, const Data& data, QString* error = nullptr);
+
+    // ---- odczyt
+    ProjectFile() = default;
+    ~ProjectFile() { close(); }
+    ProjectFile(const ProjectFile&) = delete;
+    ProjectFile& operator=(const ProjectFile&) = delete;
+
+    bool open(const QString& path, QString* error = nullptr);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    int     stringCount() const { return int(m_strCount); }
+    QString string(quint32 id) const;       // dekodowane raz, potem współdzielone
+
+    int     deviceCount() const { return int(m_devCount); }
+    Device  device(int i) const;
+
+    int     wireCount() const { return int(m_wireCount); }
+    quint32 wirePinA(int i) const;          // id w tablicy nazw
+    quint32 wirePinB(int i) const;
+    int     wirePointCount(int i) const;
+    QPointF wirePoint(int i, int k) const;
+
+    int     sourceCount() const { return int(m_srcCount); }
+    Source  source(int i) const;
+
+    ViewState viewState() const;
+
+private:
+    bool fail(QString* error, const QString& msg);
+
+    QFile          m_file;
+    QByteArray     m_buffer;                // gdy mapowanie się nie uda
+    const uchar*   m_data = nullptr;
+    qint64         m_size = 0;
+    bool           m_mapped = false;
+
+    const uchar*   m_strOffsets = nullptr;  quint32 m_strCount = 0;
+    const uchar*   m_strBlob = nullptr;
+    const uchar*   m_devs = nullptr;        quint32 m_devCount = 0;
+    const uchar*   m_wires = nullptr;       quint32 m_wireCount = 0;
+    const uchar*   m_points = nullptr;      quint32 m_pointCount = 0;
+    const uchar*   m_srcs = nullptr;        quint32 m_srcCount = 0;
+    const uchar*   m_view = nullptr;
+    const uchar*   m_types = nullptr;       quint32 m_typeCount = 0;
+
+    mutable QVector<QString> m_strings;     // pamięć podręczna zdekodowanych nazw
+};
@@ -0,0 +1,113 @@
+#include "project_import.h"
+#include "contactor_LC1D09_LADC22.h"
+#include "power_block.h"
+#include "motor_3phase_block.h"
+#include "device_template.h"
+#include "device_library.h"
+
+#include <utility>
+
+QString devicePrefix(const ProjectFile::Device& d) {
+    switch (d.kind) {
+    case ProjectFile::DeviceKind::Contactor: return QStringLiteral("K%1_").arg(d.index);
+    case ProjectFile::DeviceKind::Power3:    return QStringLiteral("P%1_").arg(d.index);
+    case ProjectFile::DeviceKind::Motor3:    return QStringLiteral("M%1_").arg(d.index);
+    case ProjectFile::DeviceKind::Catalog:
+        if (const DeviceType* t = DeviceLibrary::instance().find(d.type))
+            return t->prefix + QString::number(d.index) + QLatin1Char('_');
+        break;
+    }
+    return {};
+}
+
+ImportedProject importProject(const QString& path, const ContactCondFactory& contactCond,
+                              const OverloadCondFactory& overloadCond) {
+    ImportedProject out;
+
+    ProjectFile file;
+    if (!file.open(path, &out.error))
+        return out;
+
+    // --- rekordy dla sceny (nazwy pinów dekodowane raz, potem współdzielone)
+    out.devices.reserve(file.deviceCount());
+    for (int i = 0; i < file.deviceCount(); ++i)
+        out.devices.push_back(file.device(i));
+
+    out.wires.reserve(file.wireCount());
+    for (int i = 0; i < file.wireCount(); ++i) {
+        ProjectFile::Wire w;
+        w.a = file.string(file.wirePinA(i));
+        w.b = file.string(file.wirePinB(i));
+        const int n = file.wirePointCount(i);
+        w.points.resize(n);
+        for (int k = 0; k < n; ++k) w.points[k] = file.wirePoint(i, k);
+        out.wires.push_back(std::move(w));
+    }
+
+    out.sources.reserve(file.sourceCount());
+    for (int i = 0; i < file.sourceCount(); ++i)
+        out.sources.push_back(file.source(i));
+    out.view = file.viewState();
+
+    // --- graf logiczny: piny i styki wprost z szablonów typów
+    const DeviceTemplate& kTpl = Contactor_LC1D09_LADC22::deviceTemplate();
+    const DeviceTemplate& pTpl = PowerBlock::deviceTemplate();
+    const DeviceTemplate& mTpl = Motor3PhaseBlock::deviceTemplate();
+
+    for (const ProjectFile::Device& d : std::as_const(out.devices)) {
+        if (d.kind == ProjectFile::DeviceKind::Contactor || d.kind == ProjectFile::DeviceKind::Catalog) {
+            const DeviceType* type = d.kind == ProjectFile::DeviceKind::Catalog
+                                   ? DeviceLibrary::instance().find(d.type) : nullptr;
+            if (d.kind == ProjectFile::DeviceKind::Catalog && !type) {
+                if (!out.unknownTypes.contains(d.type)) out.unknownTypes << d.type;
+                out.unknownDevices.push_back(d);
+                continue;
+            }
+            const DeviceTemplate& tpl = type ? type->tpl : kTpl;
+            const QString K = devicePrefix(d);
+            if (out.contactors.contains(K)) continue;
+            out.templates.insert(K, &tpl);
+            QStringList& pins = out.devicePins[K];
+            for (const DeviceTemplate::Pin& p : tpl.pins) {
+                pins << K + p.suffix;
+                out.nodes.insert(pins.back());
+            }
+            const int id = tpl.coilA >= 0 ? out.contactors.add(K, pins[tpl.coilA], pins[tpl.coilB])
+                                          : out.contactors.add(K);
+            for (const DeviceTemplate::Contact& c : tpl.contacts)
+                out.edges.addPair(pins[c.pinA], pins[c.pinB], contactCond(id, c.normallyOpen), K);
+        } else if (d.kind == ProjectFile::DeviceKind::Power3) {
+            const QString P = QStringLiteral("P%1_").arg(d.index);
+            if (out.powers.contains(P)) continue;
+            out.powers.insert(P);
+            QStringList& pins = out.devicePins[P];
+            for (const DeviceTemplate::Pin& p : pTpl.pins) {
+                pins << P + p.suffix;
+                out.nodes.insert(pins.back());
+            }
+        } else if (d.kind == ProjectFile::DeviceKind::Motor3) {
+            const QString M = QStringLiteral("M%1_").arg(d.index);
+            if (out.motors.contains(M)) continue;
+            const int id = out.motors.add(M);
+            out.templates.insert(M, &mTpl);
+            QStringList& pins = out.devicePins[M];
+            for (const DeviceTemplate::Pin& p : mTpl.pins) {
+                pins << M + p.suffix;
+                out.nodes.insert(pins.back());
+            }
+            for (const DeviceTemplate::Contact& c : mTpl.contacts)
+                out.edges.addPair(pins[c.pinA], pins[c.pinB], overloadCond(id), M);
+        }
+    }
+
+    for (const ProjectFile::Wire& w : std::as_const(out.wires)) {
+        out.edges.addPair(w.a, w.b, {});
+        out.nets.addWire(w.a, w.b);
+        out.nodes.insert(w.a);
+        out.nodes.insert(w.b);
+    }
+    for (const ProjectFile::Source& s : std::as_const(out.sources))
+        out.nodes.insert(s.pin);
+
+    return out;
+}
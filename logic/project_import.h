@@ -0,0 +1,53 @@
+#pragma once
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+#include "contactor_bank.h"
+#include "edge_store.h"
+#include "net_index.h"
+#include "thermal_bank.h"
+#include "project_file.h"
+
+struct DeviceTemplate;
+
+// Wynik wczytania projektu w wątku roboczym: zdekodowane rekordy dla sceny
+// oraz gotowy graf logiczny (krawędzie styków i mostków, piny urządzeń).
+// Wątek GUI przejmuje graf jednym przeniesieniem, a grafikę dokłada porcjami.
+struct ImportedProject {
+    QString error;                              // niepuste = wczytanie nieudane
+
+    QVector<ProjectFile::Device> devices;
+    QVector<ProjectFile::Wire>   wires;
+    QVector<ProjectFile::Source> sources;
+    ProjectFile::ViewState       view;
+
+    // Graf logiczny
+    EdgeStore                    edges;
+    NetIndex                     nets;          // sieci mostków
+    QHash<QString, QStringList>  devicePins;    // prefiks -> piny (styczniki, zasilania, silniki)
+    ContactorBank                contactors;    // także urządzenia z katalogu; numery = warunki styków
+    QSet<QString>                powers;
+    MotorThermalBank             motors;        // numery = warunki styków 95-96
+    QSet<QString>                nodes;         // wszystkie węzły logiczne
+    QHash<QString, const DeviceTemplate*>    templates;  // prefiks -> szablon (styki NO/NC)
+    QStringList                  unknownTypes;  // typy spoza katalogu (urządzenia pominięte)
+    QVector<ProjectFile::Device> unknownDevices; // ich rekordy — zapisywane z powrotem bez zmian
+};
+
+// Prefiks instancji („K7_”, „KA2_”); pusty dla typu spoza katalogu
+QString devicePrefix(const ProjectFile::Device& d);
+
+// Warunek przewodzenia styku (NO/NC) stycznika o numerze id w ImportedProject::contactors —
+// tworzony w wątku roboczym, wywoływany dopiero w wątku GUI (po przejęciu banku)
+using ContactCondFactory  = std::function<EdgeStore::Cond(int id, bool isNO)>;
+// Warunek styku NC 95-96 przekaźnika silnika o numerze id w ImportedProject::motors
+using OverloadCondFactory = std::function<EdgeStore::Cond(int id)>;
+
+// Wczytuje plik (mapowanie) i buduje graf — bez dotykania sceny; dowolny wątek.
+// Szablony urządzeń i katalog (DeviceLibrary) muszą być wcześniej zainicjalizowane w wątku GUI.
+ImportedProject importProject(const QString& path, const ContactCondFactory& contactCond,
+                              const OverloadCondFactory& overloadCond);
@@ -3,10 +3,25 @@
 #include <QVector>
 #include <QString>
 #include <functional>  // <— potrzebne do std::function
+#include <atomic>
 
 struct Edge {
     QString a, b;
-    std::function<bool()> conducts;
+    std::function<bool()> conducts;   // pusty = przewodzi zawsze (mostek)
+    QString owner;          // urządzenie/mostek, do którego należy krawędź (indeks w EdgeStore)
+};
+
+class ConductionGraph;
+
+// Przerwanie przeliczenia, które straciło sens: przyszło nowsze żądanie niż to,
+// dla którego liczymy. Sprawdzane w bezpiecznych punktach (między poziomami BFS,
+// co porcję kolejki) — wynik przerwanego przebiegu jest niepełny i idzie do kosza.
+struct CancelToken {
+    const std::atomic<quint64>* latest = nullptr;    // numer najnowszego żądania
+    quint64                     generation = 0;      // numer liczonego żądania
+    bool isCancelled() const {
+        return latest && latest->load(std::memory_order_relaxed) != generation;
+    }
 };
 
 struct HotResult {
@@ -25,3 +40,16 @@ QSet<QString> computeInterPhaseFault(const QVector<Edge>& edges,
 QHash<QString,int> computePhaseMask(const QVector<Edge>& edges,
                                      const QSet<QString>& phaseSources);
 
+// To samo na grafie zwartym (ConductionGraph po refresh()) — dla przeliczeń
+// powtarzanych na niezmienionej strukturze; wersje z QVector<Edge> budują go za każdym razem.
+// Po przerwaniu (cancel) wynik jest niepełny.
+HotResult computeHot(const ConductionGraph& graph,
+                     const QSet<QString>& phaseSources,
+                     const QSet<QString>& neutralSources,
+                     const CancelToken& cancel = {});
+QHash<QString,int> computePhaseMask(const ConductionGraph& graph,
+                                    const QSet<QString>& phaseSources,
+                                    const CancelToken& cancel = {});
+
+// Węzły z więcej niż jedną fazą w masce z computePhaseMask
+QSet<QString> interPhaseFaults(const QHash<QString,int>& phaseMask);
@@ -0,0 +1,180 @@
+#include "sim_worker.h"
+#include "propagation.h"
+#include <QElapsedTimer>
+
+SimWorker::SimWorker(std::function<void()> notify)
+    : m_loop(std::move(notify), [this] { drain(); })
+{
+}
+
+SimWorker::~SimWorker() {
+    stop();
+}
+
+// ===================== Wątek GUI =====================
+
+quint64 SimWorker::requestRecompute() {
+    Op op;
+    op.kind = Op::Kind::Recompute;
+    op.generation = ++m_generation;
+    m_latest.store(m_generation, std::memory_order_relaxed);   // unieważnia przeliczenie w toku
+    post(std::move(op));
+    return m_generation;
+}
+
+// ===================== Wątek roboczy =====================
+void SimWorker::drain() {
+    quint64 requested = 0;
+    Op op;
+    while (m_loop.pop(op)) {
+        if (op.kind == Op::Kind::Recompute) requested = op.generation;
+        else                                apply(op);
+    }
+    if (requested) recompute(requested);    // przerwane: nowsze żądanie już jest w kolejce
+}
+
+// Numery w banku i w m_tripped są stałe do usunięcia urządzenia, a jego krawędzie znikają razem z nim
+EdgeStore::Cond SimWorker::contactCond(int id, bool isNO) const {
+    return [this, id, isNO]() -> bool {
+        const bool en = m_contactors.isEnergized(id);
+        return isNO ? en : !en;
+    };
+}
+
+EdgeStore::Cond SimWorker::overloadCond(int motor) const {
+    return [this, motor]() -> bool { return !m_tripped[motor]; };
+}
+
+void SimWorker::apply(const Op& op) {
+    using Kind = Op::Kind;
+    switch (op.kind) {
+    case Kind::Clear:
+        m_edges.clear();
+        m_contactors.clear();
+        m_phaseSources.clear();
+        m_neutralSources.clear();
+        m_motorIds.clear();
+        m_tripped.clear();
+        m_motorFree.clear();
+        break;
+    case Kind::AddContactor: {
+        const int id = m_contactors.add(op.prefix, op.a, op.b);
+        if (id == ContactorBank::NONE) break;
+        for (const Contact& c : op.contacts)
+            m_edges.addPair(c.a, c.b, contactCond(id, c.isNO), op.prefix);
+        break;
+    }
+    case Kind::AddMotor: {
+        if (m_motorIds.contains(op.prefix)) break;
+        int id;
+        if (!m_motorFree.isEmpty()) {
+            id = m_motorFree.takeLast();
+            m_tripped[id] = 0;
+        } else {
+            id = m_tripped.size();
+            m_tripped.push_back(0);
+        }
+        m_motorIds.insert(op.prefix, id);
+        for (const Contact& c : op.contacts)
+            m_edges.addPair(c.a, c.b, overloadCond(id), op.prefix);
+        break;
+    }
+    case Kind::RemoveDevice: {
+        m_edges.removeOwner(op.prefix);
+        for (const QString& pin : op.pins) {
+            m_edges.removePin(pin);
+            m_phaseSources.remove(pin);
+            m_neutralSources.remove(pin);
+        }
+        if (m_contactors.remove(op.prefix)) break;
+        const auto it = m_motorIds.find(op.prefix);
+        if (it == m_motorIds.end()) break;
+        m_tripped[it.value()] = 0;
+        m_motorFree.push_back(it.value());
+        m_motorIds.erase(it);
+        break;
+    }
+    case Kind::AddWire:
+        m_edges.addPair(op.a, op.b, {});
+        break;
+    case Kind::RemoveWire:
+        m_edges.removeBetween(op.a, op.b);
+        break;
+    case Kind::SetSource: {
+        QSet<QString>& set = op.neutral ? m_neutralSources : m_phaseSources;
+        if (op.on) set.insert(op.a);
+        else       set.remove(op.a);
+        break;
+    }
+    case Kind::SetTripped: {
+        const auto it = m_motorIds.constFind(op.prefix);
+        if (it != m_motorIds.constEnd()) m_tripped[it.value()] = op.on;
+        break;
+    }
+    case Kind::Recompute:
+        break;
+    }
+}
+
+// Koszt ~ liczba gorących pinów, ale w wątku roboczym — GUI dostaje tylko listę zmian
+QSet<QString> SimWorker::diffSinceLast(const Result& r) {
+    QSet<QString> out;
+    auto diff = [&](QSet<QString>& before, const QSet<QString>& after) {
+        for (const QString& n : after)  if (!before.contains(n)) out.insert(n);
+        for (const QString& n : before) if (!after.contains(n))  out.insert(n);
+        before = after;
+    };
+    diff(m_lastPhase,   r.phaseHot);
+    diff(m_lastNeutral, r.neutralHot);
+    diff(m_lastInter,   r.interPhase);
+    return out;
+}
+
+// Ta sama iteracja co dawniej w wątku GUI: gorące zbiory → energizacja → aż do stabilizacji.
+// Przerwanie sprawdzane po każdym przebiegu propagacji, przed loadCoils/evaluate.
+bool SimWorker::recompute(quint64 generation) {
+    QElapsedTimer timer;
+    timer.start();
+    Result& r = m_loop.back();
+    const CancelToken cancel{ &m_latest, generation };
+
+    // Struktura zwarta tylko po edycji grafu; w pętli zmieniają się same styki
+    if (m_graphRevision != m_edges.revision()) {
+        m_graph.build(m_edges.edges());
+        m_graphRevision = m_edges.revision();
+    }
+
+    int it = 0;
+    while (it < MAX_ITERATIONS) {
+        if (cancel.isCancelled()) return false;
+        ++it;
+        m_graph.refresh();
+        HotResult hot = computeHot(m_graph, m_phaseSources, m_neutralSources, cancel);
+        if (cancel.isCancelled()) return false;
+        r.phaseHot   = std::move(hot.phaseHot);
+        r.neutralHot = std::move(hot.neutralHot);
+        m_contactors.loadCoils(r.phaseHot, r.neutralHot);
+        if (m_contactors.evaluate() == 0) break;
+    }
+    m_graph.refresh();                          // styki po ostatniej zmianie energizacji
+    r.phaseMask  = computePhaseMask(m_graph, m_phaseSources, cancel);
+    if (cancel.isCancelled()) return false;
+    r.interPhase = interPhaseFaults(r.phaseMask);
+    if (!r.sources.build(m_graph, m_phaseSources, m_neutralSources, cancel)) return false;
+
+    r.energized.clear();
+    for (int id = 0; id < m_contactors.size(); ++id)
+        if (m_contactors.isEnergized(id)) r.energized << m_contactors.prefix(id);
+
+    // Zmiany od ostatniego wyniku, który GUI odebrało: gdy poprzedni przepadł, jego zmiany przechodzą dalej
+    QSet<QString> fresh = diffSinceLast(r);
+    r.changed = m_unseen;
+    r.changed.unite(fresh);
+    const QSet<QString> published = r.changed;
+
+    r.generation = generation;
+    r.iterations = it;
+    r.ms = timer.nsecsElapsed() / 1e6;
+    m_unseen = m_loop.publish() ? published : std::move(fresh);
+    return true;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+
+#include "conduction_graph.h"
+#include "contactor_bank.h"
+#include "edge_store.h"
+#include "source_index.h"
+#include "worker_loop.h"
+
+// Rdzeń symulacji w osobnym wątku.
+//
+// Wątek roboczy ma własny graf, własny bank styczników i własne źródła —
+// warunki styków powstają w nim i czytają tylko jego stan, więc nic nie jest
+// współdzielone z wątkiem GUI. Edycje przychodzą jako operacje (dane, bez
+// domknięć) przez WorkerLoop; worker zdejmuje wszystkie zaległe naraz,
+// nanosi je i dopiero wtedy liczy (kilka szybkich edycji = jedno przeliczenie).
+//
+// Wynik (zbiory gorących pinów, zwarcia, maski faz, zasilone cewki) trafia do
+// potrójnego bufora pętli; notify() — najwyżej raz, dopóki GUI nie odbierze wyniku.
+//
+// Każde żądanie przeliczenia ma numer; GUI zapisuje numer najnowszego w m_latest.
+// Przeliczenie starszego żądania sprawdza go w bezpiecznych punktach (pętla
+// styczników, poziomy BFS) i przerywa się, zanim dotknie banku styczników —
+// bank widzi tylko pełne iteracje, a policzony zostaje tylko stan najnowszej edycji.
+class SimWorker {
+public:
+    static constexpr int MAX_ITERATIONS = 12;      // bezpiecznik pętli styczników
+
+    struct Contact {
+        QString a, b;
+        bool    isNO = true;
+    };
+
+    struct Op {
+        enum class Kind : quint8 {
+            Clear,          // cały model
+            AddContactor,   // prefix, a/b = piny cewki (puste = bez cewki), contacts
+            AddMotor,       // prefix, contacts = styk NC 95-96 przekaźnika F
+            RemoveDevice,   // prefix, pins = piny urządzenia (mostki i źródła na nich)
+            AddWire,        // a, b
+            RemoveWire,     // a, b
+            SetSource,      // a, neutral, on
+            SetTripped,     // prefix (silnik), on = wyzwolony
+            Recompute,      // generation
+        };
+        Kind             kind = Kind::Recompute;
+        QString          prefix;
+        QString          a, b;
+        QVector<Contact> contacts;
+        QStringList      pins;
+        bool             neutral = false;
+        bool             on = false;
+        quint64          generation = 0;
+    };
+
+    struct Result {
+        quint64            generation = 0;   // żądanie przeliczenia, na które to odpowiedź
+        QSet<QString>      phaseHot;
+        QSet<QString>      neutralHot;
+        QSet<QString>      interPhase;       // zwarcie międzyfazowe (aktywny tor)
+        QHash<QString,int> phaseMask;
+        QStringList        energized;        // prefiksy styczników z zasiloną cewką
+        SourceIndex        sources;          // skąd zasilanie (stan po ostatniej iteracji)
+        QSet<QString>      changed;          // węzły, których FAZA/ZERO/zwarcie mogły się zmienić
+                                             // od ostatniego odebranego wyniku (nadzbiór — do śladu)
+        int                iterations = 0;
+        double             ms = 0.0;
+    };
+
+    // notify() jest wołane z wątku roboczego — ma tylko zlecić odbiór (np. kolejkowane wywołanie)
+    explicit SimWorker(std::function<void()> notify);
+    ~SimWorker();
+    SimWorker(const SimWorker&) = delete;
+    SimWorker& operator=(const SimWorker&) = delete;
+
+    // ---- wątek GUI (jedyny producent)
+    void    post(Op op) { m_loop.post(std::move(op)); }
+    quint64 requestRecompute();                   // zwraca numer żądania
+    quint64 generation() const { return m_generation; }
+    void    stop() { m_loop.stop(); }             // zatrzymanie i dołączenie wątku
+
+    // ---- wątek GUI (jedyny czytelnik): true = result() zawiera nowszy wynik
+    bool    fetch() { return m_loop.fetch(); }
+    Result& result() { return m_loop.result(); }
+
+private:
+    void drain();                                 // paczka operacji + przeliczenie (WorkerLoop)
+    void apply(const Op& op);
+    bool recompute(quint64 generation);           // false = przerwane przez nowsze żądanie
+    QSet<QString> diffSinceLast(const Result& r); // zmiany względem poprzedniego wyniku
+
+    EdgeStore::Cond contactCond(int id, bool isNO) const;
+    EdgeStore::Cond overloadCond(int motor) const;
+
+    // Model — wyłącznie wątek roboczy
+    EdgeStore            m_edges;
+    ConductionGraph      m_graph;             // zwarta postać m_edges (przebudowa po zmianie revision())
+    quint64              m_graphRevision = 0;
+    ContactorBank        m_contactors;
+    QSet<QString>        m_phaseSources;
+    QSet<QString>        m_neutralSources;
+    QHash<QString, int>  m_motorIds;          // prefiks silnika -> numer w m_tripped
+    QVector<quint8>      m_tripped;
+    QVector<int>         m_motorFree;
+
+    // Ostatni opublikowany stan (kopie współdzielone) i zmiany jeszcze nieodebrane przez GUI
+    QSet<QString>        m_lastPhase, m_lastNeutral, m_lastInter;
+    QSet<QString>        m_unseen;
+
+    // Styk z wątkiem GUI
+    std::atomic<quint64> m_latest{0};         // numer najnowszego żądania (CancelToken)
+    quint64              m_generation = 0;    // wątek GUI
+    WorkerLoop<Op, Result> m_loop;            // ostatni — wątek startuje po reszcie pól
+};
@@ -0,0 +1,104 @@
+#include "source_index.h"
+#include "conduction_graph.h"
+#include <algorithm>
+
+// ===================== Budowa =====================
+bool SourceIndex::build(const ConductionGraph& graph,
+                        const QSet<QString>& phaseSources,
+                        const QSet<QString>& neutralSources,
+                        const CancelToken& cancel) {
+    const int n = graph.nodeCount();
+    m_id = graph.ids();
+    m_edges = graph.edges();
+    m_phaseSet = phaseSources;
+    m_neutralSet = neutralSources;
+    m_label.fill(-1, n);
+    m_up.fill(-1, n);
+    m_upEdge.fill(-1, n);
+    m_depth.fill(0, n);
+    m_phase.clear();
+    m_neutral.clear();
+
+    QVector<int> queue;
+    int visited = 0;
+    auto add = [&](const QString& s, bool neutral) {
+        const int root = graph.node(s);
+        if (root < 0) return true;
+        int L = m_label[root];
+        if (L < 0) {
+            // Nowa składowa: drzewo BFS z korzeniem w tym źródle
+            L = m_phase.size();
+            m_phase.push_back({});
+            m_neutral.push_back({});
+            m_label[root] = L;
+            queue.clear();
+            queue.push_back(root);
+            for (int head = 0; head < queue.size(); ++head) {
+                if ((++visited & (CANCEL_CHECK - 1)) == 0 && cancel.isCancelled()) return false;
+                const int u = queue[head];
+                graph.forEachOpen(u, [&](int v, int e) {
+                    if (m_label[v] >= 0) return;
+                    m_label[v] = L;
+                    m_up[v] = u;
+                    m_upEdge[v] = e;
+                    m_depth[v] = m_depth[u] + 1;
+                    queue.push_back(v);
+                });
+            }
+        }
+        (neutral ? m_neutral : m_phase)[L] << s;
+        return true;
+    };
+    for (const QString& s : phaseSources)
+        if (!add(s, false)) return false;
+    for (const QString& s : neutralSources)
+        if (!add(s, true)) return false;
+
+    for (QStringList& l : m_phase)   l.sort();
+    for (QStringList& l : m_neutral) l.sort();
+    return true;
+}
+
+void SourceIndex::clear() {
+    *this = SourceIndex();
+}
+
+// ===================== Zapytania =====================
+int SourceIndex::label(const QString& pin) const {
+    const int v = m_id.value(pin, -1);
+    return v < 0 ? -1 : m_label[v];
+}
+
+QStringList SourceIndex::phaseSources(const QString& pin) const {
+    const int L = label(pin);
+    if (L >= 0) return m_phase[L];
+    return m_phaseSet.contains(pin) ? QStringList{pin} : QStringList();
+}
+
+QStringList SourceIndex::neutralSources(const QString& pin) const {
+    const int L = label(pin);
+    if (L >= 0) return m_neutral[L];
+    return m_neutralSet.contains(pin) ? QStringList{pin} : QStringList();
+}
+
+// Obie strony w górę drzewa do wspólnego przodka: źródło -> przodek, potem przodek -> pin
+QVector<SourceIndex::Step> SourceIndex::contactsOnPath(const QString& pin, const QString& source) const {
+    int u = m_id.value(source, -1);
+    int v = m_id.value(pin, -1);
+    if (u < 0 || v < 0 || m_label[u] < 0 || m_label[u] != m_label[v]) return {};
+
+    QVector<Step> fromSource, fromPin;
+    auto climb = [&](int& x, QVector<Step>& out) {
+        const Edge& e = m_edges[m_upEdge[x]];
+        if (!e.owner.isEmpty()) out.push_back(Step{e.a, e.b, e.owner});
+        x = m_up[x];
+    };
+    while (m_depth[u] > m_depth[v]) climb(u, fromSource);
+    while (m_depth[v] > m_depth[u]) climb(v, fromPin);
+    while (u != v) {
+        climb(u, fromSource);
+        climb(v, fromPin);
+    }
+    std::reverse(fromPin.begin(), fromPin.end());
+    return fromSource + fromPin;
+}
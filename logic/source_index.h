@@ -0,0 +1,59 @@
+#pragma once
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "propagation.h"
+
+class ConductionGraph;
+
+// Indeks odwrotny „skąd zasilanie”: które źródła FAZA/ZERO docierają do pinu
+// i przez jakie styki.
+//
+// Krawędzie są zawsze parami (EdgeStore::addPair), więc przewodzenie jest
+// symetryczne: źródła docierające do pinu to dokładnie źródła w jego spójnej
+// składowej grafu przewodzącego. build() przechodzi raz BFS-em od źródeł
+// i każdej składowej z co najmniej jednym źródłem nadaje etykietę z listą jej
+// źródeł; węzeł trzyma numer etykiety i rodzica w drzewie rozpinającym
+// składowej. Pytanie o źródła pinu to jedno wyszukanie (O(1)), ścieżka to
+// wspinaczka po drzewie do wspólnego przodka (O(długość ścieżki)).
+//
+// Indeks trzyma współdzielone kopie nazw i krawędzi grafu, więc po zbudowaniu
+// w wątku symulacji można go czytać w GUI — aż do następnego wyniku.
+class SourceIndex {
+public:
+    static constexpr int CANCEL_CHECK = 4096;   // co tyle węzłów sprawdzenie cancel
+
+    struct Step {                              // styk (krawędź z właścicielem) na ścieżce
+        QString a, b;
+        QString owner;                         // "K1_", "M1_"…
+    };
+
+    // Na grafie po refresh(); false = przerwane (cancel), indeks niepełny
+    bool build(const ConductionGraph& graph,
+               const QSet<QString>& phaseSources,
+               const QSet<QString>& neutralSources,
+               const CancelToken& cancel = {});
+    void clear();
+
+    QStringList phaseSources(const QString& pin) const;     // posortowane
+    QStringList neutralSources(const QString& pin) const;
+
+    // Styki na ścieżce od źródła do pinu, w kolejności od źródła; pusta także bez połączenia
+    QVector<Step> contactsOnPath(const QString& pin, const QString& source) const;
+
+private:
+    int label(const QString& pin) const;
+
+    QHash<QString, int>  m_id;          // pin -> węzeł (z grafu)
+    QVector<Edge>        m_edges;       // krawędzie grafu (tylko a, b, owner)
+    QSet<QString>        m_phaseSet;    // źródła bez krawędzi: same sobie źródłem
+    QSet<QString>        m_neutralSet;
+
+    // per węzeł: etykieta (-1 = nie dociera żadne źródło), rodzic i krawędź od rodzica, głębokość
+    QVector<int>         m_label, m_up, m_upEdge, m_depth;
+    // per etykieta
+    QVector<QStringList> m_phase, m_neutral;
+};
@@ -0,0 +1,69 @@
+#include "spatial_index.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialIndex::SpatialIndex(qreal cellSize)
+    : m_cell(cellSize > 0.0 ? cellSize : 256.0) {}
+
+quint64 SpatialIndex::keyOf(int cx, int cy) {
+    return (quint64(quint32(cx)) << 32) | quint64(quint32(cy));
+}
+
+template <typename Fn>
+void SpatialIndex::forCells(const QRectF& r, Fn&& fn) const {
+    const QRectF n = r.normalized();
+    const int cx0 = int(std::floor(n.left()   / m_cell));
+    const int cx1 = int(std::floor(n.right()  / m_cell));
+    const int cy0 = int(std::floor(n.top()    / m_cell));
+    const int cy1 = int(std::floor(n.bottom() / m_cell));
+    for (int cy = cy0; cy <= cy1; ++cy)
+        for (int cx = cx0; cx <= cx1; ++cx)
+            fn(keyOf(cx, cy));
+}
+
+bool SpatialIndex::touches(const QRectF& a, const QRectF& b) {
+    const QRectF x = a.normalized(), y = b.normalized();
+    return x.left() <= y.right() && y.left() <= x.right()
+        && x.top() <= y.bottom() && y.top() <= x.bottom();
+}
+
+int SpatialIndex::insert(const QRectF& r) {
+    const int id = m_rects.size();
+    m_rects.push_back(r.normalized());
+    m_alive.push_back(true);
+    ++m_count;
+    forCells(r, [&](quint64 k){ m_buckets[k].push_back(id); });
+    return id;
+}
+
+void SpatialIndex::remove(int id) {
+    if (!isAlive(id)) return;
+    m_alive[id] = false;
+    --m_count;
+    forCells(m_rects[id], [&](quint64 k){
+        auto it = m_buckets.find(k);
+        if (it == m_buckets.end()) return;
+        it->removeOne(id);
+        if (it->isEmpty()) m_buckets.erase(it);
+    });
+}
+
+void SpatialIndex::clear() {
+    m_rects.clear();
+    m_alive.clear();
+    m_buckets.clear();
+    m_count = 0;
+}
+
+QVector<int> SpatialIndex::query(const QRectF& area) const {
+    QVector<int> out;
+    forCells(area, [&](quint64 k){
+        auto it = m_buckets.constFind(k);
+        if (it == m_buckets.constEnd()) return;
+        for (int id : it.value())
+            if (touches(m_rects[id], area)) out.push_back(id);
+    });
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
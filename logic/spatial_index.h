@@ -0,0 +1,36 @@
+#pragma once
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+// Prosty indeks przestrzenny: jednorodna siatka kubełków (hash komórek).
+// Przechowuje prostokąty (także zdegenerowane — odcinki H/V i punkty) pod
+// kolejnymi id; zapytanie zwraca id prostokątów stykających się z obszarem.
+// Kopia jest tania (kontenery Qt współdzielone niejawnie), więc migawkę można
+// oddać wątkom roboczym do odczytu.
+class SpatialIndex {
+public:
+    explicit SpatialIndex(qreal cellSize = 256.0);
+
+    int  insert(const QRectF& r);                 // zwraca id
+    void remove(int id);
+    void clear();
+
+    QVector<int>  query(const QRectF& area) const; // bez powtórzeń, rosnąco
+    const QRectF& rect(int id) const { return m_rects[id]; }
+    bool          isAlive(int id) const { return id >= 0 && id < m_alive.size() && m_alive[id]; }
+    int           count() const { return m_count; }
+
+    // Domknięte przedziały — odcinki o zerowej szerokości też się „przecinają”
+    static bool touches(const QRectF& a, const QRectF& b);
+
+private:
+    static quint64 keyOf(int cx, int cy);
+    template <typename Fn> void forCells(const QRectF& r, Fn&& fn) const;
+
+    qreal                         m_cell;
+    QVector<QRectF>               m_rects;
+    QVector<bool>                 m_alive;
+    QHash<quint64, QVector<int>>  m_buckets;
+    int                           m_count = 0;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+// Nieograniczona kolejka jeden producent – jeden konsument, bez blokad.
+// Lista jednokierunkowa z węzłem-wartownikiem: producent dopina węzeł za
+// ogonem (jeden zapis release), konsument przesuwa głowę i zwalnia stary
+// wartownik. Producent i konsument nie dotykają tych samych pól poza
+// wskaźnikiem next ostatniego węzła.
+template <typename T>
+class SpscQueue {
+public:
+    SpscQueue() : m_head(new Node), m_tail(m_head) {}
+    ~SpscQueue() {
+        while (Node* n = m_head) {
+            m_head = n->next.load(std::memory_order_relaxed);
+            delete n;
+        }
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Tylko wątek producenta
+    void push(T value) {
+        Node* n = new Node;
+        n->value = std::move(value);
+        m_tail->next.store(n, std::memory_order_release);
+        m_tail = n;
+    }
+
+    // Tylko wątek konsumenta; false = pusto
+    bool pop(T& out) {
+        Node* next = m_head->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        out = std::move(next->value);
+        delete m_head;
+        m_head = next;               // next staje się wartownikiem
+        return true;
+    }
+
+    // Tylko wątek konsumenta
+    bool isEmpty() const { return m_head->next.load(std::memory_order_acquire) == nullptr; }
+
+private:
+    struct Node {
+        T                  value{};
+        std::atomic<Node*> next{nullptr};
+    };
+
+    alignas(64) Node* m_head;        // konsument
+    alignas(64) Node* m_tail;        // producent
+};
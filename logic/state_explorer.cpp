@@ -0,0 +1,689 @@
+#include "state_explorer.h"
+#include "conduction_graph.h"
+#include "net_index.h"
+#include "parallel_for.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QThread>
+#include <QThreadPool>
+#include <QVarLengthArray>
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Własna pula: porcje frontu nie czekają za zadaniami BFS ani wczytywaniem
+QThreadPool& explorerPool() {
+    static QThreadPool pool;
+    return pool;
+}
+
+quint64 lowBits(int n) { return n >= 64 ? ~quint64(0) : (quint64(1) << n) - 1; }
+
+// ===================== Niezmienniki =====================
+struct Token {
+    enum class Kind : quint8 { Name, Not, And, Or };
+    Kind    kind = Kind::Name;
+    QString name;
+    int     contactor = -1;     // bit stycznika albo
+    quint64 inputs = 0;         // bity przycisków pinu (faza, zero) — po redukcji
+};
+using Program = QVector<Token>;     // odwrotna notacja polska
+
+// Zejście rekurencyjne: or := and {or and}, and := unary {and unary}, unary := not unary | ( or ) | nazwa
+class Parser {
+public:
+    explicit Parser(const QString& text) {
+        for (int i = 0; i < text.size();) {
+            const QChar ch = text[i];
+            if (ch.isSpace()) { ++i; continue; }
+            if (ch.isLetterOrNumber() || ch == QLatin1Char('_')) {
+                int j = i;
+                while (j < text.size() && (text[j].isLetterOrNumber() || text[j] == QLatin1Char('_'))) ++j;
+                m_tok << text.mid(i, j - i);
+                i = j;
+            } else if ((ch == QLatin1Char('&') || ch == QLatin1Char('|')) && i + 1 < text.size() && text[i + 1] == ch) {
+                m_tok << text.mid(i, 2);
+                i += 2;
+            } else {
+                m_tok << QString(ch);
+                ++i;
+            }
+        }
+    }
+
+    bool parse(Program& out, QString& error) {
+        if (orExpr(out) && m_pos < m_tok.size())
+            m_error = QObject::tr("nadmiarowe „%1”").arg(m_tok[m_pos]);
+        error = m_error;
+        return m_error.isEmpty();
+    }
+
+private:
+    bool is(const char* word, const char* symbol) const {
+        if (m_pos >= m_tok.size()) return false;
+        const QString& t = m_tok[m_pos];
+        return t.compare(QLatin1String(word), Qt::CaseInsensitive) == 0 || t == QLatin1String(symbol);
+    }
+
+    bool orExpr(Program& out) {
+        if (!andExpr(out)) return false;
+        while (is("or", "||")) {
+            ++m_pos;
+            if (!andExpr(out)) return false;
+            out.push_back({ Token::Kind::Or, {} });
+        }
+        return true;
+    }
+
+    bool andExpr(Program& out) {
+        if (!unary(out)) return false;
+        while (is("and", "&&")) {
+            ++m_pos;
+            if (!unary(out)) return false;
+            out.push_back({ Token::Kind::And, {} });
+        }
+        return true;
+    }
+
+    bool unary(Program& out) {
+        if (m_pos >= m_tok.size()) {
+            m_error = QObject::tr("niepełne wyrażenie");
+            return false;
+        }
+        if (is("not", "!")) {
+            ++m_pos;
+            if (!unary(out)) return false;
+            out.push_back({ Token::Kind::Not, {} });
+            return true;
+        }
+        const QString& t = m_tok[m_pos];
+        if (t == QLatin1String("(")) {
+            ++m_pos;
+            if (!orExpr(out)) return false;
+            if (m_pos >= m_tok.size() || m_tok[m_pos] != QLatin1String(")")) {
+                m_error = QObject::tr("brak „)”");
+                return false;
+            }
+            ++m_pos;
+            return true;
+        }
+        if ((!t[0].isLetterOrNumber() && t[0] != QLatin1Char('_')) || is("and", "&&") || is("or", "||")) {
+            m_error = QObject::tr("nieoczekiwane „%1”").arg(t);
+            return false;
+        }
+        out.push_back({ Token::Kind::Name, t });
+        ++m_pos;
+        return true;
+    }
+
+    QStringList m_tok;
+    int         m_pos = 0;
+    QString     m_error;
+};
+
+bool holds(const Program& p, quint64 in, quint64 k) {
+    QVarLengthArray<bool, 32> stack;
+    for (const Token& t : p) {
+        switch (t.kind) {
+        case Token::Kind::Name:
+            stack.append(t.contactor >= 0 ? (k >> t.contactor) & 1 : (in & t.inputs) != 0);
+            break;
+        case Token::Kind::Not:
+            stack.last() = !stack.last();
+            break;
+        case Token::Kind::And: {
+            const bool b = stack.last();
+            stack.removeLast();
+            stack.last() = stack.last() && b;
+            break;
+        }
+        case Token::Kind::Or: {
+            const bool b = stack.last();
+            stack.removeLast();
+            stack.last() = stack.last() || b;
+            break;
+        }
+        }
+    }
+    return stack.last();
+}
+
+// ===================== Model zredukowany =====================
+struct Link {
+    QString a, b;
+    int     bit = -1;           // stycznik styku; -1 = przewodzi zawsze
+    bool    isNO = true;
+};
+
+// Przyciski jednej grupy zajmują kolejne bity [first, first + count)
+struct Group {
+    int first = 0;
+    int count = 0;
+};
+
+struct Plan {
+    QVector<Link>    links;
+    QStringList      inputPin;          // bit -> pin
+    QVector<bool>    inputNeutral;
+    QVector<Group>   groups;
+    QStringList      contactor;         // bit -> prefiks
+    QStringList      coilA, coilB;      // puste = bez cewki
+    QStringList      phase, neutral;    // piny szyn na krawędziach stożka (źródła stałe)
+    QVector<Program> programs;
+    QStringList      texts;             // treść niezmiennika do raportu
+};
+
+// Postać kanoniczna: w każdej grupie wciśnięte są najniższe bity
+quint64 canonical(const Plan& plan, quint64 in) {
+    for (const Group& g : plan.groups) {
+        if (g.count < 2) continue;
+        const quint64 mask = lowBits(g.count) << g.first;
+        const int on = qPopulationCount(in & mask);
+        in = (in & ~mask) | (lowBits(on) << g.first);
+    }
+    return in;
+}
+
+// Graf i stan styków jednej porcji frontu; warunki krawędzi czytają tylko m_k
+class Evaluator {
+public:
+    enum class Settle : quint8 { Stable, Violated, Unstable };
+
+    explicit Evaluator(const Plan& plan) : m_plan(plan) {
+        QVector<Edge> edges;
+        edges.reserve(plan.links.size());
+        for (const Link& l : plan.links) {
+            Edge e{ l.a, l.b, {}, {} };
+            if (l.bit >= 0) {
+                const int bit = l.bit;
+                const bool isNO = l.isNO;
+                e.conducts = [this, bit, isNO]() -> bool {
+                    const bool en = (m_k >> bit) & 1;
+                    return isNO ? en : !en;
+                };
+            }
+            edges.push_back(std::move(e));
+        }
+        m_graph.build(edges);
+        for (const QString& p : plan.phase)   m_phaseFixed << m_graph.node(p);
+        for (const QString& p : plan.neutral) m_neutralFixed << m_graph.node(p);
+        for (const QString& p : plan.inputPin) m_inputNode << m_graph.node(p);
+        for (int c = 0; c < plan.contactor.size(); ++c) {
+            m_coilA << (plan.coilA[c].isEmpty() ? -1 : m_graph.node(plan.coilA[c]));
+            m_coilB << (plan.coilB[c].isEmpty() ? -1 : m_graph.node(plan.coilB[c]));
+        }
+    }
+    Evaluator(const Evaluator&) = delete;
+    Evaluator& operator=(const Evaluator&) = delete;
+
+    // Stan (in, k) zaraz po przełączeniu → ustalony k; niezmienniki przed pierwszą i po każdej iteracji
+    Settle settle(quint64 in, quint64& k, int& iteration, int& program) {
+        for (iteration = 0;; ++iteration) {
+            for (program = 0; program < m_plan.programs.size(); ++program)
+                if (!holds(m_plan.programs[program], in, k)) return Settle::Violated;
+            if (iteration == SimWorker::MAX_ITERATIONS) break;
+
+            m_k = k;
+            m_graph.refresh();
+            reach(in, false, m_phase);
+            reach(in, true, m_neutral);
+            quint64 next = 0;
+            for (int c = 0; c < m_coilA.size(); ++c)
+                if (m_coilA[c] >= 0 && m_coilB[c] >= 0
+                    && ConductionGraph::test(m_phase, m_coilA[c]) && ConductionGraph::test(m_neutral, m_coilB[c]))
+                    next |= quint64(1) << c;
+            if (next == k) return Settle::Stable;
+            k = next;
+        }
+        program = -1;
+        return Settle::Unstable;
+    }
+
+private:
+    void reach(quint64 in, bool neutral, ConductionGraph::Bits& out) {
+        m_src = neutral ? m_neutralFixed : m_phaseFixed;
+        for (quint64 bits = in; bits; bits &= bits - 1) {
+            const int b = qCountTrailingZeroBits(bits);
+            if (m_plan.inputNeutral[b] == neutral) m_src << m_inputNode[b];
+        }
+        m_graph.reach(m_src, out);
+    }
+
+    const Plan&           m_plan;
+    ConductionGraph       m_graph;
+    quint64               m_k = 0;
+    QVector<int>          m_phaseFixed, m_neutralFixed, m_inputNode, m_coilA, m_coilB, m_src;
+    ConductionGraph::Bits m_phase, m_neutral;
+};
+
+// Sieć pinu; pin bez połączeń dostaje własny numer ujemny (od -2)
+int component(const NetIndex& nets, QHash<QString, int>& lone, const QString& pin) {
+    const int n = nets.net(pin);
+    if (n >= 0) return n;
+    const auto it = lone.constFind(pin);
+    if (it != lone.constEnd()) return it.value();
+    const int id = -2 - lone.size();
+    lone.insert(pin, id);
+    return id;
+}
+
+QStringList contactorNames(const Plan& plan, quint64 k) {
+    QStringList out;
+    for (quint64 bits = k; bits; bits &= bits - 1)
+        out << plan.contactor[qCountTrailingZeroBits(bits)].chopped(1);
+    return out;
+}
+
+// ===================== Stożki wpływu =====================
+// Szyny: sieci mostków stałych źródeł — zawsze gorące, więc droga do cewki może
+// zaczynać się od ostatniej szyny na trasie. Obszar rodzaju k (0 = faza, 1 = zero)
+// to spójna część schematu (mostki + wszystkie styki zwarte) po wycięciu szyn
+// rodzaju k. Cewka A1 zależy tylko od obszaru fazowego swojego pinu, A2 — od
+// obszaru zera; przez wspólne szyny L i N obwody się zatem nie sklejają.
+struct Topology {
+    explicit Topology(const StateExplorer::Model& model) {
+        for (const Edge& e : model.wires) bridged.addWire(e.a, e.b);
+        for (const QString& s : model.phase)   for (const QString& p : bridged.pins(s)) rail[0].insert(p);
+        for (const QString& s : model.neutral) for (const QString& p : bridged.pins(s)) rail[1].insert(p);
+
+        auto join = [&](const QString& a, const QString& b) {
+            for (int k = 0; k < 2; ++k)
+                if (!rail[k].contains(a) && !rail[k].contains(b)) regions[k].addWire(a, b);
+        };
+        for (const Edge& e : model.wires) join(e.a, e.b);
+        for (int d = 0; d < model.devices.size(); ++d) {
+            const SimWorker::Op& op = model.devices[d];
+            if (op.kind == SimWorker::Op::Kind::AddContactor) deviceOf.insert(op.prefix, d);
+            for (const SimWorker::Contact& c : op.contacts) join(c.a, c.b);
+        }
+        for (auto it = deviceOf.constBegin(); it != deviceOf.constEnd(); ++it)
+            for (const SimWorker::Contact& c : model.devices[it.value()].contacts)
+                for (int k = 0; k < 2; ++k) {
+                    const int r = region(k, c.a) != RAIL ? region(k, c.a) : region(k, c.b);
+                    if (r == RAIL) continue;              // oba końce na szynie
+                    QVector<int>& list = contactsIn[k][r];
+                    if (!list.contains(it.value())) list << it.value();
+                }
+        for (int i = 0; i < model.inputs.size(); ++i) inputOf[model.inputs[i].pin] << i;
+    }
+
+    static constexpr int RAIL = -1;     // pin na szynie rodzaju k
+    int region(int k, const QString& pin) {
+        return rail[k].contains(pin) ? -1 : component(regions[k], lone[k], pin);
+    }
+    int bridgedNet(const QString& pin) { return component(bridged, loneBridged, pin); }
+
+    NetIndex                 bridged;
+    QHash<QString, int>      loneBridged;
+    QSet<QString>            rail[2];
+    NetIndex                 regions[2];
+    QHash<QString, int>      lone[2];
+    QHash<int, QVector<int>> contactsIn[2];  // obszar -> styczniki ze stykami w nim
+    QHash<QString, int>      deviceOf;       // prefiks stycznika -> indeks w model.devices
+    QHash<QString, QVector<int>> inputOf;    // pin przycisku -> indeksy w model.inputs
+};
+
+// Niezmienniki, których stożki dzielą obszar, stycznik albo przycisk, sprawdzane
+// są razem; rozłączne — osobno, bez przeplatania ich przycisków
+struct Cone {
+    QVector<int> programs;
+    QSet<int>    regions[2];
+    QSet<int>    devices;     // indeksy w model.devices
+    QSet<int>    named;       // przyciski z niezmienników
+
+    bool overlaps(const Cone& o) const {
+        return regions[0].intersects(o.regions[0]) || regions[1].intersects(o.regions[1])
+            || devices.intersects(o.devices) || named.intersects(o.named);
+    }
+    void merge(const Cone& o) {     // suma domkniętych stożków jest domknięta
+        programs += o.programs;
+        for (int k = 0; k < 2; ++k) regions[k] += o.regions[k];
+        devices += o.devices;
+        named += o.named;
+    }
+};
+
+// Domknięcie: obszary cewek styczników stożka, a w nich styki kolejnych styczników
+void grow(Topology& t, const StateExplorer::Model& model, Cone& cone, QVector<int> work) {
+    for (int d : work) cone.devices.insert(d);
+    auto addRegion = [&](int k, const QString& pin) {
+        const int r = t.region(k, pin);
+        if (r == Topology::RAIL || cone.regions[k].contains(r)) return;
+        cone.regions[k].insert(r);
+        for (int d : t.contactsIn[k].value(r))
+            if (!cone.devices.contains(d)) { cone.devices.insert(d); work << d; }
+    };
+    while (!work.isEmpty()) {
+        const SimWorker::Op& op = model.devices[work.takeLast()];
+        if (op.a.isEmpty() || op.b.isEmpty()) continue;
+        addRegion(0, op.a);
+        addRegion(1, op.b);
+    }
+}
+
+// Stożek → bity przycisków (grupami zamiennych) i styczników, krawędzie, programy z numerami bitów
+bool buildPlan(const StateExplorer::Model& model, Topology& t, const Cone& cone,
+               const QVector<Program>& programs, const QStringList& texts, Plan& plan, QString& error) {
+    QVector<int> devices(cone.devices.cbegin(), cone.devices.cend());
+    std::sort(devices.begin(), devices.end());
+    if (devices.size() > StateExplorer::MAX_CONTACTORS) {
+        error = QObject::tr("Za dużo styczników w zasięgu niezmienników (%1, najwyżej %2)")
+                    .arg(devices.size()).arg(StateExplorer::MAX_CONTACTORS);
+        return false;
+    }
+    QHash<int, int> bitOf;
+    for (int d : devices) {
+        const SimWorker::Op& op = model.devices[d];
+        bitOf.insert(d, plan.contactor.size());
+        plan.contactor << op.prefix;
+        plan.coilA << op.a;
+        plan.coilB << op.b;
+    }
+    auto inCone = [&](int k, const QString& pin) {
+        const int r = t.region(k, pin);
+        return r != Topology::RAIL && cone.regions[k].contains(r);
+    };
+
+    // Zamienne: ta sama sieć mostków i biegunowość; przyciski z niezmienników osobno
+    QHash<QPair<int, bool>, int> groupOf;
+    QVector<QVector<int>> members;
+    for (int i = 0; i < model.inputs.size(); ++i) {
+        const StateExplorer::Input& in = model.inputs[i];
+        if (cone.named.contains(i)) {
+            members.push_back({ i });
+            continue;
+        }
+        if (!inCone(in.neutral ? 1 : 0, in.pin)) continue;
+        const QPair<int, bool> key(t.bridgedNet(in.pin), in.neutral);
+        const auto it = groupOf.constFind(key);
+        if (it != groupOf.constEnd()) {
+            members[it.value()] << i;
+        } else {
+            groupOf.insert(key, members.size());
+            members.push_back({ i });
+        }
+    }
+    QHash<int, int> inputBit;
+    for (const QVector<int>& m : members) {
+        plan.groups.push_back({ int(plan.inputPin.size()), int(m.size()) });
+        for (int i : m) {
+            inputBit.insert(i, plan.inputPin.size());
+            plan.inputPin << model.inputs[i].pin;
+            plan.inputNeutral << model.inputs[i].neutral;
+        }
+    }
+    if (plan.inputPin.size() > StateExplorer::MAX_INPUTS) {
+        error = QObject::tr("Za dużo przycisków w zasięgu niezmienników (%1, najwyżej %2)")
+                    .arg(plan.inputPin.size()).arg(StateExplorer::MAX_INPUTS);
+        return false;
+    }
+
+    for (int p : cone.programs) {
+        Program prog = programs[p];
+        for (Token& tok : prog) {
+            if (tok.kind != Token::Kind::Name) continue;
+            const auto d = t.deviceOf.constFind(tok.name);
+            if (d != t.deviceOf.constEnd()) {
+                tok.contactor = bitOf.value(d.value());
+                continue;
+            }
+            for (int i : t.inputOf.value(tok.name)) tok.inputs |= quint64(1) << inputBit.value(i);
+        }
+        plan.programs << prog;
+        plan.texts << texts[p];
+    }
+
+    // Krawędzie obszarów stożka; piny szyn na ich końcach są źródłami stałymi
+    QSet<QString> src[2];
+    auto touch = [&](const QString& pin) {
+        for (int k = 0; k < 2; ++k)
+            if (t.rail[k].contains(pin)) src[k].insert(pin);
+    };
+    auto add = [&](const QString& a, const QString& b, int bit, bool isNO) {
+        if (!inCone(0, a) && !inCone(0, b) && !inCone(1, a) && !inCone(1, b)) return;
+        plan.links.push_back({ a, b, bit, isNO });
+        touch(a);
+        touch(b);
+    };
+    for (const Edge& e : model.wires) add(e.a, e.b, -1, true);
+    for (int d = 0; d < model.devices.size(); ++d) {
+        const SimWorker::Op& op = model.devices[d];
+        const bool motor = op.kind == SimWorker::Op::Kind::AddMotor;
+        if (!motor && !bitOf.contains(d)) continue;      // styki spoza stożka leżą poza jego obszarami
+        const int bit = motor ? -1 : bitOf.value(d);
+        for (const SimWorker::Contact& c : op.contacts) {
+            add(c.a, c.b, bit, c.isNO);
+            add(c.b, c.a, bit, c.isNO);
+        }
+    }
+    for (int c = 0; c < plan.contactor.size(); ++c) {
+        touch(plan.coilA[c]);
+        touch(plan.coilB[c]);
+    }
+    for (const QString& p : plan.inputPin) touch(p);
+    plan.phase   = QStringList(src[0].cbegin(), src[0].cend());
+    plan.neutral = QStringList(src[1].cbegin(), src[1].cend());
+
+    // Pętle własne: każdy pin cewki, przycisku i źródła ma węzeł w grafie
+    for (const QStringList* pins : { &plan.phase, &plan.neutral, &plan.coilA, &plan.coilB, &plan.inputPin })
+        for (const QString& p : *pins)
+            if (!p.isEmpty()) plan.links.push_back({ p, p });
+    return true;
+}
+
+// ===================== Przeszukiwanie wszerz =====================
+// Jeden stożek; liczniki i ewentualny kontrprzykład dopisywane do r
+void search(const Plan& plan, const CancelToken& cancel, StateExplorer::Result& r) {
+    struct Node {
+        quint64 in = 0, k = 0;
+        int     parent = -1;
+        int     move = -1;          // grupa * 2 + wciśnięcie
+    };
+    struct Found {
+        int     parent = -1, move = -1;
+        quint64 k = 0;
+        int     iteration = 0, program = -1;
+    };
+    struct Out {
+        QVector<Node> next;
+        Found         found;
+    };
+
+    QVector<Node> nodes;
+    QHash<QPair<quint64, quint64>, int> seen;
+    auto violation = [&](int program) {
+        return program >= 0 ? plan.texts[program]
+                            : QObject::tr("stabilność (styczniki nie ustalają się w %1 iteracjach)")
+                                  .arg(SimWorker::MAX_ITERATIONS);
+    };
+    auto finish = [&](bool complete) {
+        r.states += nodes.size();
+        r.complete = r.complete && complete;
+    };
+
+    // Porcja frontu = własny graf (warunki styków czytają stan porcji)
+    const int parts = std::max(1, QThread::idealThreadCount());
+    std::vector<std::unique_ptr<Evaluator>> eval;
+    for (int c = 0; c < parts; ++c) eval.push_back(std::make_unique<Evaluator>(plan));
+
+    // Spoczynek: przyciski zwolnione, cewki bez zasilania — i to, co z tego wynika
+    {
+        Node root;
+        int iteration, program;
+        if (eval[0]->settle(0, root.k, iteration, program) != Evaluator::Settle::Stable) {
+            r.violated = violation(program);
+            r.iteration = iteration;
+            finish(false);
+            return;
+        }
+        nodes << root;
+        seen.insert(qMakePair(root.in, root.k), 0);
+    }
+
+    QVector<Out> out(parts);
+    Out* outs = out.data();             // porcje piszą tylko do swojego elementu
+    QVector<int> frontier{ 0 };
+    Found found;
+    int depth = 0;
+    while (!frontier.isEmpty()) {
+        if (cancel.isCancelled() || nodes.size() >= StateExplorer::MAX_STATES) {
+            finish(false);
+            return;
+        }
+
+        parallelFor(explorerPool(), frontier.size(), parts, StateExplorer::GRAIN, [&](int c, int b, int e) {
+            Evaluator& ev = *eval[c];
+            Out& o = outs[c];
+            for (int i = b; i < e; ++i) {
+                if ((i & 63) == 63 && cancel.isCancelled()) return;
+                const Node& n = nodes.at(frontier.at(i));
+                for (int g = 0; g < plan.groups.size(); ++g) {
+                    const Group& gr = plan.groups.at(g);
+                    const int pressed = qPopulationCount(n.in & (lowBits(gr.count) << gr.first));
+                    for (int on = 0; on < 2; ++on) {
+                        if (on ? pressed == gr.count : pressed == 0) continue;
+                        const quint64 in = n.in ^ (quint64(1) << (gr.first + (on ? pressed : pressed - 1)));
+                        quint64 k = n.k;
+                        int iteration, program;
+                        if (ev.settle(in, k, iteration, program) != Evaluator::Settle::Stable) {
+                            o.found = { frontier.at(i), g * 2 + on, k, iteration, program };
+                            return;
+                        }
+                        o.next.push_back({ canonical(plan, in), k, frontier.at(i), g * 2 + on });
+                    }
+                }
+            }
+        });
+        if (cancel.isCancelled()) {
+            finish(false);
+            return;
+        }
+        r.depth = std::max(r.depth, ++depth);
+
+        // Porcje leżą na froncie po kolei: pierwsze naruszenie = najmniejszy numer stanu
+        for (const Out& o : out)
+            if (o.found.parent >= 0) { found = o.found; break; }
+        if (found.parent >= 0) break;
+
+        QVector<int> next;
+        for (Out& o : out) {
+            for (const Node& n : o.next) {
+                if (nodes.size() >= StateExplorer::MAX_STATES) break;
+                const auto key = qMakePair(n.in, n.k);
+                if (seen.contains(key)) continue;
+                seen.insert(key, nodes.size());
+                next << nodes.size();
+                nodes << n;
+            }
+            o = Out();
+        }
+        frontier = std::move(next);
+    }
+    if (found.parent < 0) {
+        finish(true);
+        return;
+    }
+
+    // Kontrprzykład: ruchy od korzenia, przyciski konkretne (w grupie — pierwszy pasujący)
+    QVector<int> path;
+    for (int v = found.parent; v > 0; v = nodes[v].parent) path.prepend(v);
+    quint64 pressed = 0;
+    auto step = [&](int move, quint64 k) {
+        const Group& gr = plan.groups[move / 2];
+        const bool on = move & 1;
+        int bit = gr.first;
+        while (bool((pressed >> bit) & 1) == on) ++bit;
+        pressed ^= quint64(1) << bit;
+        r.trace.push_back({ plan.inputPin[bit], plan.inputNeutral[bit], on, contactorNames(plan, k) });
+    };
+    for (int v : path) step(nodes[v].move, nodes[v].k);
+    step(found.move, found.k);
+    r.violated = violation(found.program);
+    r.iteration = found.iteration;
+    finish(false);
+}
+
+} // namespace
+
+// ===================== StateExplorer =====================
+StateExplorer::Result StateExplorer::explore(const Model& model, const QStringList& invariants,
+                                             const CancelToken& cancel) {
+    QElapsedTimer timer;
+    timer.start();
+    Result r;
+
+    QVector<Program> programs;
+    QStringList texts;
+    for (const QString& text : invariants) {
+        if (text.trimmed().isEmpty()) continue;
+        Program p;
+        QString error;
+        if (!Parser(text).parse(p, error)) {
+            r.error = QObject::tr("Niezmiennik „%1”: %2").arg(text.trimmed(), error);
+            return r;
+        }
+        programs << p;
+        texts << text.trimmed();
+    }
+    if (programs.isEmpty()) {
+        r.error = QObject::tr("Brak niezmienników do sprawdzenia");
+        return r;
+    }
+
+    // Nazwy → styczniki (prefiks) albo przyciski; stożek każdego niezmiennika
+    Topology t(model);
+    QVector<Cone> cones;
+    for (int p = 0; p < programs.size(); ++p) {
+        Cone cone;
+        cone.programs << p;
+        QVector<int> work;
+        for (Token& tok : programs[p]) {
+            if (tok.kind != Token::Kind::Name) continue;
+            const QString prefix = tok.name.endsWith(QLatin1Char('_')) ? tok.name : tok.name + QLatin1Char('_');
+            if (t.deviceOf.contains(prefix)) {
+                tok.name = prefix;
+                work << t.deviceOf.value(prefix);
+            } else if (t.inputOf.contains(tok.name)) {
+                for (int i : t.inputOf.value(tok.name)) cone.named.insert(i);
+            } else {
+                r.error = QObject::tr("Niezmiennik „%1”: nieznana nazwa „%2” (stycznik albo pin przycisku)")
+                              .arg(texts[p], tok.name);
+                return r;
+            }
+        }
+        grow(t, model, cone, work);
+        for (int c = cones.size() - 1; c >= 0; --c) {
+            if (!cones[c].overlaps(cone)) continue;
+            cone.merge(cones[c]);
+            cones.remove(c);
+        }
+        std::sort(cone.programs.begin(), cone.programs.end());
+        cones << cone;
+    }
+    std::sort(cones.begin(), cones.end(),
+              [](const Cone& a, const Cone& b) { return a.programs.first() < b.programs.first(); });
+
+    r.complete = true;
+    for (const Cone& cone : cones) {
+        Plan plan;
+        if (!buildPlan(model, t, cone, programs, texts, plan, r.error)) {
+            r.complete = false;
+            break;
+        }
+        r.inputs = std::max(r.inputs, int(plan.inputPin.size()));
+        r.contactors = std::max(r.contactors, int(plan.contactor.size()));
+        for (const Group& g : plan.groups)
+            if (g.count > 1) ++r.symmetricGroups;
+        ++r.cones;
+        search(plan, cancel, r);
+        if (!r.violated.isEmpty() || cancel.isCancelled()) break;
+    }
+    r.ms = timer.nsecsElapsed() / 1e6;
+    return r;
+}
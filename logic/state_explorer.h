@@ -0,0 +1,75 @@
+#pragma once
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "propagation.h"
+#include "sim_worker.h"
+
+// Jawne przeszukiwanie stanów osiągalnych: czy jakakolwiek sekwencja przycisków
+// doprowadzi do stanu, w którym niezmiennik (np. „not (K1 and K2)” dla rozruchu
+// nawrotnego) jest fałszywy.
+//
+// Stan = przyciski (źródła przełączane) + zasilone cewki. Ruch = przełączenie
+// jednego przycisku, po nim ta sama iteracja co w SimWorker: propagacja →
+// cewki → aż do stabilizacji. Niezmienniki sprawdzane są po każdej iteracji,
+// więc także w stanach przejściowych; brak stabilizacji po MAX_ITERATIONS
+// (w badanym stożku) to naruszenie wbudowanego warunku stabilności.
+// Przeszukiwanie wszerz: pierwszy znaleziony kontrprzykład jest najkrótszy.
+// Przekaźniki F silników są tu zawsze zwarte.
+//
+// Redukcje:
+//  - stożek wpływu — cewka zależy tylko od obwodu między swoim pinem a
+//    najbliższą szyną stałego źródła; do stożka należą obwody cewek styczników
+//    z niezmienników i, wstecz, styczniki, których styki w nich leżą. Przycisków
+//    i styczników spoza stożka nie przeplata się wcale, a niezmienniki
+//    o rozłącznych stożkach (np. dwa rozruchy nawrotne na wspólnych szynach)
+//    bada się osobno: suma przestrzeni zamiast iloczynu,
+//  - symetria — przyciski tej samej biegunowości w jednej sieci mostków są
+//    zamienne (liczy się tylko, ile z nich jest wciśniętych), a stan zapisuje się
+//    w postaci kanonicznej,
+//  - odwiedzone stany w tablicy mieszającej.
+// Front każdego poziomu rozwija pula wątków; każda porcja ma własny graf.
+//
+// Niezmienniki: nazwy styczników (K1 lub K1_) i pinów przycisków (prawda =
+// zasilony / wciśnięty), not/and/or, !/&&/||, nawiasy.
+class StateExplorer {
+public:
+    static constexpr int MAX_INPUTS     = 64;        // po redukcji: bity stanu
+    static constexpr int MAX_CONTACTORS = 64;
+    static constexpr int MAX_STATES     = 1 << 20;   // bezpiecznik pamięci
+    static constexpr int GRAIN          = 16;        // min. stanów frontu na zadanie
+
+    struct Input {
+        QString pin;
+        bool    neutral = false;
+    };
+    struct Model {
+        QVector<SimWorker::Op> devices;            // AddContactor / AddMotor (styk F zawsze zwarty)
+        QVector<Edge>          wires;              // mostki (bez warunku)
+        QVector<Input>         inputs;             // przyciski (wszystkie — w spoczynku puszczone)
+        QSet<QString>          phase, neutral;     // źródła stale załączone
+    };
+    struct Step {
+        QString     pin;                           // przełączony przycisk
+        bool        neutral = false;
+        bool        on = false;
+        QStringList energized;                     // styczniki po ustaleniu (ostatni krok: w chwili naruszenia)
+    };
+    struct Result {
+        QString       error;                       // składnia niezmiennika albo model za duży
+        QString       violated;                    // pusty = brak naruszeń w zbadanych stanach
+        QVector<Step> trace;                       // kontrprzykład od spoczynku (wszystko wyłączone)
+        int           iteration = 0;               // iteracja ustalania przy naruszeniu (0 = zaraz po przełączeniu)
+        bool          complete = false;            // zbadana cała przestrzeń osiągalna
+        int           states = 0;
+        int           depth = 0;
+        int           cones = 0;                   // niezależnie badane stożki wpływu
+        int           inputs = 0, contactors = 0;  // największy stożek
+        int           symmetricGroups = 0;         // grupy zamiennych przycisków (> 1 przycisk)
+        double        ms = 0.0;
+    };
+
+    static Result explore(const Model& model, const QStringList& invariants, const CancelToken& cancel = {});
+};
@@ -0,0 +1,123 @@
+#include "thermal_bank.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr float CLASS_TEST_CURRENT = 7.2f;   // ×Ir: punkt definicji klasy wyzwalania (IEC 60947-4-1)
+}
+
+int MotorThermalBank::add(const QString& prefix) {
+    if (m_byPrefix.contains(prefix)) return NONE;
+
+    int i;
+    if (!m_free.isEmpty()) {
+        i = m_free.takeLast();
+    } else {
+        i = m_used.size();
+        m_theta.push_back(0);     m_load.push_back(0);      m_supplyMult.push_back(0);
+        m_startLeft.push_back(0); m_alphaHeat.push_back(0); m_alphaCool.push_back(0);
+        m_fresh.push_back(0);     m_tripped.push_back(0);   m_used.push_back(0);
+        m_supply.push_back(0);    m_class.push_back(0);
+        m_prefix.push_back({});
+    }
+
+    m_theta[i] = m_supplyMult[i] = m_startLeft[i] = 0.0f;
+    m_load[i]    = 1.0f;
+    m_fresh[i]   = m_tripped[i] = m_supply[i] = 0;
+    m_used[i]    = 1;
+    m_prefix[i]  = prefix;
+    setTripClass(i, DEFAULT_CLASS);
+    m_byPrefix.insert(prefix, i);
+    return i;
+}
+
+bool MotorThermalBank::remove(const QString& prefix) {
+    const auto it = m_byPrefix.find(prefix);
+    if (it == m_byPrefix.end()) return false;
+    const int i = it.value();
+    m_byPrefix.erase(it);
+
+    m_prefix[i].clear();
+    m_theta[i] = m_supplyMult[i] = m_startLeft[i] = 0.0f;
+    m_fresh[i] = m_tripped[i] = m_supply[i] = m_used[i] = 0;
+    m_free.push_back(i);
+    return true;
+}
+
+void MotorThermalBank::clear() {
+    *this = MotorThermalBank();
+}
+
+void MotorThermalBank::setSupply(int id, int phases) {
+    if (m_supply[id] < 2 && phases >= 2) m_startLeft[id] = START_S;
+    if (phases < 2)                      m_startLeft[id] = 0.0f;
+    m_supply[id]     = quint8(phases);
+    m_supplyMult[id] = phases >= 3 ? 1.0f : phases == 2 ? SINGLE_PHASE_MULT : 0.0f;
+}
+
+// Klasa N: z zimnego stanu 7,2·Ir wyzwala po N s  =>  τ = N / −ln(1 − 1/θ_ust(7,2·Ir))
+void MotorThermalBank::setTripClass(int id, int tripClass) {
+    tripClass = std::clamp(tripClass, 5, 30);
+    const double ss  = std::pow(double(CLASS_TEST_CURRENT / TRIP_CURRENT), 2.0);
+    const double tau = tripClass / -std::log(1.0 - 1.0 / ss);
+    m_class[id]     = tripClass;
+    m_alphaHeat[id] = float(1.0 - std::exp(-STEP_S / tau));
+    m_alphaCool[id] = float(1.0 - std::exp(-STEP_S / (tau * COOLING_RATIO)));
+}
+
+bool MotorThermalBank::reset(int id) {
+    if (!m_tripped[id]) return true;
+    if (m_theta[id] > RESET_LEVEL) return false;
+    m_tripped[id] = 0;
+    return true;
+}
+
+// Jeden krok dla wszystkich silników: płaskie tablice, wybory zamiast gałęzi
+void MotorThermalBank::step() {
+    constexpr float INV_TRIP2 = 1.0f / (TRIP_CURRENT * TRIP_CURRENT);
+    const int n = m_used.size();
+    float*        theta = m_theta.data();
+    float*        start = m_startLeft.data();
+    quint8*       trip  = m_tripped.data();
+    quint8*       fresh = m_fresh.data();
+    const float*  load  = m_load.constData();
+    const float*  mult  = m_supplyMult.constData();
+    const float*  aHeat = m_alphaHeat.constData();
+    const float*  aCool = m_alphaCool.constData();
+    const quint8* used  = m_used.constData();
+
+    int fired = 0;
+    for (int i = 0; i < n; ++i) {
+        const float cur = (start[i] > 0.0f ? START_MULT : load[i]) * mult[i];
+        const float a   = mult[i] > 0.0f ? aHeat[i] : aCool[i];
+        theta[i] += (cur * cur * INV_TRIP2 - theta[i]) * a;
+        start[i]  = std::max(start[i] - STEP_S, 0.0f);
+        const quint8 over = quint8((theta[i] >= 1.0f) & used[i]);
+        fresh[i] = quint8(over & ~trip[i]);
+        trip[i] |= over;
+        fired   |= fresh[i];
+    }
+
+    if (!fired) return;
+    for (int i = 0; i < n; ++i)
+        if (fresh[i]) m_newTrips.push_back(i);
+}
+
+double MotorThermalBank::advance(double dt) {
+    m_newTrips.clear();
+    const double carried = m_carry;
+    const double total = carried + dt;
+    if (m_byPrefix.isEmpty()) { m_carry = 0.0; return dt; }
+
+    double done = 0.0;
+    while (total - done >= STEP_S) {
+        step();
+        done += STEP_S;
+        if (!m_newTrips.isEmpty()) {
+            m_carry = 0.0;
+            return done - carried;
+        }
+    }
+    m_carry = total - done;
+    return dt;
+}
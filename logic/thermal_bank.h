@@ -0,0 +1,82 @@
+#pragma once
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// Model cieplny przekaźników przeciążeniowych (LR2) wszystkich silników
+// w tablicach równoległych indeksowanych numerem silnika.
+//
+// Nagrzewanie I²t jako obiekt pierwszego rzędu, θ znormalizowane tak, że
+// prąd 1,15·Ir w stanie ustalonym daje θ = 1 (próg zadziałania):
+//     θ_ust = (I / 1,15·Ir)²,   θ += (θ_ust − θ)·(1 − e^(−Δt/τ))
+// τ nagrzewania wynika z klasy wyzwalania (klasa N: 7,2·Ir od stanu zimnego
+// wyzwala po N s), stygnięcie na postoju jest COOLING_RATIO razy wolniejsze.
+// Rozruch to START_MULT·Ir przez START_S, praca na dwóch fazach
+// SINGLE_PHASE_MULT razy prąd obciążenia. Wyzwolenie otwiera styk NC 95-96.
+//
+// Krok całkowania jest stały (STEP_S), więc współczynniki e^(−Δt/τ) liczone są
+// raz przy zmianie nastaw; pętla kroku to same mnożenia i wybory na floatach
+// (wektoryzowalna), bez gałęzi per silnik.
+class MotorThermalBank {
+public:
+    static constexpr int   NONE = -1;
+    static constexpr float STEP_S            = 0.05f;
+    static constexpr float TRIP_CURRENT      = 1.15f;  // ×Ir: próg w stanie ustalonym
+    static constexpr float RESET_LEVEL       = 0.7f;   // θ, poniżej którego wolno skasować
+    static constexpr float START_MULT        = 6.0f;   // ×Ir podczas rozruchu
+    static constexpr float START_S           = 2.0f;
+    static constexpr float SINGLE_PHASE_MULT = 1.73f;  // praca na dwóch fazach
+    static constexpr float COOLING_RATIO     = 4.0f;
+    static constexpr int   DEFAULT_CLASS     = 10;
+
+    int  add(const QString& prefix);             // NONE, jeśli prefiks zajęty
+    bool remove(const QString& prefix);
+    void clear();
+
+    int  id(const QString& prefix) const { return m_byPrefix.value(prefix, NONE); }
+    bool contains(const QString& prefix) const { return m_byPrefix.contains(prefix); }
+    const QString& prefix(int id) const { return m_prefix[id]; }
+    bool isValid(int id) const { return m_used[id] != 0; }
+    int  size() const { return m_used.size(); }           // zakres numerów (z wolnymi)
+    int  count() const { return m_byPrefix.size(); }
+
+    // Liczba różnych faz na U/V/W (0–3) z ostatniego przeliczenia; 2→3 lub 0→2+ = rozruch
+    void setSupply(int id, int phases);
+
+    void  setLoad(int id, float load) { m_load[id] = qMax(0.0f, load); }   // prąd obciążenia / Ir
+    float load(int id) const { return m_load[id]; }
+    void  setTripClass(int id, int tripClass);
+    int   tripClass(int id) const { return m_class[id]; }
+
+    // Symulacja o dt s w krokach STEP_S; przerywa po kroku, w którym coś wyzwoliło
+    // (obwód sterowania musi być przeliczony). Zwraca czas faktycznie zasymulowany.
+    double advance(double dt);
+    const QVector<int>& tripped() const { return m_newTrips; }     // z ostatniego advance()
+
+    bool  isTripped(int id) const { return m_tripped[id] != 0; }
+    float heat(int id) const { return m_theta[id]; }               // 1.0 = próg
+    bool  reset(int id);                                           // false: jeszcze za gorący
+
+private:
+    void step();
+
+    // Tablice równoległe (indeks = numer silnika)
+    QVector<float>  m_theta;
+    QVector<float>  m_load;
+    QVector<float>  m_supplyMult;    // 1 (3 fazy), SINGLE_PHASE_MULT (2), 0 (postój)
+    QVector<float>  m_startLeft;     // s pozostałe z rozruchu
+    QVector<float>  m_alphaHeat;     // 1 − e^(−STEP_S/τ)
+    QVector<float>  m_alphaCool;
+    QVector<quint8> m_tripped;
+    QVector<quint8> m_fresh;         // wyzwolone w bieżącym kroku
+    QVector<quint8> m_used;
+    QVector<quint8> m_supply;
+    QVector<int>    m_class;
+
+    QVector<QString>    m_prefix;
+    QHash<QString, int> m_byPrefix;
+    QVector<int>        m_free;
+
+    QVector<int>        m_newTrips;
+    double              m_carry = 0.0;   // reszta czasu krótsza niż STEP_S
+};
@@ -0,0 +1,124 @@
+#include "trace_recorder.h"
+
+#include <QSaveFile>
+
+#include <utility>
+
+namespace {
+
+constexpr int FLUSH_BYTES = 1 << 16;
+
+// Identyfikator VCD: kolejne napisy z drukowalnych znaków ASCII '!'..'~'
+QByteArray vcdCode(int n) {
+    QByteArray code;
+    do {
+        code += char('!' + n % 94);
+        n /= 94;
+    } while (n > 0);
+    return code;
+}
+
+const char* signalSuffix(TraceRecorder::Signal s) {
+    switch (s) {
+    case TraceRecorder::Signal::Phase:     return "_phase";
+    case TraceRecorder::Signal::Neutral:   return "_neutral";
+    case TraceRecorder::Signal::Fault:     return "_fault";
+    case TraceRecorder::Signal::Energized: return "coil";     // nazwa stycznika kończy się „_”
+    }
+    return "";
+}
+
+} // namespace
+
+TraceRecorder::TraceRecorder(int capacityLog2)
+    : m_capacity(quint64(1) << qBound(10, capacityLog2, 28))
+    , m_mask(m_capacity - 1)
+{
+}
+
+void TraceRecorder::start() {
+    if (m_ring.size() != m_capacity) m_ring.assign(m_capacity, Event{});
+    m_head = 0;
+    m_clock.start();
+    m_on = true;
+}
+
+quint32 TraceRecorder::pinId(const QString& name) {
+    auto it = m_ids.constFind(name);
+    if (it != m_ids.constEnd()) return it.value();
+    const quint32 id = quint32(m_names.size());
+    m_ids.insert(name, id);
+    m_names << name;
+    return id;
+}
+
+QVector<TraceRecorder::Event> TraceRecorder::snapshot() const {
+    QVector<Event> out;
+    if (m_ring.empty()) return out;
+
+    const quint64 end = m_head;
+    const quint64 begin = end > m_capacity ? end - m_capacity : 0;
+    out.reserve(int(end - begin));
+    for (quint64 i = begin; i < end; ++i) out.push_back(m_ring[i & m_mask]);
+    return out;
+}
+
+bool TraceRecorder::writeVcd(const QString& path, const QVector<Event>& events, const QStringList& names,
+                             bool truncated, QString* error) {
+    // Zmienne tylko dla par (pin, sygnał), które wystąpiły — numer zmiennej = kod VCD;
+    // wartość początkowa = przeciwna do pierwszego zdarzenia (od startu nagrania to zawsze 0)
+    QHash<quint64, int> vars;
+    QVector<QPair<quint32, Signal>> order;
+    QByteArray initial;
+    for (const Event& e : events) {
+        const quint64 key = quint64(e.id) << 8 | quint8(e.signal);
+        if (vars.contains(key)) continue;
+        vars.insert(key, order.size());
+        order.push_back(qMakePair(e.id, e.signal));
+        initial += e.value ? '0' : '1';
+    }
+    QVector<QByteArray> codes;
+    codes.reserve(order.size());
+    for (int i = 0; i < order.size(); ++i) codes.push_back(vcdCode(i));
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    QByteArray buf;
+    bool ok = true;
+    auto spill = [&](bool force) {
+        if (!force && buf.size() < FLUSH_BYTES) return;
+        if (ok && f.write(buf) != buf.size()) ok = false;
+        buf.clear();
+    };
+
+    buf += "$comment ControlNet trace $end\n$timescale 1ns $end\n$scope module controlnet $end\n";
+    for (int i = 0; i < order.size(); ++i) {
+        buf += "$var wire 1 " + codes[i] + ' ' + names.value(int(order[i].first)).toUtf8()
+             + signalSuffix(order[i].second) + " $end\n";
+        spill(false);
+    }
+    const quint64 t0 = truncated && !events.isEmpty() ? events.first().t : 0;
+    buf += "$upscope $end\n$enddefinitions $end\n#" + QByteArray::number(t0) + "\n$dumpvars\n";
+    for (int i = 0; i < order.size(); ++i) { buf += initial.at(i) + codes[i] + '\n'; spill(false); }
+    buf += "$end\n";
+
+    quint64 lastT = t0;
+    for (const Event& e : events) {
+        if (e.t != lastT) {
+            buf += '#' + QByteArray::number(e.t) + '\n';
+            lastT = e.t;
+        }
+        buf += (e.value ? '1' : '0') + codes[vars.value(quint64(e.id) << 8 | quint8(e.signal))] + '\n';
+        spill(false);
+    }
+    spill(true);
+
+    if (!ok || !f.commit()) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <vector>
+
+// Rejestrator przebiegów symulacji: zmiany FAZA/ZERO/zwarcie na pinach
+// i energizacja cewek styczników, ze znacznikiem czasu.
+//
+// Zdarzenia (16 B, pin jako zwarty numer) lecą do bufora pierścieniowego
+// o stałej pojemności, alokowanego raz przy starcie nagrywania: zapis to
+// jeden wpis do tablicy i przesunięcie głowy — bez blokad i bez alokacji.
+// Po zapełnieniu najstarsze zdarzenia są nadpisywane.
+// Cały rejestrator należy do jednego wątku (GUI): record(), start() i snapshot()
+// idą z niego; inne wątki dostają tylko gotową migawkę (kopię).
+class TraceRecorder {
+public:
+    static constexpr int DEFAULT_CAPACITY_LOG2 = 20;    // 1M zdarzeń = 16 MB
+
+    enum class Signal : quint8 { Phase, Neutral, Fault, Energized };
+
+    struct Event {
+        quint64 t;          // ns od startu nagrywania
+        quint32 id;         // numer pinu / stycznika (pinId)
+        Signal  signal;
+        quint8  value;
+        quint16 reserved;
+    };
+    static_assert(sizeof(Event) == 16, "Event: 16 B");
+
+    explicit TraceRecorder(int capacityLog2 = DEFAULT_CAPACITY_LOG2);
+
+    void start();                       // czyści bufor, zeruje zegar
+    void stop()                         { m_on = false; }
+    bool isRecording() const            { return m_on; }
+
+    quint64 now() const                 { return quint64(m_clock.nsecsElapsed()); }
+    quint32 pinId(const QString& name); // internowanie (wątek GUI)
+    QString name(quint32 id) const      { return m_names.value(int(id)); }
+    QStringList names() const           { return m_names; }
+
+    inline void record(quint64 t, quint32 id, Signal s, bool value) {
+        if (!m_on) return;
+        m_ring[m_head & m_mask] = Event{ t, id, s, quint8(value), 0 };
+        ++m_head;
+    }
+
+    quint64 total() const   { return m_head; }
+    quint64 dropped() const { const quint64 n = total(); return n > m_ring.size() ? n - m_ring.size() : 0; }
+
+    // Ostatnie zdarzenia w kolejności czasu (kopia; wątek rejestratora)
+    QVector<Event> snapshot() const;
+
+    // VCD (IEEE 1364) dla przeglądarek przebiegów; zmienne tylko dla sygnałów, które wystąpiły.
+    // truncated = początek nagrania nadpisany: stan początkowy w chwili pierwszego zdarzenia,
+    // odtworzony z niego (zdarzenie to zmiana, więc wcześniej sygnał miał wartość przeciwną)
+    static bool writeVcd(const QString& path, const QVector<Event>& events, const QStringList& names,
+                         bool truncated, QString* error = nullptr);
+
+private:
+    std::vector<Event>    m_ring;           // alokowany przy pierwszym start()
+    quint64               m_capacity = 0;
+    quint64               m_mask = 0;
+    quint64               m_head = 0;
+    bool                  m_on = false;
+    QElapsedTimer         m_clock;
+
+    QHash<QString, quint32> m_ids;
+    QStringList             m_names;
+};
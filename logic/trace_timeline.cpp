@@ -0,0 +1,52 @@
+#include "trace_timeline.h"
+
+#include <algorithm>
+#include <utility>
+
+TraceTimeline::TraceTimeline(QVector<TraceRecorder::Event> events, QStringList names, int keyframeEvents)
+    : m_events(std::move(events))
+    , m_names(std::move(names))
+{
+    // Odstęp klatek: nie mniejszy niż zadany, a klatki razem w budżecie pamięci
+    const qint64 ids = qMax(1, m_names.size());
+    const qint64 budgetFrames = qMax<qint64>(1, MAX_KEYFRAME_BYTES / ids);
+    const qint64 minInterval = (m_events.size() + budgetFrames - 1) / budgetFrames;
+    m_interval = int(qMax<qint64>(qMax(1, keyframeEvents), minInterval));
+
+    QVector<quint8> state(m_names.size(), 0);
+    QVector<quint8> seen(m_names.size(), 0);
+    for (const TraceRecorder::Event& e : std::as_const(m_events)) {
+        const int id = int(e.id);
+        if (id >= state.size() || (seen[id] & bit(e.signal))) continue;
+        seen[id] |= bit(e.signal);
+        if (!e.value) state[id] |= bit(e.signal);
+    }
+    m_keyframes.reserve(m_events.size() / m_interval + 1);
+    for (int i = 0; i < m_events.size(); ++i) {
+        if (i % m_interval == 0) m_keyframes.push_back(state);
+        const TraceRecorder::Event& e = m_events[i];
+        if (int(e.id) >= state.size()) continue;
+        if (e.value) state[int(e.id)] |= bit(e.signal);
+        else         state[int(e.id)] &= quint8(~bit(e.signal));
+    }
+}
+
+int TraceTimeline::eventsUpTo(quint64 t) const {
+    const auto it = std::upper_bound(m_events.cbegin(), m_events.cend(), t,
+                                     [](quint64 v, const TraceRecorder::Event& e) { return v < e.t; });
+    return int(it - m_events.cbegin());
+}
+
+void TraceTimeline::stateAt(quint64 t, QVector<quint8>& out) const {
+    const int n = eventsUpTo(t);
+    if (m_keyframes.isEmpty()) { out.fill(0, m_names.size()); return; }
+
+    const int k = qMin(n / m_interval, m_keyframes.size() - 1);
+    out = m_keyframes[k];
+    for (int i = k * m_interval; i < n; ++i) {
+        const TraceRecorder::Event& e = m_events[i];
+        if (int(e.id) >= out.size()) continue;
+        if (e.value) out[int(e.id)] |= bit(e.signal);
+        else         out[int(e.id)] &= quint8(~bit(e.signal));
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <QStringList>
+#include <QVector>
+
+#include "trace_recorder.h"
+
+// Oś czasu nagranego przebiegu: stan wszystkich sygnałów w dowolnej chwili.
+//
+// Stan = bajt na pin (bity: FAZA, ZERO, zwarcie, cewka — w kolejności
+// TraceRecorder::Signal). Co `keyframeEvents` zdarzeń zapamiętywany jest pełny
+// stan (klatka kluczowa); stateAt(t) bierze najbliższą wcześniejszą klatkę
+// i dokłada co najwyżej keyframeEvents zdarzeń — koszt nie zależy od długości
+// nagrania. Odstęp klatek rośnie, gdy klatki przekroczyłyby MAX_KEYFRAME_BYTES.
+// Stan sprzed pierwszego zachowanego zdarzenia sygnału to wartość przeciwna do
+// niego (zdarzenie to zmiana) — poprawny także wtedy, gdy początek nagrania nadpisano.
+class TraceTimeline {
+public:
+    static constexpr int    KEYFRAME_EVENTS = 4096;
+    static constexpr qint64 MAX_KEYFRAME_BYTES = qint64(64) << 20;
+
+    TraceTimeline(QVector<TraceRecorder::Event> events, QStringList names,
+                  int keyframeEvents = KEYFRAME_EVENTS);
+
+    static quint8 bit(TraceRecorder::Signal s) { return quint8(1u << int(s)); }
+
+    bool    isEmpty() const     { return m_events.isEmpty(); }
+    quint64 startTime() const   { return m_events.isEmpty() ? 0 : m_events.first().t; }
+    quint64 endTime() const     { return m_events.isEmpty() ? 0 : m_events.last().t; }
+    int     eventCount() const  { return m_events.size(); }
+    int     idCount() const     { return m_names.size(); }
+    const QString& name(int id) const { return m_names[id]; }
+
+    int  eventsUpTo(quint64 t) const;                  // liczba zdarzeń z czasem <= t
+    void stateAt(quint64 t, QVector<quint8>& out) const;
+
+private:
+    QVector<TraceRecorder::Event> m_events;
+    QStringList                   m_names;
+    int                           m_interval = KEYFRAME_EVENTS;
+    QVector<QVector<quint8>>      m_keyframes;        // [k] = stan przed zdarzeniem k*m_interval
+};
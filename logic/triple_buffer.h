@@ -0,0 +1,36 @@
+#pragma once
+#include <atomic>
+
+// Potrójny bufor bez blokad: jeden pisarz, jeden czytelnik.
+// Pisarz wypełnia swój slot (back) i wymienia go atomowo ze slotem środkowym;
+// czytelnik, jeśli środkowy jest świeży, wymienia go ze swoim (front).
+// Żadna strona nie czeka na drugą, czytelnik zawsze dostaje ostatni pełny
+// wynik, a wyniki pośrednie, których nie zdążył odebrać, przepadają.
+template <typename T>
+class TripleBuffer {
+public:
+    // ---- pisarz; publish() zwraca true, gdy poprzedni wynik przepadł (czytelnik go nie odebrał)
+    T&   back() { return m_slots[m_back]; }
+    bool publish() {
+        const unsigned prev = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+        m_back = prev & INDEX;
+        return prev & FRESH;
+    }
+
+    // ---- czytelnik: true, jeśli front() zawiera nowy wynik
+    bool fetch() {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        const unsigned prev = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = prev & INDEX;
+        return true;
+    }
+    T& front() { return m_slots[m_front]; }
+
+private:
+    static constexpr unsigned INDEX = 0x3, FRESH = 0x4;
+
+    T                     m_slots[3];
+    alignas(64) std::atomic<unsigned> m_middle{1};
+    alignas(64) unsigned  m_back = 0;       // pisarz
+    alignas(64) unsigned  m_front = 2;      // czytelnik
+};
@@ -0,0 +1,76 @@
+#include "undo_journal.h"
+
+#include <utility>
+
+void UndoJournal::begin(const QString& label) {
+    if (m_suspend > 0) return;
+    if (m_openDepth++ == 0) m_open = Entry{ label, {} };
+}
+
+void UndoJournal::record(Delta d, const QString& label) {
+    if (m_suspend > 0) return;
+    if (m_openDepth > 0) { m_open.deltas.push_back(std::move(d)); return; }
+    Entry e;
+    e.label = label;
+    e.deltas.push_back(std::move(d));
+    push(std::move(e));
+}
+
+void UndoJournal::commit() {
+    if (m_suspend > 0 || m_openDepth == 0 || --m_openDepth > 0) return;
+    Entry e = std::exchange(m_open, Entry{});
+    if (!e.deltas.isEmpty()) push(std::move(e));
+}
+
+// Nowa operacja unieważnia gałąź „ponów”
+void UndoJournal::push(Entry e) {
+    if (m_listener) m_listener(e);
+    m_redo.clear();
+    m_undo.push_back(std::move(e));
+    if (m_undo.size() > m_depth) m_undo.remove(0, m_undo.size() - m_depth);
+}
+
+UndoJournal::Entry UndoJournal::takeUndo() {
+    if (m_undo.isEmpty()) return {};
+    Entry e = m_undo.takeLast();
+    m_redo.push_back(e);
+    return e;
+}
+
+UndoJournal::Entry UndoJournal::takeRedo() {
+    if (m_redo.isEmpty()) return {};
+    Entry e = m_redo.takeLast();
+    m_undo.push_back(e);
+    return e;
+}
+
+UndoJournal::Entry UndoJournal::inverted(const Entry& e) {
+    Entry out;
+    out.label = e.label;
+    out.deltas.reserve(e.deltas.size());
+    for (int i = e.deltas.size() - 1; i >= 0; --i) {
+        Delta d = e.deltas[i];
+        switch (d.op) {
+        case Op::PlaceDevice:  d.op = Op::RemoveDevice; break;
+        case Op::RemoveDevice: d.op = Op::PlaceDevice;  break;
+        case Op::AddWire:      d.op = Op::RemoveWire;   break;
+        case Op::RemoveWire:   d.op = Op::AddWire;      break;
+        case Op::SetSource:    d.on = !d.on;            break;
+        }
+        out.deltas.push_back(std::move(d));
+    }
+    return out;
+}
+
+void UndoJournal::clear() {
+    m_undo.clear();
+    m_redo.clear();
+    m_open = Entry{};
+    m_openDepth = 0;
+}
+
+void UndoJournal::setDepth(int depth) {
+    m_depth = qMax(1, depth);
+    if (m_undo.size() > m_depth) m_undo.remove(0, m_undo.size() - m_depth);
+    if (m_redo.size() > m_depth) m_redo.remove(0, m_redo.size() - m_depth);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <QPointF>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+#include "project_file.h"
+
+// Historia cofnij/ponów jako dziennik zmian (delt), a nie migawek sceny.
+// Wpis = jedna operacja użytkownika (wstawienie tablicy, usunięcie stycznika
+// razem z jego mostkami i źródłami…) zapisana jako ciąg delt. Cofnięcie
+// stosuje delty odwrotnie od końca, ponowienie — w przód, w kolejności.
+// Dziennik tylko przechowuje dane; stosowanie delt należy do MainWindow.
+// Pamięć ograniczona liczbą wpisów (depth) — najstarsze wypadają pierwsze.
+class UndoJournal {
+public:
+    static constexpr int DEFAULT_DEPTH = 200;
+
+    enum class Op : quint8 {
+        PlaceDevice,    // device
+        RemoveDevice,   // device
+        AddWire,        // a, b, points
+        RemoveWire,     // a, b, points
+        SetSource,      // a = pin, neutral, on = stan PO operacji
+    };
+
+    struct Delta {
+        Op                  op = Op::PlaceDevice;
+        bool                neutral = false;
+        bool                on = false;
+        ProjectFile::Device device;
+        QString             a, b;
+        QVector<QPointF>    points;
+    };
+
+    struct Entry {
+        QString        label;       // do menu „Cofnij: …”
+        QVector<Delta> deltas;
+    };
+
+    // ---- nagrywanie: begin/commit mogą się zagnieżdżać (wpis zamyka zewnętrzny commit)
+    void begin(const QString& label);
+    void record(Delta d, const QString& label = QString());  // poza begin/commit — wpis z jedną deltą
+    void commit();
+    bool isRecording() const { return m_suspend == 0; }
+
+    // Na czas stosowania delt (cofnij/ponów, wczytywanie) — nic nie jest nagrywane
+    void suspend() { ++m_suspend; }
+    void resume()  { if (m_suspend > 0) --m_suspend; }
+
+    // ---- cofnij/ponów: zwracany wpis przechodzi na drugi stos
+    bool  canUndo() const { return !m_undo.isEmpty(); }
+    bool  canRedo() const { return !m_redo.isEmpty(); }
+    QString undoLabel() const { return m_undo.isEmpty() ? QString() : m_undo.last().label; }
+    QString redoLabel() const { return m_redo.isEmpty() ? QString() : m_redo.last().label; }
+    Entry takeUndo();
+    Entry takeRedo();
+
+    // Odwrotność wpisu (delty odwrócone, od końca) — cofnięcie zapisane jako zwykła operacja
+    static Entry inverted(const Entry& e);
+
+    // Powiadamiany o każdym nowym wpisie (np. autozapis); cofnij/ponów go nie wołają
+    void setListener(std::function<void(const Entry&)> listener) { m_listener = std::move(listener); }
+
+    void clear();
+    void setDepth(int depth);
+    int  depth() const { return m_depth; }
+
+private:
+    void push(Entry e);
+
+    QVector<Entry> m_undo;
+    QVector<Entry> m_redo;
+    Entry          m_open;          // wpis w trakcie begin/commit
+    int            m_openDepth = 0;
+    int            m_suspend = 0;
+    int            m_depth = DEFAULT_DEPTH;
+    std::function<void(const Entry&)> m_listener;
+};
@@ -0,0 +1,302 @@
+#include "wire_router.h"
+
+#include <QMetaObject>
+#include <QThread>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <vector>
+#include <utility>
+
+namespace {
+
+// Flagi komórek obszaru przeszukiwania
+enum : quint8 {
+    CELL_BLOCK  = 0x1,   // korpus lub obcy zacisk
+    CELL_WIRE_H = 0x2,   // biegnie tędy mostek poziomy
+    CELL_WIRE_V = 0x4,   // biegnie tędy mostek pionowy
+};
+
+// Przeszkody są „miękkie”: droga przez nie istnieje zawsze (np. wyjście zacisku
+// schowanego w obrysie), ale jest tak droga, że router jej unika
+constexpr int BLOCK_COST   = 400;
+constexpr int OVERLAP_COST = 200;   // bieg wzdłuż cudzego mostka
+
+// Kierunki: 0 = +x, 1 = -x, 2 = +y, 3 = -y (d ^ 1 = kierunek przeciwny)
+constexpr int DX[4] = { 1, -1, 0,  0 };
+constexpr int DY[4] = { 0,  0, 1, -1 };
+
+inline int cellOf(qreal v) { return int(std::lround(v / WireRouter::GRID)); }
+
+// Usuwa powtórzone i współliniowe punkty łamanej
+QVector<QPointF> simplify(const QVector<QPointF>& in) {
+    QVector<QPointF> out;
+    out.reserve(in.size());
+    for (const QPointF& p : in) {
+        if (!out.isEmpty() && out.back() == p) continue;
+        if (out.size() >= 2) {
+            const QPointF& a = out[out.size() - 2];
+            const QPointF& b = out.back();
+            const bool sameX = qFuzzyCompare(a.x(), b.x()) && qFuzzyCompare(b.x(), p.x());
+            const bool sameY = qFuzzyCompare(a.y(), b.y()) && qFuzzyCompare(b.y(), p.y());
+            if (sameX || sameY) { out.back() = p; continue; }
+        }
+        out.push_back(p);
+    }
+    return out;
+}
+
+RouteResult fallbackL(const RouteRequest& req) {
+    RouteResult r;
+    r.id = req.id;
+    r.points = simplify({ req.a, QPointF(req.b.x(), req.a.y()), req.b });
+    r.ok = false;
+    return r;
+}
+
+} // namespace
+
+// ===================== Przeszkody =====================
+void RouteObstacles::addBody(const QRectF& r) {
+    const qreal m = WireRouter::GRID / 2.0;
+    m_bodies.insert(r.normalized().adjusted(-m, -m, m, m));
+}
+
+void RouteObstacles::addPin(const QPointF& c, qreal radius) {
+    m_pins.insert(QRectF(c.x() - radius, c.y() - radius, 2 * radius, 2 * radius));
+}
+
+void RouteObstacles::addPolyline(const QVector<QPointF>& pts) {
+    for (int i = 1; i < pts.size(); ++i)
+        m_wires.insert(QRectF(pts[i - 1], pts[i]).normalized());
+}
+
+// ===================== Obszar przeszukiwania =====================
+QRect WireRouter::gridRegion(const RouteRequest& req) {
+    const int ax = cellOf(req.a.x()), ay = cellOf(req.a.y());
+    const int bx = cellOf(req.b.x()), by = cellOf(req.b.y());
+    const int x0 = qMin(ax, bx), x1 = qMax(ax, bx);
+    const int y0 = qMin(ay, by), y1 = qMax(ay, by);
+
+    // zapas maleje, gdy obszar robi się za duży (dalekie połączenia)
+    int m = MARGIN_CELLS;
+    while (m > 0 && qint64(x1 - x0 + 1 + 2 * m) * (y1 - y0 + 1 + 2 * m) > MAX_REGION_CELLS)
+        m /= 2;
+    return QRect(QPoint(x0 - m, y0 - m), QPoint(x1 + m, y1 + m));
+}
+
+QRectF WireRouter::sceneRegion(const RouteRequest& req) {
+    const QRect g = gridRegion(req);
+    return QRectF(QPointF(g.left() * GRID, g.top() * GRID),
+                  QPointF(g.right() * GRID, g.bottom() * GRID));
+}
+
+// ===================== A* =====================
+RouteResult WireRouter::route(const RouteObstacles& obstacles, const RouteRequest& req) {
+    const QRect g = gridRegion(req);
+    const int W = g.width(), H = g.height();
+    if (qint64(W) * H > MAX_REGION_CELLS)
+        return fallbackL(req);
+
+    // --- raster przeszkód w obszarze (tylko to, co zwróci indeks)
+    QVector<quint8> flags(W * H, 0);
+    auto markCells = [&](int cx0, int cx1, int cy0, int cy1, quint8 f){
+        cx0 = qMax(cx0, g.left()); cx1 = qMin(cx1, g.right());
+        cy0 = qMax(cy0, g.top());  cy1 = qMin(cy1, g.bottom());
+        for (int y = cy0; y <= cy1; ++y)
+            for (int x = cx0; x <= cx1; ++x)
+                flags[(y - g.top()) * W + (x - g.left())] |= f;
+    };
+    auto markInside = [&](const QRectF& r, quint8 f){
+        markCells(int(std::ceil(r.left() / GRID)),  int(std::floor(r.right()  / GRID)),
+                  int(std::ceil(r.top()  / GRID)),  int(std::floor(r.bottom() / GRID)), f);
+    };
+
+    const QRectF area = sceneRegion(req);
+    for (int id : obstacles.bodies().query(area)) markInside(obstacles.bodies().rect(id), CELL_BLOCK);
+    for (int id : obstacles.pins().query(area))   markInside(obstacles.pins().rect(id),   CELL_BLOCK);
+    for (int id : obstacles.wires().query(area)) {
+        const QRectF& r = obstacles.wires().rect(id);
+        const bool horiz = qFuzzyIsNull(r.height());
+        const bool vert  = qFuzzyIsNull(r.width());
+        const quint8 f = horiz ? CELL_WIRE_H : vert ? CELL_WIRE_V : quint8(CELL_WIRE_H | CELL_WIRE_V);
+        markCells(cellOf(r.left()), cellOf(r.right()), cellOf(r.top()), cellOf(r.bottom()), f);
+    }
+
+    // Własne zaciski: ich otoczenie jest wolne (wyjście z zacisku, inne mostki tej samej sieci)
+    const int sx = cellOf(req.a.x()) - g.left(), sy = cellOf(req.a.y()) - g.top();
+    const int tx = cellOf(req.b.x()) - g.left(), ty = cellOf(req.b.y()) - g.top();
+    for (const QPoint c : { QPoint(sx, sy), QPoint(tx, ty) }) {
+        for (int y = qMax(0, c.y() - PIN_CLEAR_CELLS); y <= qMin(H - 1, c.y() + PIN_CLEAR_CELLS); ++y)
+            for (int x = qMax(0, c.x() - PIN_CLEAR_CELLS); x <= qMin(W - 1, c.x() + PIN_CLEAR_CELLS); ++x)
+                flags[y * W + x] = 0;
+    }
+
+    // --- przeszukiwanie: stan = komórka * 4 + kierunek wejścia
+    const int start = sy * W + sx;
+    const int goal  = ty * W + tx;
+    auto h = [&](int c){ return (qAbs(c % W - tx) + qAbs(c / W - ty)) * STEP_COST; };
+
+    QVector<int> gCost(W * H * 4, INT_MAX);
+    QVector<int> parent(W * H * 4, -1);
+    using Item = std::pair<int, int>;   // (f, stan)
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+
+    for (int d = 0; d < 4; ++d) {
+        gCost[start * 4 + d] = 0;
+        open.push({ h(start), start * 4 + d });
+    }
+
+    int reached = -1;
+    while (!open.empty()) {
+        const auto [f, st] = open.top();
+        open.pop();
+        const int c = st >> 2, d = st & 3;
+        if (f - h(c) > gCost[st]) continue;   // nieaktualny wpis
+        if (c == goal) { reached = st; break; }
+
+        const int x = c % W, y = c / W;
+        for (int nd = 0; nd < 4; ++nd) {
+            if (nd == (d ^ 1)) continue;
+            const int nx = x + DX[nd], ny = y + DY[nd];
+            if (nx < 0 || ny < 0 || nx >= W || ny >= H) continue;
+            const int nc = ny * W + nx;
+            const quint8 fl = flags[nc];
+            const bool horiz = nd < 2;
+
+            int cost = STEP_COST;
+            if (nd != d)                                    cost += BEND_COST;
+            if (fl & CELL_BLOCK)                            cost += BLOCK_COST;
+            if (fl & (horiz ? CELL_WIRE_H : CELL_WIRE_V))   cost += OVERLAP_COST;
+            else if (fl & (horiz ? CELL_WIRE_V : CELL_WIRE_H)) cost += CROSS_COST;
+
+            const int ns = nc * 4 + nd;
+            const int ng = gCost[st] + cost;
+            if (ng < gCost[ns]) {
+                gCost[ns]  = ng;
+                parent[ns] = st;
+                open.push({ ng + h(nc), ns });
+            }
+        }
+    }
+    if (reached < 0)
+        return fallbackL(req);
+
+    // --- odtworzenie drogi
+    QVector<int> cells;
+    bool clean = true;
+    for (int st = reached; st >= 0; st = parent[st]) {
+        const int c = st >> 2;
+        if (cells.isEmpty() || cells.back() != c) cells.push_back(c);
+        if (flags[c] & CELL_BLOCK) clean = false;
+    }
+    std::reverse(cells.begin(), cells.end());
+
+    auto ptOf = [&](int c){ return QPointF((g.left() + c % W) * GRID, (g.top() + c / W) * GRID); };
+    const QPointF first = ptOf(cells.front());
+    const QPointF last  = ptOf(cells.back());
+
+    // Zaciski nie muszą leżeć na siatce — krótkie dojścia H/V (chowają się w kółku zacisku)
+    QVector<QPointF> pts;
+    pts.reserve(cells.size() + 4);
+    pts.push_back(req.a);
+    pts.push_back(QPointF(first.x(), req.a.y()));
+    for (int c : std::as_const(cells)) pts.push_back(ptOf(c));
+    pts.push_back(QPointF(last.x(), req.b.y()));
+    pts.push_back(req.b);
+
+    RouteResult r;
+    r.id = req.id;
+    r.points = simplify(pts);
+    r.ok = clean;
+    return r;
+}
+
+// ===================== Paczki w puli wątków =====================
+WireRouter::WireRouter(QObject* parent)
+    : QObject(parent) {
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+WireRouter::~WireRouter() {
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void WireRouter::routeBatch(const RouteObstacles& obstacles, const QVector<RouteRequest>& requests) {
+    cancel();
+    m_obstacles = obstacles;
+
+    // Fala zlecenia = 1 + najpóźniejsza fala wcześniejszego zlecenia o wspólnym obszarze
+    SpatialIndex regions(GRID * 64);
+    QVector<int> waveOf(requests.size(), 0);
+    for (int i = 0; i < requests.size(); ++i) {
+        const QRectF r = sceneRegion(requests[i]);
+        int w = 0;
+        for (int id : regions.query(r)) w = qMax(w, waveOf[id] + 1);
+        waveOf[i] = w;
+        regions.insert(r);   // id == i
+        if (m_waves.size() <= w) m_waves.resize(w + 1);
+        m_waves[w].push_back(requests[i]);
+    }
+
+    startWave();
+}
+
+void WireRouter::cancel() {
+    ++m_generation;   // wyniki zadań w locie zostaną zignorowane
+    m_pool.clear();
+    m_waves.clear();
+    m_wave = 0;
+    m_outstanding = 0;
+    m_waveResults.clear();
+}
+
+void WireRouter::startWave() {
+    while (m_wave < m_waves.size() && m_waves[m_wave].isEmpty()) ++m_wave;
+    if (m_wave >= m_waves.size()) {
+        m_waves.clear();
+        m_wave = 0;
+        emit finished();
+        return;
+    }
+
+    // Zadania dostają kopię przeszkód (współdzieloną) — GUI dopisuje trasy dopiero po fali
+    const QVector<RouteRequest>& wave = m_waves[m_wave];
+    const RouteObstacles obstacles = m_obstacles;
+    const quint64 generation = m_generation;
+    m_waveResults.reserve(wave.size());
+
+    for (int i = 0; i < wave.size(); i += JOB_SIZE) {
+        const QVector<RouteRequest> job = wave.mid(i, JOB_SIZE);
+        ++m_outstanding;
+        m_pool.start([this, generation, obstacles, job] {
+            QVector<RouteResult> out;
+            out.reserve(job.size());
+            for (const RouteRequest& req : job) out.push_back(route(obstacles, req));
+            QMetaObject::invokeMethod(this, [this, generation, out] {
+                onJobDone(generation, out);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void WireRouter::onJobDone(quint64 generation, const QVector<RouteResult>& results) {
+    if (generation != m_generation)
+        return; // paczka anulowana w międzyczasie
+    m_waveResults += results;
+    if (--m_outstanding > 0)
+        return;
+
+    for (const RouteResult& r : std::as_const(m_waveResults))
+        m_obstacles.addPolyline(r.points);
+    const QVector<RouteResult> done = std::exchange(m_waveResults, {});
+    ++m_wave;
+
+    emit routed(done);
+    if (generation == m_generation)   // odbiorca mógł anulować paczkę
+        startWave();
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <QObject>
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+#include <QThreadPool>
+#include <QVector>
+
+#include "spatial_index.h"
+
+// Zlecenie trasy między dwoma punktami sceny (środki zacisków)
+struct RouteRequest {
+    int     id = -1;
+    QPointF a;
+    QPointF b;
+};
+
+struct RouteResult {
+    int              id = -1;
+    QVector<QPointF> points;     // łamana H/V od a do b
+    bool             ok = false; // false = trasa awaryjna „L” (brak drogi w obszarze)
+};
+
+// Migawka przeszkód dla routera. Czytana równolegle przez wątki robocze —
+// po przekazaniu do zadań modyfikuje ją tylko wątek GUI na własnej kopii.
+class RouteObstacles {
+public:
+    void addBody(const QRectF& r);                    // korpus: zakaz wejścia
+    void addPin(const QPointF& c, qreal radius);      // obcy zacisk: zakaz wejścia
+    void addPolyline(const QVector<QPointF>& pts);    // mostek: zakaz biegu wzdłuż, przecięcie kosztuje
+
+    const SpatialIndex& bodies() const { return m_bodies; }
+    const SpatialIndex& pins()   const { return m_pins; }
+    const SpatialIndex& wires()  const { return m_wires; }
+
+private:
+    SpatialIndex m_bodies;
+    SpatialIndex m_pins;
+    SpatialIndex m_wires;        // pojedyncze odcinki (prostokąty zdegenerowane)
+};
+
+// Router ortogonalny: A* na siatce GRID z karą za załamania i przecięcia.
+// Paczka zleceń jest dzielona na fale: zlecenia z rozłącznymi obszarami
+// przeszukiwania nie mogą na siebie wpłynąć, więc fala idzie równolegle
+// w puli wątków, a jej trasy stają się przeszkodami dla następnych fal.
+// Wynik jest więc taki sam, jak przy trasowaniu po kolei.
+class WireRouter : public QObject {
+    Q_OBJECT
+public:
+    static constexpr qreal GRID             = 10.0;
+    static constexpr int   MARGIN_CELLS     = 30;         // zapas obszaru wokół końców
+    static constexpr int   MAX_REGION_CELLS = 1 << 18;   // ~8 MB stanu A* na zadanie
+    static constexpr int   STEP_COST        = 1;
+    static constexpr int   BEND_COST        = 6;
+    static constexpr int   CROSS_COST       = 15;
+    static constexpr int   PIN_CLEAR_CELLS  = 2;          // wokół własnych zacisków przeszkody nie obowiązują
+    static constexpr int   JOB_SIZE         = 16;         // zleceń na jedno zadanie w puli
+
+    explicit WireRouter(QObject* parent = nullptr);
+    ~WireRouter() override;
+
+    // Asynchronicznie: wyniki przychodzą falami przez routed(), na końcu finished()
+    void routeBatch(const RouteObstacles& obstacles, const QVector<RouteRequest>& requests);
+    void cancel();
+    bool isBusy() const { return m_outstanding > 0 || m_wave < m_waves.size(); }
+
+    // Synchronicznie, dowolny wątek
+    static RouteResult route(const RouteObstacles& obstacles, const RouteRequest& req);
+    static QRect       gridRegion(const RouteRequest& req);   // komórki obszaru przeszukiwania
+    static QRectF      sceneRegion(const RouteRequest& req);
+
+signals:
+    void routed(const QVector<RouteResult>& wave);
+    void finished();
+
+private:
+    void startWave();
+    void onJobDone(quint64 generation, const QVector<RouteResult>& results);
+
+    RouteObstacles                 m_obstacles;
+    QVector<QVector<RouteRequest>> m_waves;
+    int                            m_wave = 0;
+    int                            m_outstanding = 0;   // zadania bieżącej fali w locie
+    QVector<RouteResult>           m_waveResults;
+    quint64                        m_generation = 0;
+    QThreadPool                    m_pool;              // ostatni — niszczony pierwszy (czeka na zadania)
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <QSemaphore>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include "spsc_queue.h"
+#include "triple_buffer.h"
+
+// Wspólny szkielet wątków roboczych (SimWorker, DrcWorker).
+//
+// GUI wysyła operacje (dane, bez domknięć) przez SpscQueue i budzi wątek
+// semaforem; wątek po przebudzeniu woła batch(), które zdejmuje zaległe
+// operacje (pop) i ewentualnie publikuje wynik. Wynik idzie przez
+// TripleBuffer, a notify() jest wołane najwyżej raz, dopóki GUI go nie odbierze.
+// GUI nigdy nie czeka: post() to dopięcie węzła listy, fetch() to jedna wymiana.
+//
+// Wątek startuje w konstruktorze — pętla ma być ostatnim polem właściciela,
+// żeby batch() widziało resztę pól już zbudowaną.
+template <typename Op, typename Result>
+class WorkerLoop {
+public:
+    // notify() i batch() są wołane z wątku roboczego; notify() ma tylko zlecić odbiór
+    WorkerLoop(std::function<void()> notify, std::function<void()> batch)
+        : m_notify(std::move(notify))
+        , m_batch(std::move(batch))
+        , m_thread([this] { run(); })
+    {
+    }
+    ~WorkerLoop() { stop(); }
+    WorkerLoop(const WorkerLoop&) = delete;
+    WorkerLoop& operator=(const WorkerLoop&) = delete;
+
+    // ---- wątek GUI (jedyny producent i jedyny czytelnik)
+    void post(Op op) {
+        m_queue.push(std::move(op));
+        m_wake.release();
+    }
+    // Flaga przed wymianą: wynik opublikowany w trakcie odbioru wywoła notify() ponownie
+    bool fetch() {
+        m_notified.store(false, std::memory_order_release);
+        return m_results.fetch();
+    }
+    Result& result() { return m_results.front(); }
+    void stop() {                                   // zatrzymanie i dołączenie wątku
+        if (!m_thread.joinable()) return;
+        m_stop.store(true, std::memory_order_release);
+        m_wake.release();
+        m_thread.join();
+    }
+
+    // ---- wątek roboczy (w batch())
+    bool    pop(Op& op) { return m_queue.pop(op); }
+    Result& back() { return m_results.back(); }
+    // true = poprzedni wynik przepadł (GUI go nie odebrało)
+    bool publish() {
+        const bool dropped = m_results.publish();
+        if (!m_notified.exchange(true, std::memory_order_acq_rel)) m_notify();
+        return dropped;
+    }
+
+private:
+    void run() {
+        for (;;) {
+            m_wake.acquire();
+            m_wake.tryAcquire(m_wake.available());     // kolejka i tak jest zdejmowana w całości
+            if (m_stop.load(std::memory_order_acquire)) return;
+            m_batch();
+        }
+    }
+
+    SpscQueue<Op>         m_queue;
+    TripleBuffer<Result>  m_results;
+    QSemaphore            m_wake;
+    std::atomic<bool>     m_stop{false};
+    std::atomic<bool>     m_notified{false};    // wynik czeka na odbiór
+    std::function<void()> m_notify;
+    std::function<void()> m_batch;
+    std::thread           m_thread;             // ostatni — startuje po reszcie pól
+};
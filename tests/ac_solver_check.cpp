@@ -0,0 +1,139 @@
+// Kontrola AcSolver na obwodach o znanym rozwiązaniu:
+//  1) jedna cewka między źródłem FAZA a ZERO — prąd z prawa Ohma,
+//  2) drabinka cewek ze stykami na szczeblach — porównanie z pełną eliminacją
+//     Gaussa na tej samej macierzy, dla kilku stanów styków na jednej
+//     faktoryzacji symbolicznej (ponowne użycie wzorca L).
+// Łapie regresje porządku minimalnego stopnia, drzewa eliminacji i L·D·Lᵀ.
+#include "ac_solver.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using Complex = AcSolver::Complex;
+
+int g_failures = 0;
+
+void expectNear(const char* what, double got, double want, double relTol) {
+    const double err = std::abs(got - want) / std::max(1e-12, std::abs(want));
+    if (err <= relTol) return;
+    std::printf("FAIL %s: %.9g, oczekiwane %.9g (błąd względny %.3g)\n", what, got, want, err);
+    ++g_failures;
+}
+
+// Pełna eliminacja Gaussa z wyborem elementu głównego — wzorzec niezależny od AcSolver
+std::vector<Complex> denseSolve(std::vector<std::vector<Complex>> a, std::vector<Complex> b) {
+    const int n = int(b.size());
+    for (int k = 0; k < n; ++k) {
+        int pivot = k;
+        for (int i = k + 1; i < n; ++i)
+            if (std::abs(a[i][k]) > std::abs(a[pivot][k])) pivot = i;
+        std::swap(a[k], a[pivot]);
+        std::swap(b[k], b[pivot]);
+        for (int i = k + 1; i < n; ++i) {
+            const Complex f = a[i][k] / a[k][k];
+            if (f == Complex(0.0)) continue;
+            for (int j = k; j < n; ++j) a[i][j] -= f * a[k][j];
+            b[i] -= f * b[k];
+        }
+    }
+    std::vector<Complex> x(n);
+    for (int i = n - 1; i >= 0; --i) {
+        Complex s = b[i];
+        for (int j = i + 1; j < n; ++j) s -= a[i][j] * x[j];
+        x[i] = s / a[i][i];
+    }
+    return x;
+}
+
+// 1) E / (2·Zs + Zc): upływ G_MIN zmienia wynik o ~1e-5 względnie
+void singleCoil() {
+    AcSolver s;
+    const QSet<QString> nodes{ QStringLiteral("P"), QStringLiteral("N") };
+    s.setTopology({}, nodes, { { QStringLiteral("K1_"), QStringLiteral("P"), QStringLiteral("N") } }, {});
+    if (!s.solve({ QStringLiteral("P") }, { QStringLiteral("N") })) { ++g_failures; return; }
+
+    const Complex zs(AcSolver::SOURCE_R, AcSolver::SOURCE_X);
+    const Complex zc(AcSolver::COIL_R, AcSolver::COIL_X);
+    const Complex i = AcSolver::PHASE_VOLTAGE / (2.0 * zs + zc);
+    expectNear("cewka: napięcie", s.result().coils.value(0).value, std::abs(i * zc), 1e-4);
+    expectNear("cewka: prąd źródła", s.result().sources.value(0).value, std::abs(i), 1e-4);
+}
+
+// 2) Drabinka: R0 (FAZA) –Zc– R1 –Zc– … –Zc– Rn; szczebel k: Rk –Zc– Sk –styk– G (ZERO).
+//    Mostek W–R3 sprawdza scalanie pinów w jeden węzeł.
+void ladder() {
+    const int n = 24;
+    auto r = [](int k) { return QStringLiteral("R%1").arg(k); };
+    auto t = [](int k) { return QStringLiteral("S%1").arg(k); };
+    const QString g = QStringLiteral("G");
+
+    std::vector<char> closed(n + 1, 0);
+    QVector<Edge> edges;
+    QVector<AcSolver::Coil> coils;
+    QSet<QString> nodes{ g, QStringLiteral("W") };
+    for (int k = 0; k <= n; ++k) {
+        nodes << r(k) << t(k);
+        if (k < n) coils.push_back({ QStringLiteral("KR%1_").arg(k), r(k), r(k + 1) });
+        coils.push_back({ QStringLiteral("KS%1_").arg(k), r(k), t(k) });
+        const auto cond = [&closed, k] { return closed[k] != 0; };
+        edges.push_back({ t(k), g, cond, QStringLiteral("K%1_").arg(k) });
+        edges.push_back({ g, t(k), cond, QStringLiteral("K%1_").arg(k) });
+    }
+    edges.push_back({ QStringLiteral("W"), r(3), {}, {} });
+    edges.push_back({ r(3), QStringLiteral("W"), {}, {} });
+
+    AcSolver s;
+    s.setTopology(edges, nodes, coils, {});
+
+    // Numery węzłów wzorca: R0..Rn, S0..Sn, G (W = R3)
+    auto idxR = [](int k) { return k; };
+    auto idxS = [n](int k) { return n + 1 + k; };
+    const int idxG = 2 * (n + 1);
+    const int size = idxG + 1;
+
+    const Complex yc = 1.0 / Complex(AcSolver::COIL_R, AcSolver::COIL_X);
+    const Complex ys = 1.0 / Complex(AcSolver::SOURCE_R, AcSolver::SOURCE_X);
+    const Complex yk = 1.0 / AcSolver::CONTACT_R;
+
+    // Kilka stanów styków na jednej faktoryzacji symbolicznej
+    const std::vector<std::vector<int>> states = { { 0, 7, 23 }, { 2, 3, 4, 5, 24 }, {}, { 0, 7, 23 } };
+    for (const std::vector<int>& on : states) {
+        std::fill(closed.begin(), closed.end(), 0);
+        for (int k : on) closed[k] = 1;
+
+        std::vector<std::vector<Complex>> a(size, std::vector<Complex>(size, 0.0));
+        std::vector<Complex> b(size, 0.0);
+        auto branch = [&](int i, int j, Complex y) {
+            a[i][i] += y; a[j][j] += y; a[i][j] -= y; a[j][i] -= y;
+        };
+        for (int i = 0; i < size; ++i) a[i][i] += AcSolver::G_MIN;
+        for (int k = 0; k < n; ++k) branch(idxR(k), idxR(k + 1), yc);
+        for (int k = 0; k <= n; ++k) {
+            branch(idxR(k), idxS(k), yc);
+            if (closed[k]) branch(idxS(k), idxG, yk);
+        }
+        a[idxR(0)][idxR(0)] += ys;
+        b[idxR(0)] = AcSolver::PHASE_VOLTAGE * ys;          // R0 bez sufiksu L2/L3 = faza L1
+        a[idxG][idxG] += ys;
+        const std::vector<Complex> v = denseSolve(a, b);
+
+        if (!s.solve({ r(0) }, { g })) { std::printf("FAIL drabinka: solve()\n"); ++g_failures; continue; }
+        for (int k = 0; k <= n; ++k) {
+            expectNear("drabinka: |V(R)|", std::abs(s.voltage(r(k))), std::abs(v[idxR(k)]), 1e-7);
+            expectNear("drabinka: |V(S)|", std::abs(s.voltage(t(k))), std::abs(v[idxS(k)]), 1e-7);
+        }
+        expectNear("drabinka: mostek W = R3", std::abs(s.voltage(QStringLiteral("W"))), std::abs(v[idxR(3)]), 1e-12);
+    }
+}
+
+} // namespace
+
+int main() {
+    singleCoil();
+    ladder();
+    if (g_failures == 0) std::printf("ac_solver_check: OK\n");
+    return g_failures == 0 ? 0 : 1;
+}